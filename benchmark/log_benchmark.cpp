@@ -0,0 +1,494 @@
+/*
+ RGPUtils
+ log_benchmark.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ Measures the throughput and the latency of the log calls: print(),
+ printv() while it's filtered out, error() and errorWithErrno(), from 1 to
+ N producer threads, to the console (redirected to the null device), a
+ logfile and a memory sink, synchronous and asynchronous. The results are
+ written as JSON to compare releases.
+
+ Usage: bench_log [--messages <count>] [--threads <count>]
+                  [--mode sync|async|both] [--output <path>]
+
+ --messages is the number of calls per thread (default 20000), --threads
+ the maximum number of producers (default: the number of cores, at most
+ 8), runs use 1, 2, 4, ... threads up to it. The latency of a call
+ includes reading the clock once (clock_overhead_ns in the results). In
+ asynchronous mode it's the time to queue the record, the throughput
+ includes writing everything (flush()). payload_mb_per_second counts the
+ message text given to the calls, written_mb_per_second the bytes that
+ ended up in the logfiles (file sink only, null otherwise). The results go
+ to bench_log.json by default.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <ctime>
+
+#if defined(__APPLE__) || defined(__unix__)
+#include <unistd.h>
+#include <fcntl.h>
+#elif defined(_WIN32)
+#include <io.h>
+#include <fcntl.h>
+#endif // defined(__APPLE__) || defined(__unix__) // defined(_WIN32)
+
+#include <rgp/Log.h>
+#include <rgp/LogSink.h>
+
+using namespace rgp;
+
+namespace {
+
+    typedef std::chrono::steady_clock Clock;
+
+    const char *kLogfilePath = "bench_log_output.log";
+    const char *kErrorfilePath = "bench_log_error.log";
+
+    // 63 characters + newline
+    const char kMessage[] =
+        "benchmark message with a typical length for a line of a logfile";
+
+    typedef enum : uint8_t {
+        OperationPrint = 0,
+        OperationPrintvFiltered,
+        OperationError,
+        OperationErrorWithErrno
+    } Operation;
+
+    typedef enum : uint8_t {
+        SinkConsole = 0,
+        SinkFile,
+        SinkMemory
+    } Sink;
+
+    const char *kOperationNames[] = { "print", "printv_filtered", "error",
+                                      "error_with_errno" };
+    const char *kSinkNames[] = { "console", "file", "memory" };
+
+    struct Result {
+        Operation operation;
+        Sink sink;
+        bool asynchronous;
+        unsigned int threads;
+        uint64_t messages;
+        double seconds;
+        // bytes in the logfiles (file sink)
+        uint64_t writtenBytes;
+        uint64_t p50;
+        uint64_t p99;
+        uint64_t p999;
+        uint64_t max;
+    };
+
+    // redirects stdout and stderr to the null device while it lives
+    class NullOutput {
+
+    public:
+        NullOutput () {
+            std::cout << std::flush;
+            std::cerr << std::flush;
+            fflush(stdout);
+            fflush(stderr);
+#if defined(__APPLE__) || defined(__unix__)
+            _out = dup(1);
+            _err = dup(2);
+            int null = open("/dev/null", O_WRONLY);
+            dup2(null, 1);
+            dup2(null, 2);
+            close(null);
+#elif defined(_WIN32)
+            _out = _dup(1);
+            _err = _dup(2);
+            int null = _open("NUL", _O_WRONLY);
+            _dup2(null, 1);
+            _dup2(null, 2);
+            _close(null);
+#endif // defined(__APPLE__) || defined(__unix__) // defined(_WIN32)
+        };
+
+        ~NullOutput () {
+            std::cout << std::flush;
+            std::cerr << std::flush;
+            fflush(stdout);
+            fflush(stderr);
+#if defined(__APPLE__) || defined(__unix__)
+            dup2(_out, 1);
+            dup2(_err, 2);
+            close(_out);
+            close(_err);
+#elif defined(_WIN32)
+            _dup2(_out, 1);
+            _dup2(_err, 2);
+            _close(_out);
+            _close(_err);
+#endif // defined(__APPLE__) || defined(__unix__) // defined(_WIN32)
+        };
+
+    private:
+        int _out;
+        int _err;
+    };
+
+    uint64_t nanoseconds (const Clock::duration duration)
+    {
+        return (uint64_t)std::chrono::duration_cast<
+            std::chrono::nanoseconds>(duration).count();
+    }
+
+    // the cost of reading the clock (included in every latency)
+    uint64_t clockOverhead ()
+    {
+        const int count = 100000;
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < count - 1; i++) {
+            Clock::now();
+        }
+        return nanoseconds(Clock::now() - start) / count;
+    }
+
+    void logOnce (Log &log, const Operation operation)
+    {
+        switch (operation) {
+            case OperationPrint: log.print(kMessage); break;
+            case OperationPrintvFiltered: log.printv(kMessage); break;
+            case OperationError: log.error(kMessage); break;
+            case OperationErrorWithErrno: log.errorWithErrno(kMessage, EACCES); break;
+        }
+    }
+
+    // size of a file, 0 if it doesn't exist
+    uint64_t fileSize (const char *path)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        return file.is_open() ? (uint64_t)file.tellg() : 0;
+    }
+
+    // the latency below which a share of the calls stayed (sorted input)
+    uint64_t percentile (const std::vector<uint32_t> &sorted,
+                         const double share)
+    {
+        if (sorted.empty()) {
+            return 0;
+        }
+        size_t index = (size_t)(share * (double)(sorted.size() - 1) + 0.5);
+        return sorted[index];
+    }
+
+    Result run (const Operation operation, const Sink sink,
+                const bool asynchronous, const unsigned int threads,
+                const uint64_t messages)
+    {
+        Log &log = *Log::sharedLog();
+        log.setLoglevel(LoglevelNormal);
+
+        std::shared_ptr<LogMemorySink> memory;
+        std::unique_ptr<NullOutput> nullOutput;
+        switch (sink) {
+            case SinkConsole:
+                nullOutput.reset(new NullOutput());
+                break;
+            case SinkFile:
+                log.useLogfile(kLogfilePath);
+                log.useErrorfile(kErrorfilePath);
+                break;
+            case SinkMemory:
+                memory = std::make_shared<LogMemorySink>();
+                log.addSink(memory);
+                log.setUseDefaultDestinations(false);
+                break;
+        }
+        log.setAsynchronous(asynchronous);
+
+        std::vector<std::vector<uint32_t>> latencies(threads);
+        std::vector<std::thread> producers;
+        std::atomic<unsigned int> ready { 0 };
+        std::atomic<bool> go { false };
+
+        for (unsigned int t = 0; t < threads; t++) {
+            producers.emplace_back([&, t] {
+                std::vector<uint32_t> &latency = latencies[t];
+                latency.resize(messages);
+
+                // start all producers at once
+                ready.fetch_add(1);
+                while (!go.load()) {
+                    std::this_thread::yield();
+                }
+
+                Clock::time_point last = Clock::now();
+                for (uint64_t i = 0; i < messages; i++) {
+                    logOnce(log, operation);
+                    Clock::time_point now = Clock::now();
+                    uint64_t elapsed = nanoseconds(now - last);
+                    latency[i] = elapsed > UINT32_MAX ?
+                        UINT32_MAX : (uint32_t)elapsed;
+                    last = now;
+                }
+            });
+        }
+
+        while (ready.load() != threads) {
+            std::this_thread::yield();
+        }
+        Clock::time_point start = Clock::now();
+        go.store(true);
+        for (size_t t = 0; t < producers.size(); t++) {
+            producers[t].join();
+        }
+        log.flush();
+        double seconds = (double)nanoseconds(Clock::now() - start) / 1e9;
+
+        // back to the console
+        log.setAsynchronous(false);
+        uint64_t writtenBytes = 0;
+        switch (sink) {
+            case SinkConsole:
+                nullOutput.reset();
+                break;
+            case SinkFile:
+                log.useLogfile("");
+                log.useErrorfile("");
+                writtenBytes = fileSize(kLogfilePath) + fileSize(kErrorfilePath);
+                std::remove(kLogfilePath);
+                std::remove(kErrorfilePath);
+                break;
+            case SinkMemory:
+                log.setUseDefaultDestinations(true);
+                log.removeSink(memory);
+                break;
+        }
+
+        std::vector<uint32_t> all;
+        all.reserve(messages * threads);
+        for (size_t t = 0; t < latencies.size(); t++) {
+            all.insert(all.end(), latencies[t].begin(), latencies[t].end());
+        }
+        std::sort(all.begin(), all.end());
+
+        Result result;
+        result.operation = operation;
+        result.sink = sink;
+        result.asynchronous = asynchronous;
+        result.threads = threads;
+        result.messages = messages * threads;
+        result.seconds = seconds;
+        result.writtenBytes = writtenBytes;
+        result.p50 = percentile(all, 0.5);
+        result.p99 = percentile(all, 0.99);
+        result.p999 = percentile(all, 0.999);
+        result.max = all.empty() ? 0 : all.back();
+        return result;
+    }
+
+    double messagesPerSecond (const Result &result)
+    {
+        return result.seconds > 0 ? (double)result.messages / result.seconds : 0;
+    }
+
+    // the message text given to the calls (filtered calls pass nothing on)
+    double payloadMegabytesPerSecond (const Result &result)
+    {
+        if (result.operation == OperationPrintvFiltered) {
+            return 0;
+        }
+        return messagesPerSecond(result) * (double)(sizeof(kMessage) - 1) / 1e6;
+    }
+
+    // the bytes written to the logfiles (timestamps, prefixes and newlines
+    // included), only measured for the file sink
+    bool writtenMegabytesPerSecond (const Result &result, double &value)
+    {
+        if (result.sink != SinkFile) {
+            return false;
+        }
+        value = result.seconds > 0 ?
+            (double)result.writtenBytes / result.seconds / 1e6 : 0;
+        return true;
+    }
+
+    bool writeJson (const std::string &path, const std::vector<Result> &results,
+                    const uint64_t messages, const uint64_t overhead)
+    {
+        std::ofstream out(path.c_str());
+        if (!out.is_open()) {
+            return false;
+        }
+
+        char time[32];
+        std::time_t now = std::time(nullptr);
+        std::strftime(time, sizeof(time), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+        out << "{\n"
+            << "  \"benchmark\": \"bench_log\",\n"
+            << "  \"time\": \"" << time << "\",\n"
+            << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+            << "  \"messages_per_thread\": " << messages << ",\n"
+            << "  \"message_bytes\": " << sizeof(kMessage) - 1 << ",\n"
+            << "  \"clock_overhead_ns\": " << overhead << ",\n"
+            << "  \"results\": [\n";
+
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result &result = results[i];
+
+            char written[32] = "null";
+            double writtenValue;
+            if (writtenMegabytesPerSecond(result, writtenValue)) {
+                snprintf(written, sizeof(written), "%.3f", writtenValue);
+            }
+
+            char line[512];
+            snprintf(line, sizeof(line),
+                     "    {\"operation\": \"%s\", \"sink\": \"%s\", "
+                     "\"mode\": \"%s\", \"threads\": %u, \"messages\": %llu, "
+                     "\"seconds\": %.6f, \"messages_per_second\": %.0f, "
+                     "\"payload_mb_per_second\": %.3f, "
+                     "\"written_mb_per_second\": %s, \"latency_ns\": {\"p50\": %llu, "
+                     "\"p99\": %llu, \"p99_9\": %llu, \"max\": %llu}}%s\n",
+                     kOperationNames[result.operation], kSinkNames[result.sink],
+                     result.asynchronous ? "async" : "sync", result.threads,
+                     (unsigned long long)result.messages, result.seconds,
+                     messagesPerSecond(result),
+                     payloadMegabytesPerSecond(result), written,
+                     (unsigned long long)result.p50,
+                     (unsigned long long)result.p99,
+                     (unsigned long long)result.p999,
+                     (unsigned long long)result.max,
+                     i + 1 < results.size() ? "," : "");
+            out << line;
+        }
+
+        out << "  ]\n}\n";
+        return out.good();
+    }
+}
+
+int main (int argc, const char **argv)
+{
+    uint64_t messages = 20000;
+    unsigned int maxThreads = std::min(8u, std::max(1u, std::thread::hardware_concurrency()));
+    bool runSync = true;
+    bool runAsync = true;
+    std::string output = "bench_log.json";
+    bool valid = true;
+
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (argument == "--messages" && hasValue) {
+            messages = strtoull(argv[++i], nullptr, 10);
+            valid = valid && messages > 0;
+        } else if (argument == "--threads" && hasValue) {
+            maxThreads = (unsigned int)strtoul(argv[++i], nullptr, 10);
+            valid = valid && maxThreads > 0;
+        } else if (argument == "--mode" && hasValue) {
+            std::string mode = argv[++i];
+            runSync = mode == "sync" || mode == "both";
+            runAsync = mode == "async" || mode == "both";
+            valid = valid && (runSync || runAsync);
+        } else if (argument == "--output" && hasValue) {
+            output = argv[++i];
+        } else {
+            valid = false;
+        }
+    }
+
+    if (!valid) {
+        std::cerr << "usage: " << argv[0]
+                  << " [--messages <count>] [--threads <count>]"
+                  << " [--mode sync|async|both] [--output <path>]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    uint64_t overhead = clockOverhead();
+    std::vector<Result> results;
+
+    printf("%-17s %-8s %-6s %7s %12s %9s %9s %8s %8s %8s %10s\n", "operation",
+           "sink", "mode", "threads", "msgs/s", "pay MB/s", "out MB/s",
+           "p50 ns", "p99 ns", "p99.9 ns", "max ns");
+
+    for (int mode = 0; mode < 2; mode++) {
+        bool asynchronous = mode == 1;
+        if ((asynchronous && !runAsync) || (!asynchronous && !runSync)) {
+            continue;
+        }
+        for (int sink = SinkConsole; sink <= SinkMemory; sink++) {
+            for (int operation = OperationPrint;
+                 operation <= OperationErrorWithErrno; operation++) {
+                for (size_t i = 0; i < threadCounts.size(); i++) {
+                    Result result = run((Operation)operation, (Sink)sink,
+                                        asynchronous, threadCounts[i], messages);
+                    results.push_back(result);
+
+                    char written[16] = "-";
+                    double writtenValue;
+                    if (writtenMegabytesPerSecond(result, writtenValue)) {
+                        snprintf(written, sizeof(written), "%.2f", writtenValue);
+                    }
+
+                    printf("%-17s %-8s %-6s %7u %12.0f %9.2f %9s %8llu %8llu %8llu %10llu\n",
+                           kOperationNames[result.operation],
+                           kSinkNames[result.sink],
+                           result.asynchronous ? "async" : "sync",
+                           result.threads, messagesPerSecond(result),
+                           payloadMegabytesPerSecond(result), written,
+                           (unsigned long long)result.p50,
+                           (unsigned long long)result.p99,
+                           (unsigned long long)result.p999,
+                           (unsigned long long)result.max);
+                    fflush(stdout);
+                }
+            }
+        }
+    }
+
+    if (!writeJson(output, results, messages, overhead)) {
+        std::cerr << "can't write " << output << std::endl;
+        return EXIT_FAILURE;
+    }
+    printf("results written to %s\n", output.c_str());
+
+    return EXIT_SUCCESS;
+}
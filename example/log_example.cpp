@@ -30,6 +30,12 @@
 #include <sstream>
 
 #include <rgp/Log.h>
+#include <rgp/LogBinary.h>
+#include <rgp/LogSink.h>
+#include <rgp/LogCategory.h>
+#include <rgp/LogPattern.h>
+#include <rgp/LogLimit.h>
+#include <rgp/LogTrace.h>
 
 using namespace rgp;
 
@@ -49,6 +55,10 @@ int main (int argc, const char **argv)
     logout << "another method " << 42 << std::endl;
     Log::sharedLog()->print(logout.str());
     
+    // the same without stringstream (formatted into a per-thread buffer)
+    RGPLOG_FORMAT_CHECK("this is another method {}", 42);
+    Log::sharedLog()->info("this is another method {}", 42);
+    
     Log::sharedLog()->printv("logout on verbose mode ... not set yet => this" \
         "won't be printed");
 
@@ -65,6 +75,61 @@ int main (int argc, const char **argv)
     RGPLOGV("This will only be logged if compiled in debug mode and logging " \
             "is on verbose");
     
+    // hot paths can log in binary form (decode with rgplog_decode)
+    if (Log::sharedLog()->useBinaryLogfile("example_log.bin")) {
+        for (int i = 0; i < 3; i++) {
+            RGPLOG_BINARY("binary record {} of {}", i + 1, 3);
+        }
+    }
+    
+    // named loggers with a loglevel of their own
+    LogCategory net("net");
+    net.setLoglevel(LoglevelNormal);
+    RGPLOGC_VERBOSE(net, "not written, {} is on normal", net.name());
+    net.info("connected to {}:{}", "localhost", 8080);
+    
+    // a layout of our own for the console (parsed once)
+    RGPLOG_PATTERN_CHECK("%H:%M:%S.%e %L [%t] %n: %v");
+    Log::sharedLog()->setConsolePattern("%H:%M:%S.%e %L [%t] %n: %v");
+    net.info("with time, level and thread");
+    Log::sharedLog()->setConsolePattern("");
+    
+    // typed fields, " key=value" here, members of the line in a logfile
+    // with LogEncodingJson
+    Log::sharedLog()->infoFields("request done", LogField("status", 200),
+                                 LogField("path", "/index.html"),
+                                 LogField("seconds", 0.25));
+    
+    // a hot error path: at most 2 lines per second, the rest is counted
+    // and summarized later
+    for (int i = 0; i < 1000; i++) {
+        RGPLOG_WARN_LIMIT(2, 2, "retry {} failed", i);
+    }
+    
+    // spans for chrome://tracing or ui.perfetto.dev
+    LogTrace::setEnabled(true);
+    {
+        RGP_TRACE_SCOPE("formatting");
+        for (int i = 0; i < 3; i++) {
+            RGP_TRACE_SCOPE("format one");
+            Log::sharedLog()->info("traced {}", i);
+        }
+    }
+    LogTrace::exportChrome("example_trace.json");
+    
+    // keep the last errors in memory in addition to the normal output
+    std::shared_ptr<LogMemorySink> recentErrors =
+        std::make_shared<LogMemorySink>(16, LogLayoutDetailed);
+    recentErrors->setStreams(LogSinkStreamError);
+    Log::sharedLog()->addSink(recentErrors);
+    
+    // let a writer thread do the output from now on
+    Log::sharedLog()->setAsynchronous(true);
+    Log::sharedLog()->print("This text is written by the writer thread");
+    
+    // wait till everything is written before asking the user
+    Log::sharedLog()->flush();
+    
     // getline will get the input from the user
     std::string yourName = Log::sharedLog()->getline("What is your name?: ");
     
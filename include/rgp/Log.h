@@ -33,6 +33,15 @@
 #include <mutex>
 #include <atomic>
 #include <string>
+#include <memory>
+#include <thread>
+#include <condition_variable>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+
+#include <rgp/LogFormat.h>
+#include <rgp/LogFields.h>
 
 // on windows we need the exports for creating the dll
 #if defined(_WIN32)
@@ -45,46 +54,119 @@
  #define RGPUTILS_EXPORT
 #endif
 
+// numeric loglevels for the preprocessor (same values as rgp::Loglevel)
+#define RGPLOG_LEVEL_OFF 0
+#define RGPLOG_LEVEL_NORMAL 1
+#define RGPLOG_LEVEL_VERBOSE 2
+
 // hide debug information (and string data) for better security
 // (less information for an attacker)
+// RGPLOG_COMPILE_LEVEL is the most detailed level that will be compiled in,
+// the macros of more detailed levels expand to nothing. Define it before
+// including this header to keep f.e. normal logs in a release build.
+#ifndef RGPLOG_COMPILE_LEVEL
 #ifdef DEBUG
-#define RGPLOG(xx) rgp::Log::sharedLog()->print(xx)
+#define RGPLOG_COMPILE_LEVEL RGPLOG_LEVEL_VERBOSE
 #else
-#define RGPLOG(xx) ((void)0)
+#define RGPLOG_COMPILE_LEVEL RGPLOG_LEVEL_OFF
 #endif // DEBUG
+#endif // RGPLOG_COMPILE_LEVEL
+
+// branch prediction hints for the level checks
+#if defined(__GNUC__) || defined(__clang__)
+#define RGPLOG_LIKELY(xx) __builtin_expect(!!(xx), 1)
+#define RGPLOG_UNLIKELY(xx) __builtin_expect(!!(xx), 0)
+#else
+#define RGPLOG_LIKELY(xx) (xx)
+#define RGPLOG_UNLIKELY(xx) (xx)
+#endif // defined(__GNUC__) || defined(__clang__)
+
+// The logging macros only evaluate their arguments if the runtime loglevel
+// allows the output. A disabled log site costs a relaxed atomic load and one
+// (predicted) branch.
+#if RGPLOG_COMPILE_LEVEL >= RGPLOG_LEVEL_NORMAL
+#define RGPLOG(xx) \
+    (RGPLOG_LIKELY(rgp::Log::enabled(rgp::LoglevelNormal)) ? \
+     rgp::Log::sharedLog()->print(xx) : (void)0)
+#else
+#define RGPLOG(xx) ((void)0)
+#endif // RGPLOG_COMPILE_LEVEL >= RGPLOG_LEVEL_NORMAL
 
-// hide debug information (and string data) for better security
-// (less information for an attacker)
 // verbose version of RGPLOG
-#ifdef DEBUG
-#define RGPLOGV(xx) rgp::Log::sharedLog()->printv(xx)
+// (verbose output is usually disabled, so the branch is marked as unlikely)
+#if RGPLOG_COMPILE_LEVEL >= RGPLOG_LEVEL_VERBOSE
+#define RGPLOGV(xx) \
+    (RGPLOG_UNLIKELY(rgp::Log::enabled(rgp::LoglevelVerbose)) ? \
+     rgp::Log::sharedLog()->printv(xx) : (void)0)
 #else
 #define RGPLOGV(xx) ((void)0)
-#endif // DEBUG
+#endif // RGPLOG_COMPILE_LEVEL >= RGPLOG_LEVEL_VERBOSE
 
 // hide debug information (and function name) for better security
 // (less information for an attacker)
-#ifdef DEBUG
+#if RGPLOG_COMPILE_LEVEL >= RGPLOG_LEVEL_NORMAL
 #define RGPLOGMETHODNAME() RGPLOG(__PRETTY_FUNCTION__)
 #else
 #define RGPLOGMETHODNAME() ((void)0)
-#endif // DEBUG
+#endif // RGPLOG_COMPILE_LEVEL >= RGPLOG_LEVEL_NORMAL
 
-// log errno
-#ifdef DEBUG
+// log errno (errors don't depend on the runtime loglevel)
+#if RGPLOG_COMPILE_LEVEL >= RGPLOG_LEVEL_NORMAL
 #define RGPLOG_ERRNO(xx,yy) rgp::Log::sharedLog()->errorWithErrno(xx, yy)
 #else
 #define RGPLOG_ERRNO(xx,yy) ((void)0)
-#endif // DEBUG
+#endif // RGPLOG_COMPILE_LEVEL >= RGPLOG_LEVEL_NORMAL
 
-#ifdef DEBUG
+#if RGPLOG_COMPILE_LEVEL >= RGPLOG_LEVEL_NORMAL
 #define RGPLOG_ERROR(xx) rgp::Log::sharedLog()->error(xx)
 #else
 #define RGPLOG_ERROR(xx) ((void)0)
-#endif // DEBUG
+#endif // RGPLOG_COMPILE_LEVEL >= RGPLOG_LEVEL_NORMAL
+
+// typed versions: RGPLOG_INFO("x={} y={}", x, y)
+// the format has to be a string literal, its placeholders are checked at
+// compile time
+#if RGPLOG_COMPILE_LEVEL >= RGPLOG_LEVEL_NORMAL
+#define RGPLOG_INFO(...) do { \
+    RGPLOG_FORMAT_CHECK(__VA_ARGS__); \
+    if (RGPLOG_LIKELY(rgp::Log::enabled(rgp::LoglevelNormal))) \
+        rgp::Log::sharedLog()->info(__VA_ARGS__); \
+} while (0)
+#define RGPLOG_WARN(...) do { \
+    RGPLOG_FORMAT_CHECK(__VA_ARGS__); \
+    rgp::Log::sharedLog()->warn(__VA_ARGS__); \
+} while (0)
+#else
+#define RGPLOG_INFO(...) ((void)0)
+#define RGPLOG_WARN(...) ((void)0)
+#endif // RGPLOG_COMPILE_LEVEL >= RGPLOG_LEVEL_NORMAL
+
+#if RGPLOG_COMPILE_LEVEL >= RGPLOG_LEVEL_VERBOSE
+#define RGPLOG_VERBOSE(...) do { \
+    RGPLOG_FORMAT_CHECK(__VA_ARGS__); \
+    if (RGPLOG_UNLIKELY(rgp::Log::enabled(rgp::LoglevelVerbose))) \
+        rgp::Log::sharedLog()->verbose(__VA_ARGS__); \
+} while (0)
+#else
+#define RGPLOG_VERBOSE(...) ((void)0)
+#endif // RGPLOG_COMPILE_LEVEL >= RGPLOG_LEVEL_VERBOSE
 
 namespace rgp {
     
+    class LogQueue;
+    class LogThreadQueue;
+    class LogFile;
+    class LogGroupCommit;
+    class LogRepeatFilter;
+    class LogSink;
+    class LogPattern;
+    class LogFlightRecorder;
+    class LogSharedRing;
+    class LogHeldOutput;
+    class LogCategory;
+    struct LogRecord;
+    struct LogMetrics;
+    
     /** Describes a Loglevel. */
     typedef enum : uint8_t {
         /** Turns logging off. Nothing will be outputted. */
@@ -141,6 +223,112 @@ namespace rgp {
         AnsiSgrBgColorWhite
     } AnsiSgrBgColor;
     
+    /** Describes what happens to a record when the queue of the asynchronous
+     log is full. */
+    typedef enum : uint8_t {
+        /** The logging thread waits until the writer thread made room. */
+        LogOverflowBlock = 0,
+        /** The new record is dropped. */
+        LogOverflowDropNewest,
+        /** The oldest queued record is dropped to make room. */
+        LogOverflowDropOldest,
+        /** The record is moved to an in-memory overflow area. */
+        LogOverflowSpill
+    } LogOverflowPolicy;
+    
+    /** Maximum number of log categories (including the global one with
+     index 0, see LogCategory). */
+    static const size_t kLogCategoryCount = 256;
+    
+    /** Counters of the overflow handling (asynchronous mode). */
+    struct LogOverflowStatistics {
+        /** Records that were dropped because the queue (or the overflow
+         area) was full. */
+        uint64_t dropped;
+        /** Queued records that were dropped to make room for new ones. */
+        uint64_t overwritten;
+        /** Log calls that had to wait for the writer thread. */
+        uint64_t blocked;
+        /** Records that were moved to the overflow area. */
+        uint64_t spilled;
+    };
+    
+    /** Describes when the logfile and the errorfile reach the disk. */
+    typedef enum : uint8_t {
+        /** The operating system decides (fastest, records of the last
+         seconds may be lost on a power failure). */
+        LogDurabilityNone = 0,
+        /** The files are synced (fdatasync) every sync interval. At most
+         one interval of records may be lost. */
+        LogDurabilityPeriodic,
+        /** A log call returns after its record is on the disk. Concurrent
+         calls share one sync, so the throughput grows with the number of
+         logging threads. */
+        LogDurabilityGroupCommit
+    } LogDurability;
+    
+    /** Describes what a process does with a shared log ring (see
+     Log::useSharedRing()). */
+    typedef enum : uint8_t {
+        /** Only publishes its records, another process writes them. */
+        LogSharedRingProducer = 0,
+        /** Publishes and writes the records of all processes. */
+        LogSharedRingCollector,
+        /** Publishes, the first process that is alive writes the records
+         (the others take over when it exits or dies). */
+        LogSharedRingElected
+    } LogSharedRingRole;
+    
+    /** The encoding of the lines in the logfile and the errorfile. */
+    typedef enum : uint8_t {
+        /** Timestamp and text (or the pattern), fields as " key=value"
+         pairs behind the text. */
+        LogEncodingText = 0,
+        /** logfmt: ts=... level=info msg="..." key=value */
+        LogEncodingLogfmt,
+        /** one JSON object per line:
+         {"ts":"...","level":"info","msg":"...","key":value} */
+        LogEncodingJson
+    } LogEncoding;
+    
+    /**
+     @brief When and how the logfile and the errorfile get rotated.
+     @details A rotated file gets the UTC time of the rotation appended to
+     its name ("app.log.20261018-091502") and is compressed to
+     "<name>.rlz" if requested (see LogCompressor).
+     */
+    struct LogRotation {
+        /** Rotate when the file reaches this size in bytes (0: never). */
+        uint64_t maxSize;
+        /** Rotate at every multiple of this many seconds since the epoch,
+         f.e. 3600: every full hour, 86400: at midnight UTC (0: never). */
+        unsigned int interval;
+        /** Keep at most this many rotated files (0: no limit). */
+        unsigned int maxFiles;
+        /** Delete rotated files older than this many seconds (0: no
+         limit). */
+        unsigned int maxAge;
+        /** Compress the rotated files. */
+        bool compress;
+        
+        /** No rotation. */
+        LogRotation () : maxSize(0), interval(0), maxFiles(0), maxAge(0),
+                         compress(false) {};
+    };
+    
+    /** Counters of the syncs of the logfile and the errorfile. */
+    struct LogDurabilityStatistics {
+        /** Number of syncs. */
+        uint64_t syncs;
+        /** Sum of the time all syncs took (microseconds). */
+        uint64_t syncTime;
+        /** The longest sync (microseconds). */
+        uint64_t maxSyncTime;
+        /** Log calls that waited for a group commit (commits / syncs is
+         the average group size). */
+        uint64_t commits;
+    };
+    
     /**
      @brief A Singleton Log class for thread-safe logging
      @details This class uses std::cout / std::cerr for log and error outputs.
@@ -152,11 +340,40 @@ namespace rgp {
         /** 
          @brief The Log class is build as a singleton.
          @details There is only one instance at a time. This method will give you this instance.
-         On first call this will create the singleton instance.
+         On first call this will create the singleton instance (thread-safe).
+         Use LogCategory for named loggers with their own loglevel.
          @return The shared log object.
          */
         static Log *sharedLog ();
         
+        /**
+         @brief Determines if output with the given loglevel would be used.
+         @details This is a single relaxed atomic load, it is used by the
+         logging macros to skip disabled log sites without evaluating their
+         arguments. Output is used if the current loglevel is at least the
+         given level or if the flight recorder is enabled.
+         @param level The loglevel of the output.
+         @return True if output with the given level would be written or
+         recorded.
+         @sa loglevel() and setFlightRecorder()
+         */
+        static bool enabled (const Loglevel level) {
+            return _enabledLevels[0].value.load(std::memory_order_relaxed) >= level;
+        };
+        
+        /**
+         @brief Determines if output of a category would be used.
+         @details Like enabled(const Loglevel), the level of the category is
+         read from a flat array by its index.
+         @param level The loglevel of the output.
+         @param category The index of the category (see LogCategory).
+         @return True if output with the given level would be written or
+         recorded.
+         */
+        static bool enabled (const Loglevel level, const uint16_t category) {
+            return _enabledLevels[category].value.load(std::memory_order_relaxed) >= level;
+        };
+        
         /**
          @brief The current LogLevel (Default: LoglevelNormal).
          @return The current LogLevel.
@@ -169,6 +386,7 @@ namespace rgp {
          @details The loglevel describes how detailed the output should be.
          This will affect output to logfiles in the same way.
          Input methods like getline or getc will be unaffected.
+         Categories without a loglevel of their own follow this level.
          @param level The new loglevel.
          @sa loglevel(), print() and printv()
          */
@@ -184,12 +402,29 @@ namespace rgp {
          terminals). This parameter is optional.
          @param bgcolor The background color of the text (only for supported
          terminals). This parameter is optional.
-         @sa loglevel() and useLogfile()
+         @sa loglevel(), info() and useLogfile()
          */
-        void print (const std::string text,
+        void print (const std::string &text,
                     const AnsiSgrFgColor fgcolor=AnsiSgrFgColorDefault,
                     const AnsiSgrBgColor bgcolor=AnsiSgrBgColorDefault);
         
+        /** @copydoc print(const std::string &, const AnsiSgrFgColor, const AnsiSgrBgColor) */
+        void print (const char *text,
+                    const AnsiSgrFgColor fgcolor=AnsiSgrFgColorDefault,
+                    const AnsiSgrBgColor bgcolor=AnsiSgrBgColorDefault);
+        
+#if defined(RGPLOG_HAS_STRING_VIEW)
+        /** @copydoc print(const std::string &, const AnsiSgrFgColor, const AnsiSgrBgColor) */
+        void print (const std::string_view text,
+                    const AnsiSgrFgColor fgcolor=AnsiSgrFgColorDefault,
+                    const AnsiSgrBgColor bgcolor=AnsiSgrBgColorDefault) {
+            if (enabled(LoglevelNormal)) {
+                submit(0, LoglevelNormal, text.data(), text.size(),
+                       fgcolor, bgcolor);
+            }
+        };
+#endif // defined(RGPLOG_HAS_STRING_VIEW)
+        
         /**
          @brief This will logout the given text.
          @details The given text will be printed to std::cout if the required
@@ -200,44 +435,176 @@ namespace rgp {
          terminals). This parameter is optional.
          @param bgcolor The background color of the text (only for supported
          terminals). This parameter is optional.
-         @sa loglevel() and useLogfile()
+         @sa loglevel(), verbose() and useLogfile()
          */
-        void printv (const std::string text,
+        void printv (const std::string &text,
                      const AnsiSgrFgColor fgcolor = AnsiSgrFgColorDefault,
                      const AnsiSgrBgColor bgcolor = AnsiSgrBgColorDefault);
         
+        /** @copydoc printv(const std::string &, const AnsiSgrFgColor, const AnsiSgrBgColor) */
+        void printv (const char *text,
+                     const AnsiSgrFgColor fgcolor = AnsiSgrFgColorDefault,
+                     const AnsiSgrBgColor bgcolor = AnsiSgrBgColorDefault);
+        
+#if defined(RGPLOG_HAS_STRING_VIEW)
+        /** @copydoc printv(const std::string &, const AnsiSgrFgColor, const AnsiSgrBgColor) */
+        void printv (const std::string_view text,
+                     const AnsiSgrFgColor fgcolor = AnsiSgrFgColorDefault,
+                     const AnsiSgrBgColor bgcolor = AnsiSgrBgColorDefault) {
+            if (RGPLOG_UNLIKELY(enabled(LoglevelVerbose))) {
+                submit(0, LoglevelVerbose, text.data(), text.size(),
+                       fgcolor, bgcolor);
+            }
+        };
+#endif // defined(RGPLOG_HAS_STRING_VIEW)
+        
+        /**
+         @brief Formats and logs out a message (like print()).
+         @details Every "{}" in the format string is replaced by the next
+         argument ("{{" and "}}" print a single brace). Integers, floating
+         point numbers, bool, char, strings and pointers are supported.
+         The text is formatted into a per-thread buffer, so no memory gets
+         allocated once the buffer has grown to the size of the messages.
+         Nothing is formatted if the loglevel is lower than LoglevelNormal.
+         Use RGPLOG_FORMAT_CHECK() to check the placeholders at compile time.
+         @param format The format string.
+         @param args The arguments for the placeholders.
+         @sa print(), verbose() and warn()
+         */
+        template <typename... Args>
+        void info (const char *format, const Args &... args) {
+            if (enabled(LoglevelNormal)) {
+                std::string &buffer = formatBuffer();
+                logFormat(buffer, format, args...);
+                submit(0, LoglevelNormal, buffer.data(), buffer.size());
+            }
+        };
+        
+        /**
+         @brief Formats and logs out a message (like printv()).
+         @details See info() for the format. Nothing is formatted if the
+         loglevel is lower than LoglevelVerbose.
+         @param format The format string.
+         @param args The arguments for the placeholders.
+         @sa printv() and info()
+         */
+        template <typename... Args>
+        void verbose (const char *format, const Args &... args) {
+            if (RGPLOG_UNLIKELY(enabled(LoglevelVerbose))) {
+                std::string &buffer = formatBuffer();
+                logFormat(buffer, format, args...);
+                submit(0, LoglevelVerbose, buffer.data(), buffer.size());
+            }
+        };
+        
+        /**
+         @brief Formats and logs out an error message (like error()).
+         @details See info() for the format.
+         @param format The format string.
+         @param args The arguments for the placeholders.
+         @sa error() and info()
+         */
+        template <typename... Args>
+        void warn (const char *format, const Args &... args) {
+            std::string &buffer = formatBuffer();
+            logFormat(buffer, format, args...);
+            submit(1, LoglevelNormal, buffer.data(), buffer.size());
+        };
+        
+        /**
+         @brief Logs out a message with typed key-value fields (like print()).
+         @details f.e. infoFields("request done", LogField("status", 200),
+         LogField("path", path)). The fields are only encoded here, the
+         writer renders them: as " key=value" pairs behind the text, or as
+         members of the line with LogEncodingJson (see setLogfileEncoding()).
+         Nothing is encoded if the loglevel is lower than LoglevelNormal.
+         @param message The message (not formatted).
+         @param fields The fields.
+         @sa verboseFields() and warnFields()
+         */
+        template <typename... Fields>
+        void infoFields (const char *message, const Fields &... fields) {
+            if (enabled(LoglevelNormal)) {
+                submitFields(0, LoglevelNormal, message, fields...);
+            }
+        };
+        
+        /**
+         @brief Logs out a message with fields (like printv()).
+         @details See infoFields(). Nothing is encoded if the loglevel is
+         lower than LoglevelVerbose.
+         @param message The message (not formatted).
+         @param fields The fields.
+         @sa infoFields()
+         */
+        template <typename... Fields>
+        void verboseFields (const char *message, const Fields &... fields) {
+            if (RGPLOG_UNLIKELY(enabled(LoglevelVerbose))) {
+                submitFields(0, LoglevelVerbose, message, fields...);
+            }
+        };
+        
+        /**
+         @brief Logs out an error message with fields (like error()).
+         @details See infoFields().
+         @param message The message (not formatted).
+         @param fields The fields.
+         @sa infoFields()
+         */
+        template <typename... Fields>
+        void warnFields (const char *message, const Fields &... fields) {
+            submitFields(1, LoglevelNormal, message, fields...);
+        };
+        
+        /** Maximum size of the output per stream that is held back while a
+         prompt waits for input. */
+        static const size_t kHeldOutputLimit = 1024 * 1024;
+        
         /**
          @brief Read a line from std::cin.
          @details Shows a given text and wait's on std::cin till the user gave
-         some input. All output through std::cout will be blocked until this
-         method returns. Output to std::cerr will still be shown.
+         some input. Logging threads aren't blocked meanwhile: their output
+         to std::cout and std::cerr (including the console sinks) is held
+         back (up to kHeldOutputLimit bytes per stream, further lines are
+         counted) and written when this method returns. Concurrent prompts
+         are shown one after the other.
          @param text The text that will be shown before the user can input his
          text.
          @return The input from std::cin. The input will be a whole line.
          @sa getc()
          */
-        std::string getline (const std::string text);
+        std::string getline (const std::string &text);
         
         /**
          @brief Read a character from std::cin.
          @details Shows a given text and wait's on std::cin till the user gave
-         his input. All output through std::cout will be blocked until this
-         method returns. Output to std::cerr will still be shown.
+         his input. Console output is held back meanwhile (see
+         getline()).
          @param text The text that will be shown before the user can input a
          character.
          @return The input from std::cin. The input just be a character.
          @sa getc()
          */
-        char getc (const std::string text);
+        char getc (const std::string &text);
         
         /**
          @brief This will logout the given text.
          @details The given text will be printed to std::cerr. If there is a
          errorfile specified, the output will be written to that file instead.
          @param text The text that should be logged out.
-         @sa errorWithErrno() and useErrorfile()
+         @sa errorWithErrno(), warn() and useErrorfile()
          */
-        void error (const std::string text);
+        void error (const std::string &text);
+        
+        /** @copydoc error(const std::string &) */
+        void error (const char *text);
+        
+#if defined(RGPLOG_HAS_STRING_VIEW)
+        /** @copydoc error(const std::string &) */
+        void error (const std::string_view text) {
+            submit(1, LoglevelNormal, text.data(), text.size());
+        };
+#endif // defined(RGPLOG_HAS_STRING_VIEW)
         
         /**
          @brief This will logout the given text with the given errno code.
@@ -249,15 +616,26 @@ namespace rgp {
          error text.
          @sa error() and useErrorfile()
          */
-        void errorWithErrno (const std::string text, const int err);
+        void errorWithErrno (const std::string &text, const int err);
+        
+        /** @copydoc errorWithErrno(const std::string &, const int) */
+        void errorWithErrno (const char *text, const int err);
+        
+#if defined(RGPLOG_HAS_STRING_VIEW)
+        /** @copydoc errorWithErrno(const std::string &, const int) */
+        void errorWithErrno (const std::string_view text, const int err) {
+            errorWithErrno(text.data(), text.size(), err);
+        };
+#endif // defined(RGPLOG_HAS_STRING_VIEW)
         
         /**
          @brief Set logfile for output.
          @details If this logfile is set, all outputs that would go to std::cout
          will go into this file instead (except input methods like getline).
+         The file stays open and is written through a buffer.
          @param filePath The path to the file that should be used.
          Preferably the full path.
-         @sa useErrorfile()
+         @sa useErrorfile(), setLogfileBufferSize() and reopenLogfiles()
          */
         void useLogfile (const std::string filePath);
         
@@ -265,11 +643,153 @@ namespace rgp {
          @brief Set logfile for error output.
          @details If this logfile is set, all outputs that would go to std::cerr
          will go into this file instead.
+         The file stays open and is written through a buffer.
          @param filePath The path to the file that should be used.
          Preferably the full path.
-         @sa useLogfile()
+         @sa useLogfile(), setLogfileBufferSize() and reopenLogfiles()
          */
         void useErrorfile (const std::string filePath);
+        
+        /**
+         @brief Set a binary logfile for deferred logging.
+         @details Enables the RGPLOG_BINARY() macro. Instead of text it writes
+         the call site id, a timestamp and the raw arguments of each call into
+         a per-thread buffer. The format strings are stored once per call
+         site. Use the rgplog_decode tool to turn the file back into text.
+         @param filePath The path to the file that should be used.
+         Preferably the full path.
+         @return True if the file could be opened.
+         @sa LogBinary
+         */
+        bool useBinaryLogfile (const std::string &filePath);
+        
+        /**
+         @brief Sets the size of the buffer of the logfile and the errorfile.
+         @details Logfiles are written when their buffer is full, when the
+         flush interval has passed or on flush(). Default: 64 KiB.
+         @param bytes The size of each buffer in bytes.
+         @sa setLogfileFlushInterval() and flush()
+         */
+        void setLogfileBufferSize (const size_t bytes);
+        
+        /**
+         @brief Sets the maximum time logged text may stay in a file buffer.
+         @details The asynchronous writer checks the interval while it is idle,
+         in synchronous mode a background thread checks it (after shutdown()
+         the logfiles are written through). Default: 1000 ms.
+         @param milliseconds The interval in milliseconds.
+         @sa setLogfileBufferSize() and flush()
+         */
+        void setLogfileFlushInterval (const unsigned int milliseconds);
+        
+        /**
+         @brief Sets the durability of the logfile and the errorfile.
+         @details Each level trades throughput for safety:
+         - LogDurabilityNone: no syncs (default).
+         - LogDurabilityPeriodic: every syncInterval the files are synced
+           (like the flush interval checked on writes and by the idle
+           writer thread).
+         - LogDurabilityGroupCommit: every log call that goes to one of the
+           files waits till its record is on the disk. In asynchronous mode
+           it also waits for the writer thread.
+         With both syncing levels a file is also synced before it is closed
+         (rotation, reopen).
+         The cost can be watched with durabilityStatistics() and the enqueue
+         latency of metrics() (which includes the wait for the commit).
+         @param durability The durability.
+         @param syncInterval Milliseconds between the syncs of
+         LogDurabilityPeriodic.
+         @sa durabilityStatistics()
+         */
+        void setLogfileDurability (const LogDurability durability,
+                                   const unsigned int syncInterval = 1000);
+        
+        /** The durability of the logfile and the errorfile. */
+        LogDurability logfileDurability () const;
+        
+        /**
+         @brief The sync counters of the logfile and the errorfile.
+         @details The counters are never reset.
+         @sa setLogfileDurability()
+         */
+        LogDurabilityStatistics durabilityStatistics () const;
+        
+        /**
+         @brief Sets the rotation of the logfile and the errorfile.
+         @details A background thread per file renames the file, opens a new
+         one and hands it over with an atomic exchange. The writing thread
+         picks it up on its next write, so log calls never wait for a
+         rotation. Retention and compression run on the same background
+         thread. Leftovers of an earlier run (uncompressed rotated files)
+         are compressed too.
+         @param rotation The rotation, LogRotation() disables it.
+         @sa LogRotation
+         */
+        void setLogfileRotation (const LogRotation &rotation);
+        
+        /**
+         @brief Maintains a side index of the logfile and the errorfile.
+         @details The index ("<logfile>.idx", see LogIndex) maps the time
+         range and the levels of every block of about intervalBytes to its
+         offset, rgplog_query uses it to seek to a time window. A block
+         costs one 32 byte write. Rotated files keep their index until they
+         get compressed. The offsets are only right as long as the file has
+         a single writer (the errorfile has to be another file than the
+         logfile). Default: Disabled.
+         @param intervalBytes Size of the blocks, 0 disables the index.
+         @sa setLogfileRotation()
+         */
+        void setLogfileIndex (const size_t intervalBytes = 64 * 1024);
+        
+        /**
+         @brief Reopens the logfile and the errorfile.
+         @details The files are reopened (by their path) before the next write.
+         Pending text is written to the old files first. This only sets a
+         flag, so it is safe to call this from a signal handler, f.e. on SIGHUP
+         after logrotate moved the files.
+         @sa useLogfile() and useErrorfile()
+         */
+        void reopenLogfiles ();
+
+        /**
+         @brief Adds a destination for the log records.
+         @details Every record is formatted once per layout and handed to all
+         sinks that accept it, in addition to the default destinations
+         (std::cout / std::cerr or the logfiles). The list of sinks is
+         replaced as a whole, so adding and removing sinks never blocks the
+         logging threads.
+         @param sink The sink (kept alive as long as it is added).
+         @sa removeSink(), setUseDefaultDestinations() and LogSink
+         */
+        void addSink (const std::shared_ptr<LogSink> &sink);
+        
+        /**
+         @brief Removes a sink that was added with addSink().
+         @details Records that are written at the moment may still reach the
+         sink. The sink gets flushed and closed (LogSink::close()).
+         @param sink The sink to remove.
+         @sa addSink()
+         */
+        void removeSink (const std::shared_ptr<LogSink> &sink);
+        
+        /**
+         @brief Enables or disables the default destinations.
+         @details The default destinations are std::cout / std::cerr or the
+         logfiles (see useLogfile() and useErrorfile()). Disable them if all
+         output should go to sinks only. Default: Enabled.
+         @param useDefaultDestinations Setting this to false will disable the
+         default destinations.
+         @sa addSink()
+         */
+        void setUseDefaultDestinations (const bool useDefaultDestinations);
+        
+        /**
+         @brief Determines if the default destinations are enabled.
+         @return True if records are written to std::cout / std::cerr or the
+         logfiles.
+         @sa setUseDefaultDestinations()
+         */
+        bool useDefaultDestinations () const;
 
         /**
         @brief Enables or disables the use of ANSI SGR Codes.
@@ -286,48 +806,601 @@ namespace rgp {
         */
         bool useAnsiSgrCodes () const;
         
+        /**
+         @brief Sets the layout of the lines in the logfile and the errorfile.
+         @details The pattern is parsed once (see LogPattern for the
+         specifiers), f.e. "%Y-%m-%dT%H:%M:%S.%f %l [%t] %n: %v". Default:
+         timestamp and text.
+         @param pattern The pattern, an empty string restores the default.
+         @sa setConsolePattern()
+         */
+        void setLogfilePattern (const std::string &pattern);
+        
+        /**
+         @brief Sets the encoding of the lines in the logfile and the
+         errorfile.
+         @details LogEncodingLogfmt and LogEncodingJson replace the
+         pattern (see setLogfilePattern()), the fields of a record (see
+         infoFields()) become pairs or members of the line. Default:
+         LogEncodingText.
+         @param encoding The encoding.
+         */
+        void setLogfileEncoding (const LogEncoding encoding);
+        
+        /**
+         @brief Sets the layout of the lines on std::cout and std::cerr.
+         @details The colors of a record are only written where the pattern
+         has "%^" and "%$" (setUseAnsiSgrCodes() colors whole lines only
+         without a pattern). Default: "[category] " and text.
+         @param pattern The pattern, an empty string restores the default.
+         @sa setLogfilePattern()
+         */
+        void setConsolePattern (const std::string &pattern);
+        
+        /** Number of the calling thread in the log ("%t" of a LogPattern,
+         1 for the first thread that logged). */
+        static uint32_t threadNumber ();
+        
+        /**
+         @brief Enables or disables asynchronous logging.
+         @details In asynchronous mode print(), printv() and error() only copy
+         the text into a bounded lock-free queue and return. A dedicated writer
+         thread drains the queue and writes the records to std::cout /
+         std::cerr or the logfiles. What happens if the queue is full depends
+         on the overflow policy (see setOverflowPolicy()). Disabling the asynchronous mode writes all
+         pending records before the writer thread is stopped. Default: Disabled.
+         @param asynchronous Setting this to true will start the writer thread.
+         @param queueCapacity Number of records the queue can hold. Will be
+         rounded up to the next power of two. Only used when the queue is
+         created (first time the asynchronous mode gets enabled).
+         @sa asynchronous(), setOverflowPolicy(), flush() and shutdown()
+         */
+        void setAsynchronous (const bool asynchronous,
+                              const size_t queueCapacity = 8192);
+        
+        /**
+         @brief Gives every logging thread its own queue.
+         @details Only used in asynchronous mode. Instead of sharing one queue
+         (and its cache lines) every thread that logs gets a single-producer
+         queue on its first log call. The queue is retired when the thread
+         exits. The writer thread merges the queues by the timestamps of the
+         records. The order is best-effort: a record that is still being
+         queued (its timestamp is taken before it gets published) can be
+         overtaken by newer records of other threads, so lines of different
+         threads may appear slightly out of order. The records of one thread
+         always stay in order. Default: Disabled.
+         @param perThreadQueues Setting this to true will enable the
+         per-thread queues.
+         @param queueCapacity Number of records each per-thread queue can
+         hold. Will be rounded up to the next power of two. Only used for
+         queues created after this call.
+         @sa setAsynchronous()
+         */
+        void setPerThreadQueues (const bool perThreadQueues,
+                                 const size_t queueCapacity = 1024);
+        
+        /**
+         @brief Determines if every logging thread gets its own queue.
+         @return True if per-thread queues are enabled.
+         @sa setPerThreadQueues()
+         */
+        bool perThreadQueues () const;
+        
+        /**
+         @brief Sets what happens to a record when the queue is full.
+         @details Only used in asynchronous mode. With LogOverflowBlock the
+         logging thread waits until the writer thread made room, all other
+         policies never wait for the writer (and the disk behind it):
+         LogOverflowDropNewest drops the new record, LogOverflowDropOldest
+         drops the oldest queued record (per-thread queues drop the new
+         record instead) and LogOverflowSpill moves the record to an in-memory
+         overflow area that is merged into the output by the writer. If the
+         overflow area is full the record is dropped.
+         Whenever records got lost, the writer outputs a line with the number
+         of dropped messages. Default: LogOverflowBlock.
+         @param policy The new policy.
+         @param spillCapacity Maximum number of text bytes in the overflow
+         area (LogOverflowSpill).
+         @sa overflowPolicy() and overflowStatistics()
+         */
+        void setOverflowPolicy (const LogOverflowPolicy policy,
+                                const size_t spillCapacity = 4 * 1024 * 1024);
+        
+        /**
+         @brief The current overflow policy.
+         @return The current overflow policy.
+         @sa setOverflowPolicy()
+         */
+        LogOverflowPolicy overflowPolicy () const;
+        
+        /**
+         @brief The counters of the overflow handling.
+         @details The counters are exact and never reset.
+         @return Dropped, overwritten, spilled records and blocked log calls
+         since the start of the process.
+         @sa setOverflowPolicy()
+         */
+        LogOverflowStatistics overflowStatistics () const;
+        
+        /**
+         @brief Enables or disables the flight recorder.
+         @details The flight recorder keeps the last records of all streams
+         in memory, including verbose records that are not written because
+         of the current loglevel (their arguments get evaluated while the
+         recorder is enabled). Every record costs a fetch_add and a memcpy of
+         its text (truncated to about 230 characters).
+         The recorder is dumped to a file in the error directory (the
+         directory of the errorfile or the working directory) when the
+         process receives SIGSEGV or SIGABRT, see dumpFlightRecorder().
+         Default: Disabled.
+         @param enabled Setting this to true will enable the recorder.
+         @param capacity Number of records the recorder keeps. Will be
+         rounded up to the next power of two. Only used when the recorder is
+         created (first time it gets enabled).
+         @sa dumpFlightRecorder()
+         */
+        void setFlightRecorder (const bool enabled,
+                                const size_t capacity = 1024);
+        
+        /**
+         @brief Determines if the flight recorder is enabled.
+         @return True if records are kept in the flight recorder.
+         @sa setFlightRecorder()
+         */
+        bool flightRecorder () const;
+        
+        /**
+         @brief Writes the records of the flight recorder to a file.
+         @details The file is truncated. Timestamps are written in UTC.
+         @param filePath The path of the file. If empty the crash dump path
+         is used ("rgplog_flight_<pid>.log" in the error directory).
+         @return True if the records could be written.
+         @sa setFlightRecorder()
+         */
+        bool dumpFlightRecorder (const std::string &filePath = std::string());
+        
+        /**
+         @brief Enables or disables the self-instrumentation.
+         @details Counts messages and bytes per loglevel and per sink,
+         measures the time spent in log calls and the time needed to write
+         file buffers, and tracks the high-water mark of the queues. Every
+         logging thread counts into its own shard, so measuring adds no
+         contention. Default: Disabled.
+         @param enabled Setting this to true will start collecting.
+         @param dumpIntervalMilliseconds If not 0 a summary line is logged
+         (output stream) at this interval.
+         @sa metrics()
+         */
+        void setMetrics (const bool enabled,
+                         const unsigned int dumpIntervalMilliseconds = 0);
+        
+        /**
+         @brief Determines if the self-instrumentation is enabled.
+         @return True if metrics are collected.
+         @sa setMetrics()
+         */
+        bool metricsEnabled () const;
+        
+        /**
+         @brief A snapshot of the counters.
+         @details Include <rgp/LogMetrics.h> to use the result.
+         @return The counters since metrics were enabled the first time.
+         @sa setMetrics() and overflowStatistics()
+         */
+        LogMetrics metrics () const;
+        
+        /**
+         @brief Sets how often suppressed messages are summarized.
+         @details Call sites with a rate limit or sampling (see
+         <rgp/LogLimit.h>) count the calls they suppress. At this interval
+         one line per call site is written to the error stream
+         ("file.cpp:42: suppressed 12345 similar messages"). In asynchronous
+         mode the writer thread writes the summaries, otherwise the next
+         call that gets through a limit does. Default: 10000 ms.
+         @param milliseconds The interval.
+         */
+        void setSuppressionReportInterval (const unsigned int milliseconds);
+        
+        /**
+         @brief Collapses runs of identical messages.
+         @details A message that repeats the last one of its stream (same
+         text, level, category and colors) within the window after the
+         first one of the run is only counted. When the run ends (another
+         message, the window has passed or flush()) a single "last message
+         repeated N times" line is written. Every message is hashed once,
+         the check against the last one doesn't depend on the history.
+         Sinks get the same collapsed output. Default: Disabled.
+         @param windowMilliseconds The window, 0 disables the coalescing
+         (pending repeat counts are written).
+         */
+        void setRepeatCoalescing (const unsigned int windowMilliseconds);
+        
+        /**
+         @brief Sends the records of this process through a ring in shared
+         memory.
+         @details Meant for several processes that write one logfile: every
+         process attaches to the ring with the same name (created by the
+         first one) and publishes its records without taking a lock. One
+         collector process reads the ring and writes the records of all
+         processes to its own destinations (console, logfiles, sinks), so
+         the processes don't compete for the file and lines never interleave.
+         Records are checked by the loglevels of the publishing process.
+         If the ring is full the record is dropped, the collector writes
+         the number of lost records. A producer that dies while publishing
+         only loses its own record. Can only be called once, only available
+         on Unix systems. Default: Disabled.
+         @param name The name of the ring (a POSIX shared memory name, f.e.
+         "/myapp.log").
+         @param role What this process does with the ring.
+         @param slotCount Number of records the ring can hold (only used by
+         the process that creates the ring).
+         @param slotSize Size of a record in the ring, longer texts are cut
+         (only used by the process that creates the ring).
+         @return False if the ring couldn't be opened or there already is
+         a living collector (LogSharedRingCollector).
+         @sa removeSharedRing() and shutdown()
+         */
+        bool useSharedRing (const std::string &name,
+                            const LogSharedRingRole role,
+                            const size_t slotCount = 65536,
+                            const size_t slotSize = 512);
+        
+        /**
+         @brief Removes the name of a shared ring.
+         @details Processes that are attached keep their ring, the next
+         useSharedRing() creates a new one.
+         @param name The name of the ring.
+         @return True if the ring existed.
+         */
+        static bool removeSharedRing (const std::string &name);
+        
+        /**
+         @brief Determines if asynchronous logging is enabled.
+         @return True if a writer thread is running, false otherwise.
+         @sa setAsynchronous()
+         */
+        bool asynchronous () const;
+        
+        /**
+         @brief Writes all pending records.
+         @details Blocks until every record logged before this call has been
+         written and the output streams / logfiles are flushed. The buffers of
+         the binary logfile are written as well.
+         @sa setAsynchronous() and shutdown()
+         */
+        void flush ();
+        
+        /**
+         @brief Writes all pending records and stops the writer thread.
+         @details After this call the log works synchronously again. A
+         collector of a shared ring writes the records in the ring and gives
+         up its role. The logfiles are written through from now on. The
+         sinks get closed (LogSink::close()), a
+         LogMappedFileSink drops the records after that. This is called
+         automatically when the process exits normally.
+         @sa setAsynchronous() and flush()
+         */
+        void shutdown ();
+        
     private:
         
+        // categories log through submit()
+        friend class LogCategory;
+        
+        // call site limits trigger the summaries of suppressed messages
+        friend class LogCallSiteLimit;
+        
         // make constructor private (we are a singleton class)
-        Log () {}
+        Log ();
+        ~Log ();
         
         // disallow copy constructor
         Log (const Log &log) = delete;
         Log &operator = (Log const &) = delete;
         
-        // singleton instance
-        static Log *_sharedInstance;
-        
         // protect cout with a mutex to make it thread-safe
         std::mutex _cout_mutex;
         
         // protect cerr with a mutex to make it thread-safe
         std::mutex _cerr_mutex;
         
-        // store the current loglevel
-        std::atomic<Loglevel> _logLevel { LoglevelNormal };
+        // one prompt at a time (getline() and getc())
+        std::mutex _inputMutex;
+        
+        // output to std::cout and std::cerr while a prompt waits for input
+        // (changed with _cout_mutex and _cerr_mutex locked, every stream
+        // uses its part of _heldOutput with its mutex)
+        bool _prompting { false };
+        std::unique_ptr<LogHeldOutput> _heldOutput;
+        std::vector<std::shared_ptr<LogSink>> _heldSinks;
+        
+        // shows the prompt and holds the output back / writes what was held
+        void beginPrompt (const std::string &text);
+        void endPrompt ();
+        
+        // a loglevel with a constant initializer (usable before main())
+        struct LevelCell {
+            std::atomic<Loglevel> value { LoglevelNormal };
+        };
+        
+        // the loglevel of every category (index 0: global loglevel)
+        static LevelCell _levels[kLogCategoryCount];
+        
+        // most detailed level per category that is written or recorded
+        // (see enabled())
+        static LevelCell _enabledLevels[kLogCategoryCount];
+        
+        // categories with a loglevel of their own (protected by _levelsMutex)
+        static bool _explicitLevels[kLogCategoryCount];
+        static std::mutex _levelsMutex;
+        
+        // sets the loglevel of a category (explicitLevel false: follow the
+        // global loglevel)
+        void setCategoryLoglevel (const uint16_t category, const Loglevel level,
+                                  const bool explicitLevel);
+        
+        // the flight recorder (never deleted, a signal handler may use it)
+        // and the active one (nullptr while disabled)
+        std::unique_ptr<LogFlightRecorder> _flightRecorderStorage;
+        std::atomic<LogFlightRecorder *> _flightRecorder { nullptr };
+        std::mutex _flightRecorderMutex;
+        
+        // updates _enabledLevels from the loglevels and the flight recorder
+        // (_levelsMutex has to be locked)
+        void updateEnabledLevels ();
+        
+        // file the flight recorder is dumped to on crashes
+        std::string flightRecorderPath () const;
         
         // if we are able to use the given logfile, this variable will be true
         std::atomic<bool> _hasLogfile { false };
         
-        // stores the path to the given logfile
-        std::string _logFilePath { "" };
+        // the logfile (open while _hasLogfile is true)
+        std::unique_ptr<LogFile> _logFile;
         
         // if we are able to use the given error logfile,
         // this variable will be true
         std::atomic<bool> _hasErrorfile { false };
         
-        // stores the path to the given error logfile
-        std::string _errorFilePath { "" };
+        // the error logfile (open while _hasErrorfile is true)
+        std::unique_ptr<LogFile> _errorFile;
+        
+        // true if the files maintain a side index
+        std::atomic<bool> _logfileIndex { false };
+        
+        // window of the repeat coalescing (microseconds, 0: disabled),
+        // last records per stream
+        std::atomic<int64_t> _repeatWindow { 0 };
+        std::unique_ptr<LogRepeatFilter> _repeatFilters[2];
+        
+        // durability of both files, group commits per file
+        std::atomic<LogDurability> _durability { LogDurabilityNone };
+        std::unique_ptr<LogGroupCommit> _logCommit;
+        std::unique_ptr<LogGroupCommit> _errorCommit;
 
+        // additional destinations (replaced as a whole, read with
+        // std::atomic_load while _hasSinks is true)
+        std::mutex _sinksMutex;
+        std::shared_ptr<std::vector<std::shared_ptr<LogSink>>> _sinks;
+        std::atomic<bool> _hasSinks { false };
+        
+        // false if records only go to the sinks
+        std::atomic<bool> _useDefaultDestinations { true };
+        
         // determines if ANSI SGR Codes should be used or not
         bool _useAnsiSgrCodes { false };
         
-        // creates ANSI SGR Code for given foreground and background colors
-        std::string createSelectGraphicRenditionCode(const AnsiSgrFgColor fgcolor,
-                                                     const AnsiSgrBgColor bgcolor);
-        // creates ANSI SGR Reset Code
-        std::string resetSelectGraphicRenditionCode();
+        // patterns of the default destinations (nullptr: built-in layout,
+        // changed with _cout_mutex and _cerr_mutex locked)
+        std::shared_ptr<const LogPattern> _logfilePattern;
+        std::shared_ptr<const LogPattern> _consolePattern;
+        LogEncoding _logfileEncoding { LogEncodingText };
+        
+        // queue between the logging threads and the writer thread
+        // (created the first time the asynchronous mode gets enabled)
+        std::unique_ptr<LogQueue> _queue;
+        
+        // true while records have to go through the queue
+        std::atomic<bool> _asynchronous { false };
+        
+        // true if every thread uses its own queue
+        std::atomic<bool> _perThreadQueues { false };
+        std::atomic<size_t> _threadQueueCapacity { 1024 };
+        
+        // all per-thread queues (replaced as a whole, read by the writer
+        // with std::atomic_load)
+        std::mutex _threadQueuesMutex;
+        std::shared_ptr<std::vector<std::shared_ptr<LogThreadQueue>>> _threadQueues;
+        
+        // the writer thread (asynchronous mode)
+        std::thread _writerThread;
+        
+        // writes due file buffers and summaries in synchronous mode
+        // (started by the first synchronous record, stopped by shutdown(),
+        // after that the logfiles are written through)
+        std::thread _housekeeperThread;
+        std::mutex _housekeeperMutex;
+        std::condition_variable _housekeeperCondition;
+        std::atomic<uint8_t> _housekeeperState { 0 };
+        bool _stopHousekeeper { false };
+        
+        // serializes enabling / disabling of the asynchronous mode
+        std::mutex _asyncMutex;
+        
+        // only the owner of this mutex may read from the queue
+        std::mutex _drainMutex;
+        
+        // the record of the shared queue the writer claimed but didn't
+        // deliver yet (changed with _drainMutex locked)
+        LogRecord *_claimedRecord { nullptr };
+        uint64_t _claimedPosition { 0 };
+        
+        // used to put the writer thread to sleep and to wait for flushes
+        std::mutex _writerMutex;
+        std::condition_variable _writerCondition;
+        std::condition_variable _flushCondition;
+        std::atomic<bool> _writerWaiting { false };
+        std::atomic<int> _flushWaiters { 0 };
+        bool _stopWriter { false };
+        
+        // what happens if the queue is full
+        std::atomic<LogOverflowPolicy> _overflowPolicy { LogOverflowBlock };
+        
+        // overflow area (LogOverflowSpill), records are appended by the
+        // logging threads and removed by the owner of _drainMutex
+        std::mutex _spillMutex;
+        std::unique_ptr<std::deque<LogRecord>> _spill;
+        size_t _spillBytes { 0 };
+        std::atomic<size_t> _spillCapacity { 4 * 1024 * 1024 };
+        std::atomic<uint64_t> _spillDelivered { 0 };
+        
+        // overflow counters
+        std::atomic<uint64_t> _droppedRecords { 0 };
+        std::atomic<uint64_t> _overwrittenRecords { 0 };
+        std::atomic<uint64_t> _blockedCalls { 0 };
+        std::atomic<uint64_t> _spilledRecords { 0 };
+        
+        // dropped + overwritten records the writer already reported
+        uint64_t _reportedLostRecords { 0 };
+        
+        // the shared ring (never unmapped, set once by useSharedRing())
+        std::unique_ptr<LogSharedRing> _sharedRing;
+        std::atomic<LogSharedRing *> _sharedRingPointer { nullptr };
+        LogSharedRingRole _sharedRingRole { LogSharedRingProducer };
+        
+        // the thread that reads the ring (collector and elected role)
+        std::thread _collectorThread;
+        std::mutex _collectorMutex;
+        std::condition_variable _collectorCondition;
+        bool _stopCollector { false };
+        
+        // true while this process is the collector of the ring
+        std::atomic<bool> _collecting { false };
+        
+        // only the owner of this mutex may read from the ring
+        std::mutex _collectMutex;
+        
+        // category names of the ring and their index in this process
+        std::unordered_map<std::string, uint16_t> _ringCategories;
+        
+        // interval and time of the next metrics line (microseconds,
+        // 0: no metrics lines)
+        std::atomic<int64_t> _metricsDumpInterval { 0 };
+        std::atomic<int64_t> _nextMetricsDump { 0 };
+        
+        // logs the metrics line if it is due
+        void dumpMetricsIfDue (const int64_t now);
+        
+        // interval and time of the next summary of suppressed messages
+        // (microseconds of LogClock::coarse())
+        std::atomic<int64_t> _suppressionReportInterval { 10000000 };
+        std::atomic<int64_t> _nextSuppressionReport { 0 };
+        
+        // logs the summaries of suppressed messages if they are due
+        // (only the writer may do it in asynchronous mode)
+        void reportSuppressedIfDue (const int64_t now, const bool writer);
+        
+        // hands a record to the queue or writes it directly
+        // (stream 0: output, 1: error)
+        void submit (const uint8_t stream, const Loglevel level,
+                     const char *text, const size_t length,
+                     const AnsiSgrFgColor fgcolor = AnsiSgrFgColorDefault,
+                     const AnsiSgrBgColor bgcolor = AnsiSgrBgColorDefault,
+                     const uint16_t category = 0, const uint32_t fields = 0);
+        
+        // encodes the fields behind the message and submits the record
+        template <typename... Fields>
+        void submitFields (const uint8_t stream, const Loglevel level,
+                           const char *message, const Fields &... fields) {
+            std::string &buffer = formatBuffer();
+            buffer.append(message);
+            size_t start = buffer.size();
+            logFieldsEncode(buffer, fields...);
+            submit(stream, level, buffer.data(), buffer.size(),
+                   AnsiSgrFgColorDefault, AnsiSgrBgColorDefault, 0,
+                   (uint32_t)(buffer.size() - start));
+        };
+        
+        // moves a record to the overflow area (or drops it)
+        void spill (const int64_t timestamp, const uint8_t stream,
+                    const Loglevel level, const char *text,
+                    const size_t length, const AnsiSgrFgColor fgcolor,
+                    const AnsiSgrBgColor bgcolor, const uint16_t category,
+                    const uint32_t fields);
+        
+        // wakes the writer for a new record, writes it directly if the
+        // asynchronous mode got disabled meanwhile
+        void recordPublished ();
+        
+        // outputs a line with the number of records lost since the last
+        // report (_drainMutex has to be locked)
+        void reportLostRecords ();
+        
+        // appends the errno text and logs out the error
+        void errorWithErrno (const char *text, const size_t length,
+                             const int err);
+        
+        // cleared per-thread buffer for the typed methods (info() ...)
+        static std::string &formatBuffer ();
+        
+        // writes a record unless it repeats the last one
+        // (the mutex of the stream has to be locked)
+        void deliver (const LogRecord &record);
+        
+        // writes a record to std::cout / std::cerr or the logfiles
+        // (the mutex of the stream has to be locked)
+        void output (const LogRecord &record);
+        
+        // writes the repeat count of a stream if there is one (or if the
+        // run is over when due is set, the mutex of the stream has to be
+        // locked)
+        void reportRepeats (const uint8_t stream, const bool due);
+        
+        // writes all published records of the queue, returns the count
+        size_t drainQueue ();
+        
+        // writes the file buffers if their flush interval has passed
+        void flushLogfilesIfDue ();
+        
+        // waits till the writer thread delivered everything that is queued
+        // right now (asynchronous mode)
+        void waitForWriter ();
+        
+        // waits till the file of the stream is durable up to the last
+        // record of the calling thread (LogDurabilityGroupCommit)
+        void commitDurable (const uint8_t stream);
+        
+        // determines if any queue holds records
+        bool hasPendingRecords () const;
+        
+        // the queue of the calling thread (created on first use),
+        // nullptr while the thread exits
+        LogThreadQueue *threadQueue ();
+        
+        // removes queues of exited threads that have been drained
+        void removeRetiredQueues ();
+        
+        // wakes up the writer thread
+        void wakeWriter ();
+        
+        // main loop of the writer thread
+        void writerLoop ();
+        
+        // starts the housekeeper thread if it didn't run yet
+        void startHousekeeper ();
+        
+        // main loop of the housekeeper thread
+        void housekeeperLoop ();
+        
+        // writes the records of the shared ring, returns the count
+        // (_collecting has to be true)
+        size_t collect ();
+        
+        // main loop of the collector thread
+        void collectorLoop ();
+        
+        // called on process exit
+        static void exitHandler ();
     };
     
     /** Exception class for Log */
@@ -0,0 +1,304 @@
+/*
+ RGPUtils
+ LogBinary.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ Deferred binary logging: call sites register their format string once,
+ every log call only stores the raw arguments. The companion tool
+ rgplog_decode turns a binary logfile back into text.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogBinary_H__
+#define __RGPUtils__LogBinary_H__
+
+#include <rgp/Log.h>
+
+#include <atomic>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+// Logs the format and its arguments in binary form (if a binary logfile is
+// open). The format has to be a string literal, f.e.:
+// RGPLOG_BINARY("request {} took {} us", requestId, duration);
+#define RGPLOG_BINARY(...) do { \
+    RGPLOG_FORMAT_CHECK(__VA_ARGS__); \
+    if (RGPLOG_LIKELY(rgp::LogBinary::enabled())) { \
+        static std::atomic<uint32_t> rgplogCallSite { 0 }; \
+        rgp::LogBinary::write(rgplogCallSite, __FILE__, __LINE__, __VA_ARGS__); \
+    } \
+} while (0)
+
+namespace rgp {
+
+    /**
+     @brief Describes how a type is stored in a binary log record.
+     @details Every specialization provides the type tag that is stored with
+     the call site, the encoded size of a value and the encoder. The decoder
+     knows the layout of each tag:
+     'i' int32, 'u' uint32, 'l' int64, 'L' uint64, 'd' double, 'b' bool,
+     'c' char, 'p' pointer (uint64), 's' string (uint32 length + bytes).
+     */
+    template <typename T, typename Enable = void>
+    struct LogBinaryArgument;
+
+    // integers (stored with 32 or 64 bit)
+    template <typename T>
+    struct LogBinaryArgument<T, typename std::enable_if<
+        std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+        !std::is_same<T, char>::value>::type> {
+
+        typedef typename std::conditional<sizeof(T) <= 4,
+            typename std::conditional<std::is_signed<T>::value, int32_t, uint32_t>::type,
+            typename std::conditional<std::is_signed<T>::value, int64_t, uint64_t>::type
+        >::type Stored;
+
+        static const char tag = sizeof(T) <= 4 ?
+            (std::is_signed<T>::value ? 'i' : 'u') :
+            (std::is_signed<T>::value ? 'l' : 'L');
+
+        static size_t size (const T &) { return sizeof(Stored); }
+        static char *encode (char *out, const T &value) {
+            Stored stored = (Stored)value;
+            memcpy(out, &stored, sizeof(stored));
+            return out + sizeof(stored);
+        }
+    };
+
+    // enums (stored as int64)
+    template <typename T>
+    struct LogBinaryArgument<T, typename std::enable_if<
+        std::is_enum<T>::value>::type> {
+
+        static const char tag = 'l';
+        static size_t size (const T &) { return sizeof(int64_t); }
+        static char *encode (char *out, const T &value) {
+            int64_t stored = (int64_t)value;
+            memcpy(out, &stored, sizeof(stored));
+            return out + sizeof(stored);
+        }
+    };
+
+    // floating point numbers (stored as double)
+    template <typename T>
+    struct LogBinaryArgument<T, typename std::enable_if<
+        std::is_floating_point<T>::value>::type> {
+
+        static const char tag = 'd';
+        static size_t size (const T &) { return sizeof(double); }
+        static char *encode (char *out, const T &value) {
+            double stored = (double)value;
+            memcpy(out, &stored, sizeof(stored));
+            return out + sizeof(stored);
+        }
+    };
+
+    template <>
+    struct LogBinaryArgument<bool> {
+        static const char tag = 'b';
+        static size_t size (const bool &) { return 1; }
+        static char *encode (char *out, const bool &value) {
+            *out = value ? 1 : 0;
+            return out + 1;
+        }
+    };
+
+    template <>
+    struct LogBinaryArgument<char> {
+        static const char tag = 'c';
+        static size_t size (const char &) { return 1; }
+        static char *encode (char *out, const char &value) {
+            *out = value;
+            return out + 1;
+        }
+    };
+
+    // strings (uint32 length followed by the bytes)
+    struct LogBinaryString {
+        static const char tag = 's';
+        static size_t size (const char *, const size_t length) {
+            return sizeof(uint32_t) + length;
+        }
+        static char *encode (char *out, const char *data, const size_t length) {
+            uint32_t stored = (uint32_t)length;
+            memcpy(out, &stored, sizeof(stored));
+            memcpy(out + sizeof(stored), data, length);
+            return out + sizeof(stored) + length;
+        }
+    };
+
+    template <>
+    struct LogBinaryArgument<const char *> : LogBinaryString {
+        static size_t size (const char *value) {
+            return LogBinaryString::size(value, value ? strlen(value) : 0);
+        }
+        static char *encode (char *out, const char *value) {
+            return LogBinaryString::encode(out, value, value ? strlen(value) : 0);
+        }
+    };
+
+    template <>
+    struct LogBinaryArgument<char *> : LogBinaryArgument<const char *> {
+    };
+
+    template <>
+    struct LogBinaryArgument<std::string> : LogBinaryString {
+        static size_t size (const std::string &value) {
+            return LogBinaryString::size(value.data(), value.size());
+        }
+        static char *encode (char *out, const std::string &value) {
+            return LogBinaryString::encode(out, value.data(), value.size());
+        }
+    };
+
+#if defined(RGPLOG_HAS_STRING_VIEW)
+    template <>
+    struct LogBinaryArgument<std::string_view> : LogBinaryString {
+        static size_t size (const std::string_view &value) {
+            return LogBinaryString::size(value.data(), value.size());
+        }
+        static char *encode (char *out, const std::string_view &value) {
+            return LogBinaryString::encode(out, value.data(), value.size());
+        }
+    };
+#endif // defined(RGPLOG_HAS_STRING_VIEW)
+
+    // other pointers (stored as uint64 address)
+    template <typename T>
+    struct LogBinaryArgument<T *, typename std::enable_if<
+        !std::is_same<typename std::remove_cv<T>::type, char>::value>::type> {
+
+        static const char tag = 'p';
+        static size_t size (T *) { return sizeof(uint64_t); }
+        static char *encode (char *out, T *value) {
+            uint64_t stored = (uint64_t)(uintptr_t)value;
+            memcpy(out, &stored, sizeof(stored));
+            return out + sizeof(stored);
+        }
+    };
+
+    /**
+     @brief Binary logfile with per-thread buffers.
+     @details Every thread writes its records into its own buffer, the buffer
+     is written to the file when it is full, on flush() and when the thread
+     exits. A record consists of the call site id, the timestamp
+     (LogClock microseconds) and the encoded arguments.
+     Records are stored in the byte order of the host.
+     */
+    class RGPUTILS_EXPORT LogBinary {
+
+    public:
+        /**
+         @brief Opens a binary logfile and enables binary logging.
+         @details A previously opened file will be flushed and closed.
+         Records are appended to an existing file, every process starts a new
+         session in the file. Log::useBinaryLogfile() does the same.
+         @param filePath The path to the file.
+         @return True on success.
+         */
+        static bool open (const std::string &filePath);
+
+        /** Writes all buffers, closes the file and disables binary logging. */
+        static void close ();
+
+        /** Writes the buffers of all threads to the file. */
+        static void flush ();
+
+        /** Determines if binary logging is enabled. */
+        static bool enabled () {
+            return _enabled.load(std::memory_order_relaxed);
+        };
+
+        /**
+         @brief Writes a record to the buffer of the calling thread.
+         @details Use RGPLOG_BINARY() instead of calling this directly.
+         The call site gets registered on its first use.
+         @param callSite Storage of the call site id (0: not registered yet).
+         @param file Source file of the call site.
+         @param line Source line of the call site.
+         @param format The format string (see Log::info()).
+         @param args The arguments for the placeholders.
+         */
+        template <typename... Args>
+        static void write (std::atomic<uint32_t> &callSite, const char *file,
+                           const int line, const char *format,
+                           const Args &... args)
+        {
+            uint32_t id = callSite.load(std::memory_order_acquire);
+            if (RGPLOG_UNLIKELY(id == 0)) {
+                static const char types[] = {
+                    LogBinaryArgument<typename std::decay<Args>::type>::tag...,
+                    '\0'
+                };
+                id = registerCallSite(callSite, file, line, format, types);
+            }
+
+            const size_t length = kHeaderSize + encodedSize(args...);
+            char *out = reserve(length);
+            out = encodeHeader(out, id);
+            encode(out, args...);
+            commit(length);
+        };
+
+    private:
+        // call site id + timestamp
+        static const size_t kHeaderSize = sizeof(uint32_t) + sizeof(int64_t);
+
+        static std::atomic<bool> _enabled;
+
+        // assigns an id to the call site and writes it to the file
+        static uint32_t registerCallSite (std::atomic<uint32_t> &callSite,
+                                          const char *file, const int line,
+                                          const char *format,
+                                          const char *types);
+
+        // locks the buffer of the calling thread and returns room for length
+        // bytes, has to be followed by commit()
+        static char *reserve (const size_t length);
+
+        // marks the reserved bytes as used and unlocks the buffer
+        static void commit (const size_t length);
+
+        // writes id and timestamp
+        static char *encodeHeader (char *out, const uint32_t id);
+
+        static size_t encodedSize () { return 0; };
+
+        template <typename T, typename... Rest>
+        static size_t encodedSize (const T &value, const Rest &... rest) {
+            typedef typename std::decay<T>::type Type;
+            return LogBinaryArgument<Type>::size(value) + encodedSize(rest...);
+        };
+
+        static void encode (char *) {};
+
+        template <typename T, typename... Rest>
+        static void encode (char *out, const T &value, const Rest &... rest) {
+            typedef typename std::decay<T>::type Type;
+            encode(LogBinaryArgument<Type>::encode(out, value), rest...);
+        };
+    };
+}
+
+#endif // defined(__RGPUtils__LogBinary_H__) header guard
@@ -0,0 +1,197 @@
+/*
+ RGPUtils
+ LogCategory.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ Named loggers ("net", "db", ...) with a loglevel of their own.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogCategory_H__
+#define __RGPUtils__LogCategory_H__
+
+#include <rgp/Log.h>
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// typed versions for categories: RGPLOGC_INFO(net, "x={} y={}", x, y)
+// (the same compile-time check as RGPLOG_INFO)
+#if RGPLOG_COMPILE_LEVEL >= RGPLOG_LEVEL_NORMAL
+#define RGPLOGC_INFO(category, ...) do { \
+    RGPLOG_FORMAT_CHECK(__VA_ARGS__); \
+    if (RGPLOG_LIKELY((category).enabled(rgp::LoglevelNormal))) \
+        (category).info(__VA_ARGS__); \
+} while (0)
+#define RGPLOGC_WARN(category, ...) do { \
+    RGPLOG_FORMAT_CHECK(__VA_ARGS__); \
+    (category).warn(__VA_ARGS__); \
+} while (0)
+#else
+#define RGPLOGC_INFO(category, ...) ((void)0)
+#define RGPLOGC_WARN(category, ...) ((void)0)
+#endif // RGPLOG_COMPILE_LEVEL >= RGPLOG_LEVEL_NORMAL
+
+#if RGPLOG_COMPILE_LEVEL >= RGPLOG_LEVEL_VERBOSE
+#define RGPLOGC_VERBOSE(category, ...) do { \
+    RGPLOG_FORMAT_CHECK(__VA_ARGS__); \
+    if (RGPLOG_UNLIKELY((category).enabled(rgp::LoglevelVerbose))) \
+        (category).verbose(__VA_ARGS__); \
+} while (0)
+#else
+#define RGPLOGC_VERBOSE(category, ...) ((void)0)
+#endif // RGPLOG_COMPILE_LEVEL >= RGPLOG_LEVEL_VERBOSE
+
+namespace rgp {
+
+    /**
+     @brief A cheap handle of a named logger.
+     @details Categories are registered by name on first use and get a small
+     index. Their loglevel lives in a flat atomic array at that index, so
+     checking the level is a single relaxed load (no string lookup). A
+     category follows the global loglevel (Log::setLoglevel()) until it gets
+     a loglevel of its own. All categories write through the shared Log, the
+     category name is written in front of the text ("[net] ...").
+     Handles are small values and may be copied freely, f.e.:
+     @code
+     static const rgp::LogCategory net("net");
+     RGPLOGC_VERBOSE(net, "received {} bytes", count);
+     @endcode
+     */
+    class RGPUTILS_EXPORT LogCategory {
+
+    public:
+        /** The global category (index 0, no name). */
+        LogCategory () : _index(0) {};
+
+        /**
+         @brief The category with the given name (registered on first use).
+         @details If all kLogCategoryCount - 1 categories are in use the
+         handle refers to the global category.
+         @param name The name of the category.
+         */
+        explicit LogCategory (const std::string &name);
+
+        /** The name of the category (empty for the global category). */
+        const std::string &name () const;
+
+        /** The index of the category in the level table. */
+        uint16_t index () const { return _index; };
+
+        /**
+         @brief Sets the loglevel of the category.
+         @details Takes effect immediately for all handles of the category.
+         @param level The new loglevel.
+         @sa followGlobalLoglevel()
+         */
+        void setLoglevel (const Loglevel level) const;
+
+        /** The current loglevel of the category. */
+        Loglevel loglevel () const;
+
+        /** Drops the loglevel of the category, it follows the global
+         loglevel again. */
+        void followGlobalLoglevel () const;
+
+        /** Determines if output with the given loglevel would be used. */
+        bool enabled (const Loglevel level) const {
+            return Log::enabled(level, _index);
+        };
+
+        /** @copydoc Log::print(const std::string &, const AnsiSgrFgColor, const AnsiSgrBgColor) */
+        void print (const std::string &text,
+                    const AnsiSgrFgColor fgcolor = AnsiSgrFgColorDefault,
+                    const AnsiSgrBgColor bgcolor = AnsiSgrBgColorDefault) const {
+            if (enabled(LoglevelNormal)) {
+                Log::sharedLog()->submit(0, LoglevelNormal, text.data(),
+                                         text.size(), fgcolor, bgcolor, _index);
+            }
+        };
+
+        /** @copydoc Log::printv(const std::string &, const AnsiSgrFgColor, const AnsiSgrBgColor) */
+        void printv (const std::string &text,
+                     const AnsiSgrFgColor fgcolor = AnsiSgrFgColorDefault,
+                     const AnsiSgrBgColor bgcolor = AnsiSgrBgColorDefault) const {
+            if (RGPLOG_UNLIKELY(enabled(LoglevelVerbose))) {
+                Log::sharedLog()->submit(0, LoglevelVerbose, text.data(),
+                                         text.size(), fgcolor, bgcolor, _index);
+            }
+        };
+
+        /** @copydoc Log::info() */
+        template <typename... Args>
+        void info (const char *format, const Args &... args) const {
+            if (enabled(LoglevelNormal)) {
+                std::string &buffer = Log::formatBuffer();
+                logFormat(buffer, format, args...);
+                Log::sharedLog()->submit(0, LoglevelNormal, buffer.data(),
+                                         buffer.size(), AnsiSgrFgColorDefault,
+                                         AnsiSgrBgColorDefault, _index);
+            }
+        };
+
+        /** @copydoc Log::verbose() */
+        template <typename... Args>
+        void verbose (const char *format, const Args &... args) const {
+            if (RGPLOG_UNLIKELY(enabled(LoglevelVerbose))) {
+                std::string &buffer = Log::formatBuffer();
+                logFormat(buffer, format, args...);
+                Log::sharedLog()->submit(0, LoglevelVerbose, buffer.data(),
+                                         buffer.size(), AnsiSgrFgColorDefault,
+                                         AnsiSgrBgColorDefault, _index);
+            }
+        };
+
+        /** @copydoc Log::warn() */
+        template <typename... Args>
+        void warn (const char *format, const Args &... args) const {
+            std::string &buffer = Log::formatBuffer();
+            logFormat(buffer, format, args...);
+            Log::sharedLog()->submit(1, LoglevelNormal, buffer.data(),
+                                     buffer.size(), AnsiSgrFgColorDefault,
+                                     AnsiSgrBgColorDefault, _index);
+        };
+
+        /** @copydoc Log::error(const std::string &) */
+        void error (const std::string &text) const {
+            Log::sharedLog()->submit(1, LoglevelNormal, text.data(),
+                                     text.size(), AnsiSgrFgColorDefault,
+                                     AnsiSgrBgColorDefault, _index);
+        };
+
+        /** The names of all registered categories (index order, the global
+         category is not included). */
+        static std::vector<std::string> names ();
+
+        /**
+         @brief The name of a category by its index.
+         @details Lock-free, names never change after registration.
+         */
+        static const std::string &nameOf (const uint16_t index);
+
+    private:
+        uint16_t _index;
+    };
+}
+
+#endif // defined(__RGPUtils__LogCategory_H__) header guard
@@ -0,0 +1,100 @@
+/*
+ RGPUtils
+ LogCompressor.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ A small, self-contained LZ77 block compressor for rotated logfiles
+ (".rlz" files). rgplog_decode --decompress turns them back into text.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogCompressor_H__
+#define __RGPUtils__LogCompressor_H__
+
+#include <rgp/Log.h>
+
+#include <atomic>
+#include <iosfwd>
+#include <string>
+#include <cstddef>
+
+namespace rgp {
+
+    /**
+     @brief Compresses logfiles block by block.
+     @details File format: the magic "RLZ1", followed by blocks of at most
+     kBlockSize bytes. Every block starts with its raw and its compressed
+     size (32 bit little endian each). A block whose compressed size equals
+     the raw size is stored as is. The compressed data is a sequence of
+     literal runs and back references into the same block (LZ4 style
+     tokens, 16 bit offsets), so every block can be decoded on its own.
+     */
+    class RGPUTILS_EXPORT LogCompressor {
+
+    public:
+        /** Maximum raw size of a block. */
+        static const size_t kBlockSize = 1024 * 1024;
+
+        /**
+         @brief Compresses one block.
+         @param data The raw data (at most kBlockSize bytes).
+         @param length The length of the data.
+         @param out Receives the compressed data (replaced).
+         */
+        static void compressBlock (const char *data, const size_t length,
+                                   std::string &out);
+
+        /**
+         @brief Decompresses one block.
+         @param data The compressed data.
+         @param length The length of the compressed data.
+         @param rawLength The length of the raw data.
+         @param out The raw data gets appended.
+         @return False if the data is corrupt.
+         */
+        static bool decompressBlock (const char *data, const size_t length,
+                                     const size_t rawLength, std::string &out);
+
+        /**
+         @brief Compresses a file.
+         @details Writes to a temporary file next to target that is renamed
+         when it is complete, so target never holds a partial file.
+         @param source The path of the file to compress.
+         @param target The path of the compressed file.
+         @param cancel Stops the compression if it gets set (optional).
+         @return True on success.
+         */
+        static bool compressFile (const std::string &source,
+                                  const std::string &target,
+                                  const std::atomic<bool> *cancel = nullptr);
+
+        /**
+         @brief Decompresses a file into a stream.
+         @param source The path of the compressed file.
+         @param out Receives the raw data.
+         @return False if the file can't be read or is corrupt.
+         */
+        static bool decompressFile (const std::string &source, std::ostream &out);
+    };
+}
+
+#endif // defined(__RGPUtils__LogCompressor_H__) header guard
@@ -0,0 +1,216 @@
+/*
+ RGPUtils
+ LogFields.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ Typed key-value fields for log records: encoded as tagged bytes by the
+ logging thread, rendered as logfmt or JSON by the writer.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogFields_H__
+#define __RGPUtils__LogFields_H__
+
+#include <rgp/LogFormat.h>
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+namespace rgp {
+
+    /** The type tag of an encoded field. */
+    typedef enum : uint8_t {
+        LogFieldInt = 'i',
+        LogFieldUnsigned = 'u',
+        LogFieldDouble = 'd',
+        LogFieldBool = 'b',
+        LogFieldString = 's'
+    } LogFieldType;
+
+    /**
+     @brief A key and a typed value, f.e. LogField("status", 200).
+     @details Only lives for the log call: the key and string values are
+     referenced, not copied, until the field gets encoded. Keys are cut
+     to 255 bytes. Strings are binary-safe (they may contain any byte).
+     Encoded: type (1 byte), key length (1 byte), key, value (int64,
+     uint64, double: 8 bytes; bool: 1 byte; string: uint32 length and the
+     bytes), in host byte order.
+     */
+    class LogField {
+
+    public:
+        // signed integers and enums
+        template <typename T, typename std::enable_if<
+            (std::is_integral<T>::value && std::is_signed<T>::value &&
+             !std::is_same<T, char>::value) ||
+            std::is_enum<T>::value, int>::type = 0>
+        LogField (const char *key, const T value)
+            : _key(key), _type(LogFieldInt) { _value.i = (int64_t)value; };
+
+        // unsigned integers
+        template <typename T, typename std::enable_if<
+            std::is_integral<T>::value && std::is_unsigned<T>::value &&
+            !std::is_same<T, bool>::value, int>::type = 0>
+        LogField (const char *key, const T value)
+            : _key(key), _type(LogFieldUnsigned) { _value.u = (uint64_t)value; };
+
+        // floating point numbers
+        template <typename T, typename std::enable_if<
+            std::is_floating_point<T>::value, int>::type = 0>
+        LogField (const char *key, const T value)
+            : _key(key), _type(LogFieldDouble) { _value.d = (double)value; };
+
+        LogField (const char *key, const bool value)
+            : _key(key), _type(LogFieldBool) { _value.b = value; };
+
+        LogField (const char *key, const char value)
+            : _key(key), _type(LogFieldString), _character(value) {
+            setString(nullptr, 1);
+        };
+
+        LogField (const char *key, const char *value)
+            : _key(key), _type(LogFieldString) {
+            setString(value != nullptr ? value : "",
+                      value != nullptr ? strlen(value) : 0);
+        };
+
+        LogField (const char *key, const std::string &value)
+            : _key(key), _type(LogFieldString) {
+            setString(value.data(), value.size());
+        };
+
+        LogField (const char *key, const char *data, const size_t length)
+            : _key(key), _type(LogFieldString) { setString(data, length); };
+
+#if defined(RGPLOG_HAS_STRING_VIEW)
+        LogField (const char *key, const std::string_view value)
+            : _key(key), _type(LogFieldString) {
+            setString(value.data(), value.size());
+        };
+#endif // defined(RGPLOG_HAS_STRING_VIEW)
+
+        /** Appends the encoded field. */
+        void encode (std::string &out) const {
+            size_t keyLength = strlen(_key);
+            if (keyLength > 255) {
+                keyLength = 255;
+            }
+
+            char header[2] = { (char)_type, (char)keyLength };
+            out.append(header, sizeof(header));
+            out.append(_key, keyLength);
+
+            switch (_type) {
+                case LogFieldBool:
+                    out += _value.b ? '\1' : '\0';
+                    break;
+                case LogFieldString: {
+                    uint32_t length = (uint32_t)_value.s.length;
+                    out.append((const char *)&length, sizeof(length));
+                    // (nullptr: the char of the field)
+                    out.append(_value.s.data != nullptr ?
+                               _value.s.data : &_character, length);
+                    break;
+                }
+                default:
+                    // int64, uint64 and double share the 8 bytes
+                    out.append((const char *)&_value.u, sizeof(_value.u));
+                    break;
+            }
+        };
+
+    private:
+        void setString (const char *data, const size_t length) {
+            _value.s.data = data;
+            _value.s.length = length;
+        };
+
+        const char *_key;
+        LogFieldType _type;
+        union {
+            int64_t i;
+            uint64_t u;
+            double d;
+            bool b;
+            struct {
+                const char *data;
+                size_t length;
+            } s;
+        } _value;
+        char _character { 0 };
+    };
+
+    /** Appends the encoded fields. */
+    inline void logFieldsEncode (std::string &) {}
+
+    template <typename... Rest>
+    void logFieldsEncode (std::string &out, const LogField &field,
+                          const Rest &... rest) {
+        field.encode(out);
+        logFieldsEncode(out, rest...);
+    }
+
+    /**
+     @brief Renders encoded fields as logfmt pairs.
+     @details Every pair gets a leading space (" key=value"), keys and
+     strings are quoted if they are empty or contain spaces, quotes, "=",
+     control characters or invalid UTF-8. Keys of the record itself (ts,
+     level, category, thread, msg) get "fields." in front.
+     @param out Receives the pairs.
+     @param data The encoded fields.
+     @param length Length of the encoded fields.
+     */
+    RGPUTILS_EXPORT void logFieldsAppendLogfmt (std::string &out,
+                                                const char *data,
+                                                const size_t length);
+
+    /**
+     @brief Renders encoded fields as JSON members.
+     @details Every member gets a leading comma (",\"key\":value"), so
+     the fields can follow the members of the record itself. Keys of these
+     members (ts, level, category, thread, msg) get "fields." in front, so
+     there are no duplicate members. Doubles that aren't finite are written
+     as null.
+     @param out Receives the members.
+     @param data The encoded fields.
+     @param length Length of the encoded fields.
+     */
+    RGPUTILS_EXPORT void logFieldsAppendJson (std::string &out,
+                                              const char *data,
+                                              const size_t length);
+
+    /** Appends a JSON string (with the quotes), bytes that aren't valid
+     UTF-8 are escaped as \u00XX. */
+    RGPUTILS_EXPORT void logJsonAppendString (std::string &out,
+                                              const char *data,
+                                              const size_t length);
+
+    /** Appends a logfmt value (quoted if needed). */
+    RGPUTILS_EXPORT void logfmtAppendString (std::string &out,
+                                             const char *data,
+                                             const size_t length);
+}
+
+#endif // defined(__RGPUtils__LogFields_H__) header guard
@@ -0,0 +1,190 @@
+/*
+ RGPUtils
+ LogFormat.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ Allocation free "{}" formatting used by the typed Log methods
+ (Log::info(), Log::verbose() and Log::warn()).
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogFormat_H__
+#define __RGPUtils__LogFormat_H__
+
+#include <string>
+#include <cstddef>
+
+// std::string_view overloads are only available for C++17 and newer
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#define RGPLOG_HAS_STRING_VIEW 1
+#include <string_view>
+#endif
+
+// on windows we need the exports for creating the dll
+#if defined(_WIN32)
+  #if defined(RGPUTILS_EXPORTS)
+    #define RGPUTILS_EXPORT __declspec(dllexport)
+  #else
+    #define RGPUTILS_EXPORT __declspec(dllimport)
+  #endif /* defined (RGPUTILS_EXPORTS) */
+#else /* defined (_WIN32) */
+ #define RGPUTILS_EXPORT
+#endif
+
+// checks at compile time that a format string literal has as many "{}"
+// placeholders as arguments follow it, f.e.:
+// RGPLOG_FORMAT_CHECK("x={} y={}", x, y);
+#define RGPLOG_FORMAT_CHECK(...) \
+    static_assert(rgp::logFormatPlaceholders(RGPLOG_FORMAT_STRING(__VA_ARGS__)) \
+                  == sizeof(rgp::logFormatArgumentCounter(__VA_ARGS__)) - 2, \
+                  "number of {} placeholders doesn't match the arguments")
+
+// the first argument of a variadic macro (the format string)
+#define RGPLOG_FORMAT_STRING(...) RGPLOG_FORMAT_STRING_(__VA_ARGS__, 0)
+#define RGPLOG_FORMAT_STRING_(format, ...) format
+
+namespace rgp {
+
+    /**
+     @brief Counts the "{}" placeholders of a format string at compile time.
+     @details "{{" and "}}" are escaped braces and don't count.
+     @param format The format string.
+     @param count Placeholders found so far (used by the recursion).
+     @return The number of placeholders.
+     */
+    constexpr size_t logFormatPlaceholders (const char *format,
+                                            const size_t count = 0)
+    {
+        return format[0] == '\0' ? count :
+            (format[0] == '{' && format[1] == '{') ||
+            (format[0] == '}' && format[1] == '}') ?
+                logFormatPlaceholders(format + 2, count) :
+            format[0] == '{' && format[1] == '}' ?
+                logFormatPlaceholders(format + 2, count + 1) :
+            // skip plain text in larger steps to keep the recursion flat
+            format[1] != '\0' && format[1] != '{' && format[1] != '}' &&
+            format[2] != '\0' && format[2] != '{' && format[2] != '}' &&
+            format[3] != '\0' && format[3] != '{' && format[3] != '}' ?
+                logFormatPlaceholders(format + 3, count) :
+                logFormatPlaceholders(format + 1, count);
+    }
+
+    /** Used in unevaluated context to count macro arguments. */
+    template <typename... Args>
+    char (&logFormatArgumentCounter (const Args &...))[sizeof...(Args) + 1];
+
+    /**
+     @brief Copies the format string up to the next placeholder.
+     @details Escaped braces are unescaped.
+     @param out The text is appended to this string.
+     @param format The format string.
+     @return Pointer behind the placeholder or nullptr if the format string
+     ended without one.
+     */
+    RGPUTILS_EXPORT const char *logFormatLiteral (std::string &out,
+                                                  const char *format);
+
+    /** @name Appends a single value to the string. */
+    ///@{
+    RGPUTILS_EXPORT void logFormatValue (std::string &out, const int value);
+    RGPUTILS_EXPORT void logFormatValue (std::string &out, const unsigned int value);
+    RGPUTILS_EXPORT void logFormatValue (std::string &out, const long value);
+    RGPUTILS_EXPORT void logFormatValue (std::string &out, const unsigned long value);
+    RGPUTILS_EXPORT void logFormatValue (std::string &out, const long long value);
+    RGPUTILS_EXPORT void logFormatValue (std::string &out,
+                                         const unsigned long long value);
+    // doubles and floats are written with as many digits as it takes to
+    // read them back unchanged
+    RGPUTILS_EXPORT void logFormatValue (std::string &out, const double value);
+    RGPUTILS_EXPORT void logFormatValue (std::string &out, const float value);
+    RGPUTILS_EXPORT void logFormatValue (std::string &out, const char *value);
+    RGPUTILS_EXPORT void logFormatValue (std::string &out, const void *value);
+
+    inline void logFormatValue (std::string &out, const short value) {
+        logFormatValue(out, (int)value);
+    }
+    inline void logFormatValue (std::string &out, const unsigned short value) {
+        logFormatValue(out, (unsigned int)value);
+    }
+    inline void logFormatValue (std::string &out, const signed char value) {
+        logFormatValue(out, (int)value);
+    }
+    inline void logFormatValue (std::string &out, const unsigned char value) {
+        logFormatValue(out, (unsigned int)value);
+    }
+    inline void logFormatValue (std::string &out, const char value) {
+        out += value;
+    }
+    inline void logFormatValue (std::string &out, const bool value) {
+        if (value) out.append("true", 4); else out.append("false", 5);
+    }
+    inline void logFormatValue (std::string &out, char *value) {
+        logFormatValue(out, (const char *)value);
+    }
+    inline void logFormatValue (std::string &out, const std::string &value) {
+        out.append(value);
+    }
+#if defined(RGPLOG_HAS_STRING_VIEW)
+    inline void logFormatValue (std::string &out, const std::string_view value) {
+        out.append(value.data(), value.size());
+    }
+#endif // defined(RGPLOG_HAS_STRING_VIEW)
+    ///@}
+
+    /**
+     @brief Appends the rest of the format string (no arguments left).
+     @details Placeholders without an argument are kept as "{}".
+     */
+    inline void logFormat (std::string &out, const char *format)
+    {
+        while ((format = logFormatLiteral(out, format)) != nullptr) {
+            out.append("{}", 2);
+        }
+    }
+
+    /**
+     @brief Formats a "{}" format string with the given arguments.
+     @details Every "{}" is replaced by the next argument. Arguments without a
+     placeholder are ignored. Integers, floating point numbers, bool, char,
+     C strings, std::string, std::string_view (C++17) and pointers are
+     supported, other types will fail to compile.
+     @param out The text is appended to this string (its capacity is reused,
+     so a string that gets cleared between calls won't allocate).
+     @param format The format string.
+     @param value The argument for the next placeholder.
+     @param rest The arguments for the following placeholders.
+     */
+    template <typename T, typename... Rest>
+    void logFormat (std::string &out, const char *format, const T &value,
+                    const Rest &... rest)
+    {
+        format = logFormatLiteral(out, format);
+        if (format == nullptr) {
+            return;
+        }
+
+        logFormatValue(out, value);
+        logFormat(out, format, rest...);
+    }
+}
+
+#endif // defined(__RGPUtils__LogFormat_H__) header guard
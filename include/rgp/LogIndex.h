@@ -0,0 +1,142 @@
+/*
+ RGPUtils
+ LogIndex.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ A sparse side index of a text logfile: time range and levels of every
+ block of a few KB, so a reader can seek to a time window instead of
+ scanning the whole file (see rgplog_query).
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogIndex_H__
+#define __RGPUtils__LogIndex_H__
+
+#include <rgp/Log.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace rgp {
+
+    /** The levels of the records in a block (bit mask). */
+    typedef enum : uint8_t {
+        LogIndexLevelInfo = 1,
+        LogIndexLevelVerbose = 2,
+        LogIndexLevelError = 4
+    } LogIndexLevel;
+
+    /**
+     @brief A block of the logfile.
+     @details Stored as is (host byte order) after the 8 byte file header
+     "RGPLIDX1". Blocks start at the beginning of a record.
+     */
+    struct LogIndexEntry {
+        /** Offset of the block in the logfile. */
+        uint64_t offset;
+        /** Length of the block. */
+        uint32_t length;
+        /** LogIndexLevel bits of the records in the block. */
+        uint32_t levels;
+        /** Oldest and newest record in the block (microseconds since the
+         epoch, UTC). */
+        int64_t minTime;
+        int64_t maxTime;
+    };
+
+    /**
+     @brief Writes and reads the side index of a logfile ("<logfile>.idx").
+     @details The writer starts a new block at the first record after every
+     interval bytes and appends the entry of a block once the block is
+     complete, so the index costs one small write per block. Records after
+     the last entry (the open block, or the tail of a file that wasn't
+     closed) aren't indexed, readers have to scan them. The offsets are
+     only right as long as the logfile has a single writer.
+     */
+    class RGPUTILS_EXPORT LogIndex {
+
+    public:
+        LogIndex () {};
+        ~LogIndex () {};
+
+        /** The path of the index of a logfile. */
+        static std::string pathFor (const std::string &logfile);
+
+        /**
+         @brief Opens the index of a logfile for appending.
+         @details An index that doesn't match the logfile any more (it
+         covers more than the file holds, f.e. after the file was moved
+         away) is started over.
+         @param logfile The path of the logfile.
+         @param fileSize The current size of the logfile.
+         @param interval Minimum size of a block in bytes.
+         @return True on success.
+         */
+        bool open (const std::string &logfile, const uint64_t fileSize,
+                   const size_t interval);
+
+        /**
+         @brief Writes the entry of the open block and closes the index.
+         @param end Offset of the end of the logfile.
+         */
+        void close (const uint64_t end);
+
+        /** Determines if there is an open index. */
+        bool isOpen () const { return _file.is_open(); };
+
+        /**
+         @brief Adds a record to the index.
+         @param offset Offset of the record in the logfile.
+         @param timestamp Time of the record (LogClock microseconds).
+         @param levels LogIndexLevel bit of the record.
+         */
+        void record (const uint64_t offset, const int64_t timestamp,
+                     const uint8_t levels);
+
+        /**
+         @brief Reads the entries of the index of a logfile.
+         @param logfile The path of the logfile.
+         @param entries Receives the entries.
+         @return False if there is no valid index.
+         */
+        static bool read (const std::string &logfile,
+                          std::vector<LogIndexEntry> &entries);
+
+    private:
+        LogIndex (const LogIndex &) = delete;
+        LogIndex &operator = (const LogIndex &) = delete;
+
+        void append (const LogIndexEntry &entry);
+
+        std::ofstream _file;
+        size_t _interval { 0 };
+
+        // the block that is being written
+        LogIndexEntry _block;
+        bool _hasBlock { false };
+    };
+}
+
+#endif // defined(__RGPUtils__LogIndex_H__) header guard
@@ -0,0 +1,221 @@
+/*
+ RGPUtils
+ LogLimit.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ Rate limits and sampling for single log statements, so a hot error path
+ can't turn the log into the bottleneck.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogLimit_H__
+#define __RGPUtils__LogLimit_H__
+
+#include <rgp/Log.h>
+
+#include <atomic>
+#include <cstdint>
+
+// Every expansion owns a limiter in a static local (constant initialized,
+// no lookup, no guard). The arguments are only evaluated if the limiter
+// lets the call through, f.e.:
+// RGPLOG_WARN_LIMIT(10, 5, "read failed: {}", code);  (10 per second, bursts of 5)
+// RGPLOG_INFO_SAMPLE(1000, "request {} done", id);     (every 1000th call)
+#if RGPLOG_COMPILE_LEVEL >= RGPLOG_LEVEL_NORMAL
+#define RGPLOG_INFO_LIMIT(perSecond, burst, ...) do { \
+    RGPLOG_FORMAT_CHECK(__VA_ARGS__); \
+    static rgp::LogRateLimiter rgplogLimit_(perSecond, burst, __FILE__, __LINE__); \
+    if (RGPLOG_LIKELY(rgp::Log::enabled(rgp::LoglevelNormal)) && \
+        rgplogLimit_.allow()) \
+        rgp::Log::sharedLog()->info(__VA_ARGS__); \
+} while (0)
+#define RGPLOG_WARN_LIMIT(perSecond, burst, ...) do { \
+    RGPLOG_FORMAT_CHECK(__VA_ARGS__); \
+    static rgp::LogRateLimiter rgplogLimit_(perSecond, burst, __FILE__, __LINE__); \
+    if (rgplogLimit_.allow()) \
+        rgp::Log::sharedLog()->warn(__VA_ARGS__); \
+} while (0)
+#define RGPLOG_ERROR_LIMIT(perSecond, burst, xx) do { \
+    static rgp::LogRateLimiter rgplogLimit_(perSecond, burst, __FILE__, __LINE__); \
+    if (rgplogLimit_.allow()) \
+        rgp::Log::sharedLog()->error(xx); \
+} while (0)
+#define RGPLOG_INFO_SAMPLE(n, ...) do { \
+    RGPLOG_FORMAT_CHECK(__VA_ARGS__); \
+    static rgp::LogSampler rgplogSample_(n, __FILE__, __LINE__); \
+    if (RGPLOG_LIKELY(rgp::Log::enabled(rgp::LoglevelNormal)) && \
+        rgplogSample_.allow()) \
+        rgp::Log::sharedLog()->info(__VA_ARGS__); \
+} while (0)
+#define RGPLOG_WARN_SAMPLE(n, ...) do { \
+    RGPLOG_FORMAT_CHECK(__VA_ARGS__); \
+    static rgp::LogSampler rgplogSample_(n, __FILE__, __LINE__); \
+    if (rgplogSample_.allow()) \
+        rgp::Log::sharedLog()->warn(__VA_ARGS__); \
+} while (0)
+#define RGPLOG_ERROR_SAMPLE(n, xx) do { \
+    static rgp::LogSampler rgplogSample_(n, __FILE__, __LINE__); \
+    if (rgplogSample_.allow()) \
+        rgp::Log::sharedLog()->error(xx); \
+} while (0)
+#else
+#define RGPLOG_INFO_LIMIT(perSecond, burst, ...) ((void)0)
+#define RGPLOG_WARN_LIMIT(perSecond, burst, ...) ((void)0)
+#define RGPLOG_ERROR_LIMIT(perSecond, burst, xx) ((void)0)
+#define RGPLOG_INFO_SAMPLE(n, ...) ((void)0)
+#define RGPLOG_WARN_SAMPLE(n, ...) ((void)0)
+#define RGPLOG_ERROR_SAMPLE(n, xx) ((void)0)
+#endif // RGPLOG_COMPILE_LEVEL >= RGPLOG_LEVEL_NORMAL
+
+namespace rgp {
+
+    /**
+     @brief The part of a call site limit that counts suppressed calls.
+     @details A limit that suppressed calls registers itself once in a global
+     list. The Log writes one summary line per call site and interval
+     ("file.cpp:42: suppressed 12345 similar messages", see
+     Log::setSuppressionReportInterval()), so the output stays bounded no
+     matter how often the call site fires. Limits must live as long as the
+     program (static locals), they are never removed from the list.
+     */
+    class RGPUTILS_EXPORT LogCallSiteLimit {
+
+    public:
+        /** The file of the call site. */
+        const char *file () const { return _file; };
+
+        /** The line of the call site. */
+        int line () const { return _line; };
+
+        /** Calls suppressed since the last summary. */
+        uint64_t suppressed () const {
+            return _suppressed.load(std::memory_order_relaxed);
+        };
+
+        /** Returns and resets the number of suppressed calls. */
+        uint64_t takeSuppressed () {
+            return _suppressed.exchange(0, std::memory_order_relaxed);
+        };
+
+        /** The first limit that ever suppressed a call (nullptr if none). */
+        static LogCallSiteLimit *first ();
+
+        /** The next limit in the list. */
+        LogCallSiteLimit *next () const {
+            return _next.load(std::memory_order_acquire);
+        };
+
+    protected:
+        constexpr LogCallSiteLimit (const char *file, const int line)
+            : _file(file), _line(line), _suppressed(0), _registered(false),
+              _next(nullptr) {};
+
+        // counts a suppressed call
+        void suppress () {
+            _suppressed.fetch_add(1, std::memory_order_relaxed);
+            if (RGPLOG_UNLIKELY(!_registered.load(std::memory_order_relaxed))) {
+                enlist();
+            }
+        };
+
+        // a call got through (writes due summaries in synchronous mode)
+        static void passed (const int64_t now);
+
+    private:
+        LogCallSiteLimit (const LogCallSiteLimit &) = delete;
+        LogCallSiteLimit &operator = (const LogCallSiteLimit &) = delete;
+
+        // adds the limit to the global list
+        void enlist ();
+
+        const char *_file;
+        const int _line;
+        std::atomic<uint64_t> _suppressed;
+        std::atomic<bool> _registered;
+        std::atomic<LogCallSiteLimit *> _next;
+    };
+
+    /**
+     @brief A token bucket for one call site.
+     @details Lets perSecond calls per second through on average and up to
+     burst calls at once. The bucket is a single atomic (the theoretical
+     arrival time of the next call, GCRA), read with a coarse clock; a
+     suppressed call costs a clock read, a load and a counter increment.
+     */
+    class RGPUTILS_EXPORT LogRateLimiter : public LogCallSiteLimit {
+
+    public:
+        /**
+         @brief Creates the bucket (full).
+         @param perSecond Calls per second (0 suppresses all calls).
+         @param burst Calls that may pass at once (at least 1).
+         @param file The file of the call site (for the summary).
+         @param line The line of the call site (for the summary).
+         */
+        constexpr LogRateLimiter (const uint32_t perSecond, const uint32_t burst,
+                                  const char *file = "", const int line = 0)
+            : LogCallSiteLimit(file, line),
+              _interval(perSecond > 0 ? 1000000 / (int64_t)perSecond : 0),
+              _tolerance(perSecond == 0 ? -1 :
+                         (1000000 / (int64_t)perSecond) *
+                         (burst > 1 ? (int64_t)burst - 1 : 0)),
+              _arrival(0) {};
+
+        /** Determines if the call may log (takes a token). */
+        bool allow ();
+
+    private:
+        // microseconds per token, burst as time
+        const int64_t _interval;
+        const int64_t _tolerance;
+
+        // when the bucket is full again (LogClock::coarse())
+        std::atomic<int64_t> _arrival;
+    };
+
+    /**
+     @brief Lets every n-th call of a call site through (the first one
+     included).
+     */
+    class RGPUTILS_EXPORT LogSampler : public LogCallSiteLimit {
+
+    public:
+        /**
+         @brief Creates the sampler.
+         @param n One of n calls may log (0 and 1: all).
+         @param file The file of the call site (for the summary).
+         @param line The line of the call site (for the summary).
+         */
+        constexpr LogSampler (const uint32_t n, const char *file = "",
+                              const int line = 0)
+            : LogCallSiteLimit(file, line), _n(n > 1 ? n : 1), _count(0) {};
+
+        /** Determines if the call may log. */
+        bool allow ();
+
+    private:
+        const uint64_t _n;
+        std::atomic<uint64_t> _count;
+    };
+}
+
+#endif // defined(__RGPUtils__LogLimit_H__) header guard
@@ -0,0 +1,123 @@
+/*
+ RGPUtils
+ LogMetrics.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ Snapshot of the self-instrumentation of the Log class
+ (see Log::setMetrics() and Log::metrics()).
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogMetrics_H__
+#define __RGPUtils__LogMetrics_H__
+
+#include <rgp/Log.h>
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace rgp {
+
+    /**
+     @brief A histogram of durations in nanoseconds.
+     @details The buckets are logarithmic with 8 linear sub-buckets per power
+     of two (like a HDR histogram with 3 significant bits), so every value is
+     known with a relative error below 12.5%. Values below 8 ns have their own
+     bucket, values above 2^42 ns land in the last bucket.
+     */
+    struct RGPUTILS_EXPORT LogHistogram {
+
+        /** Number of buckets. */
+        static const size_t kBucketCount = 320;
+
+        /** Counts per bucket. */
+        uint64_t buckets[kBucketCount];
+
+        /** Number of recorded values. */
+        uint64_t count;
+
+        /** Sum of all recorded values. */
+        uint64_t sum;
+
+        /** Largest recorded value. */
+        uint64_t max;
+
+        /** The bucket a value is counted in. */
+        static size_t bucketIndex (const uint64_t value);
+
+        /** The smallest value that is counted in the bucket. */
+        static uint64_t bucketLowerBound (const size_t index);
+
+        /**
+         @brief The value below which the given share of values lies.
+         @param percentile The share in percent (f.e. 99.9).
+         @return The upper bound of the bucket that contains the percentile
+         (0 if nothing was recorded).
+         */
+        uint64_t percentile (const double percentile) const;
+
+        /** The average of all values (0 if nothing was recorded). */
+        uint64_t mean () const;
+    };
+
+    /** Records and bytes a sink consumed. */
+    struct LogSinkMetrics {
+        /** The sink. */
+        std::shared_ptr<LogSink> sink;
+        /** Number of records the sink consumed. */
+        uint64_t messages;
+        /** Number of bytes of the formatted lines the sink consumed. */
+        uint64_t bytes;
+    };
+
+    /**
+     @brief Snapshot of the counters of the Log class.
+     @details All counters are cumulative since metrics were enabled the
+     first time.
+     */
+    struct LogMetrics {
+        /** Log calls of the output stream per loglevel (index: Loglevel). */
+        uint64_t messages[3];
+        /** Text bytes of the output stream per loglevel (index: Loglevel). */
+        uint64_t bytes[3];
+        /** Log calls of the error stream. */
+        uint64_t errorMessages;
+        /** Text bytes of the error stream. */
+        uint64_t errorBytes;
+        /** Records and bytes per sink (see Log::addSink()). */
+        std::vector<LogSinkMetrics> sinks;
+        /** Most records that waited in the queues at once (sampled by the
+         writer every time it starts to drain the queues). */
+        uint64_t queueHighWaterMark;
+        /** Time spent in the log calls (the enqueue in asynchronous mode,
+         the write in synchronous mode). */
+        LogHistogram enqueueLatency;
+        /** Time needed to write a file buffer to its file. */
+        LogHistogram flushLatency;
+        /** Dropped, overwritten, spilled records and blocked log calls. */
+        LogOverflowStatistics overflow;
+    };
+}
+
+#endif // defined(__RGPUtils__LogMetrics_H__) header guard
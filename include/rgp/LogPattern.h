@@ -0,0 +1,151 @@
+/*
+ RGPUtils
+ LogPattern.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ Configurable line layouts like "%Y-%m-%dT%H:%M:%S.%f %l [%t] %n: %v".
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogPattern_H__
+#define __RGPUtils__LogPattern_H__
+
+#include <rgp/Log.h>
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// checks a pattern literal at compile time, f.e.:
+// RGPLOG_PATTERN_CHECK("%H:%M:%S %l %v");
+#define RGPLOG_PATTERN_CHECK(pattern) \
+    static_assert(rgp::logPatternValid(pattern), \
+                  "unknown % specifier in the log pattern")
+
+namespace rgp {
+
+    class LogSinkRecord;
+
+    /** Determines if c may follow a '%' in a pattern. */
+    constexpr bool logPatternSpecifier (const char c)
+    {
+        return c == 'Y' || c == 'm' || c == 'd' || c == 'H' || c == 'M' ||
+            c == 'S' || c == 'f' || c == 'e' || c == 'l' || c == 'L' ||
+            c == 't' || c == 'n' || c == 'v' || c == '^' || c == '$' ||
+            c == '%';
+    }
+
+    /**
+     @brief Checks a pattern at compile time.
+     @param pattern The pattern.
+     @return False if a '%' is followed by an unknown specifier.
+     */
+    constexpr bool logPatternValid (const char *pattern)
+    {
+        return pattern[0] == '\0' ? true :
+            pattern[0] == '%' ?
+                logPatternSpecifier(pattern[1]) && logPatternValid(pattern + 2) :
+                logPatternValid(pattern + 1);
+    }
+
+    /**
+     @brief A line layout that is parsed once.
+     @details The pattern is turned into a flat list of operations when the
+     object is created, formatting a record is a single loop over them
+     (copies and integer conversions only). Specifiers:
+     - %Y %m %d %H %M %S: year, month, day, hour, minute, second (local time)
+     - %f: microseconds (6 digits), %e: milliseconds (3 digits)
+     - %l: level ("ERROR", "INFO", "VERBOSE"), %L: its first letter
+     - %t: number of the logging thread (1 for the first thread that logged)
+     - %n: name of the LogCategory (empty for the global category)
+     - %v: the text
+     - %^ ... %$: the colors of the record (ANSI SGR codes, only if it has
+       other than the default colors)
+     - %%: a '%'
+     Every line ends with "\n". Unknown specifiers are copied as they are
+     (see valid() and RGPLOG_PATTERN_CHECK()).
+     */
+    class RGPUTILS_EXPORT LogPattern {
+
+    public:
+        /**
+         @brief Parses the pattern.
+         @param pattern The pattern.
+         */
+        explicit LogPattern (const std::string &pattern);
+
+        /** The pattern the object was created with. */
+        const std::string &pattern () const { return _pattern; };
+
+        /** False if the pattern contains unknown specifiers. */
+        bool valid () const { return _valid; };
+
+        /**
+         @brief Formats a record.
+         @param record The record.
+         @param out The line is appended to this string.
+         */
+        void format (const LogSinkRecord &record, std::string &out) const;
+
+    private:
+        typedef enum : uint8_t {
+            OpLiteral = 0,
+            // a part of the timestamp of LogClock::format()
+            OpTime,
+            OpLevel,
+            OpLevelLetter,
+            OpThread,
+            OpCategory,
+            OpText,
+            OpColorStart,
+            OpColorEnd
+        } OpCode;
+
+        struct Op {
+            OpCode code;
+            // OpLiteral: position in _literals, OpTime: in the timestamp
+            uint16_t offset;
+            uint16_t length;
+        };
+
+        // appends an op, merges it into the previous one if possible
+        void add (const OpCode code, const uint16_t offset,
+                  const uint16_t length);
+
+        // appends a literal character
+        void addLiteral (const char c);
+
+        std::string _pattern;
+        std::string _literals;
+        std::vector<Op> _ops;
+        bool _valid { true };
+        bool _usesTime { false };
+
+        // longest line without the text and the category name, number of
+        // %v and %n (the output is sized once per record)
+        size_t _fixedLength { 0 };
+        size_t _textCount { 0 };
+        size_t _categoryCount { 0 };
+    };
+}
+
+#endif // defined(__RGPUtils__LogPattern_H__) header guard
@@ -0,0 +1,604 @@
+/*
+ RGPUtils
+ LogSink.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ Destinations for log records. Every record is formatted once per layout,
+ all sinks that use the same layout share the formatted line.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogSink_H__
+#define __RGPUtils__LogSink_H__
+
+#include <rgp/Log.h>
+
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace rgp {
+
+    class LogFile;
+    class LogBatchFile;
+    class LogHeldOutput;
+    class LogPattern;
+
+    /** Describes how a record is turned into a line of text. */
+    typedef enum : uint8_t {
+        /** Only the text: "message" */
+        LogLayoutMessage = 0,
+        /** Time and text: "2026-10-18T09:15:02.123456 message" */
+        LogLayoutTimestamped,
+        /** Time, level and text: "2026-10-18T09:15:02.123456 ERROR message"
+         (ERROR, INFO or VERBOSE) */
+        LogLayoutDetailed,
+        /** logfmt: "ts=2026-10-18T09:15:02.123456 level=info category=net
+         thread=3 msg="message" key=value" (category and thread only if
+         known) */
+        LogLayoutLogfmt,
+        /** JSON lines: {"ts":"2026-10-18T09:15:02.123456","level":"info",
+         "category":"net","thread":3,"msg":"message","key":value} */
+        LogLayoutJson
+    } LogLayout;
+
+    /** Number of layouts. */
+    static const size_t kLogLayoutCount = 5;
+
+    /** Streams a sink accepts records from (bit mask). */
+    typedef enum : uint8_t {
+        /** print(), printv(), info() ... */
+        LogSinkStreamOutput = 1,
+        /** error(), errorWithErrno() and warn() */
+        LogSinkStreamError = 2,
+        /** both streams */
+        LogSinkStreamAll = 3
+    } LogSinkStream;
+
+    /** How a LogBatchFileSink hands its chunks to the kernel. */
+    typedef enum : uint8_t {
+        /** io_uring if available, writev otherwise */
+        LogBatchBackendAuto = 0,
+        /** one writev() for all collected chunks */
+        LogBatchBackendWritev,
+        /** several chunk writes in flight (Linux only, falls back to writev) */
+        LogBatchBackendIoUring
+    } LogBatchBackend;
+
+    /**
+     @brief A record on its way to the sinks.
+     @details The text is formatted on the first request of a layout, every
+     following request of the same layout returns the same buffer. The
+     record is only valid during LogSink::write().
+     */
+    class RGPUTILS_EXPORT LogSinkRecord {
+
+    public:
+        /**
+         @brief Sets a new record and forgets the formatted lines (their
+         buffers keep their capacity).
+         @details category is the name of the LogCategory (nullptr for the
+         global category), it is written as "[name] " in front of the text.
+         thread is the number of the logging thread (see LogPattern).
+         The last fields bytes of the text are the encoded fields of the
+         record (see LogField).
+         */
+        void reset (const int64_t timestamp, const bool error,
+                    const Loglevel level, const AnsiSgrFgColor fgcolor,
+                    const AnsiSgrBgColor bgcolor, const char *text,
+                    const size_t length, const char *category = nullptr,
+                    const uint32_t thread = 0, const size_t fields = 0);
+
+        /** Time of the log call (microseconds since the epoch). */
+        int64_t timestamp () const { return _timestamp; };
+
+        /** True for records of the error stream. */
+        bool error () const { return _error; };
+
+        /** The loglevel the record was logged with. */
+        Loglevel level () const { return _level; };
+
+        /** Foreground color (only used on terminals). */
+        AnsiSgrFgColor fgcolor () const { return _fgcolor; };
+
+        /** Background color (only used on terminals). */
+        AnsiSgrBgColor bgcolor () const { return _bgcolor; };
+
+        /** The logged text (not terminated). */
+        const char *text () const { return _text; };
+
+        /** Length of the logged text. */
+        size_t length () const { return _length; };
+
+        /** Name of the category (nullptr for the global category). */
+        const char *category () const { return _category; };
+
+        /** Number of the logging thread (0 if unknown). */
+        uint32_t thread () const { return _thread; };
+
+        /** The encoded fields (see LogField). */
+        const char *fields () const { return _fields; };
+
+        /** Length of the encoded fields (0: the record has none). */
+        size_t fieldsLength () const { return _fieldsLength; };
+
+        /**
+         @brief The fields as logfmt pairs (" key=value ...").
+         @details Rendered on the first request. The text layouts and
+         patterns write them behind the text.
+         @return The pairs, empty if the record has no fields.
+         */
+        const std::string &fieldsText () const;
+
+        /**
+         @brief The record formatted with the given layout.
+         @param layout The layout.
+         @return The line, terminated with "\n".
+         */
+        const std::string &line (const LogLayout layout) const;
+
+        /**
+         @brief The record formatted with the given pattern.
+         @details The line of the last pattern is kept, sinks that share a
+         pattern object share the line.
+         @param pattern The pattern.
+         @return The line, terminated with "\n".
+         */
+        const std::string &line (const LogPattern &pattern) const;
+
+    private:
+        int64_t _timestamp { 0 };
+        bool _error { false };
+        Loglevel _level { LoglevelNormal };
+        AnsiSgrFgColor _fgcolor { AnsiSgrFgColorDefault };
+        AnsiSgrBgColor _bgcolor { AnsiSgrBgColorDefault };
+        const char *_text { nullptr };
+        size_t _length { 0 };
+        const char *_category { nullptr };
+        uint32_t _thread { 0 };
+        const char *_fields { nullptr };
+        size_t _fieldsLength { 0 };
+
+        // the logfmt pairs of the fields
+        mutable std::string _fieldsText;
+        mutable bool _fieldsFormatted { false };
+
+        // the structured layouts
+        void formatLogfmt (std::string &line) const;
+        void formatJson (std::string &line) const;
+
+        mutable std::string _lines[kLogLayoutCount];
+        mutable bool _formatted[kLogLayoutCount] {};
+
+        // the pattern _patternLine was formatted with
+        mutable const LogPattern *_pattern { nullptr };
+        mutable std::string _patternLine;
+    };
+
+    /**
+     @brief Base class of all log destinations.
+     @details Sinks are added with Log::addSink(). A sink only receives the
+     records of its streams up to its loglevel (the Log itself has to let
+     them through, see Log::setLoglevel()). write() is called with the mutex
+     of the sink locked, so sinks don't have to be thread-safe on their own
+     (unless they are created as unserialized sinks).
+     */
+    class RGPUTILS_EXPORT LogSink {
+
+    public:
+        /**
+         @brief Creates a sink.
+         @param layout How the records are formatted for this sink.
+         */
+        explicit LogSink (const LogLayout layout);
+
+        virtual ~LogSink ();
+
+        /** The layout of the sink. */
+        LogLayout layout () const { return _layout; };
+
+        /**
+         @brief Formats the records with a pattern instead of the layout.
+         @details Has to be set before the sink is added to the Log. Sinks
+         that share the pattern object format every record only once.
+         @param pattern The pattern, nullptr returns to the layout.
+         */
+        void setPattern (const std::shared_ptr<const LogPattern> &pattern);
+
+        /** The pattern of the sink (nullptr if the layout is used). */
+        const std::shared_ptr<const LogPattern> &pattern () const {
+            return _pattern;
+        };
+
+        /** The record formatted the way this sink wants it (pattern or
+         layout). */
+        const std::string &line (const LogSinkRecord &record) const;
+
+        /**
+         @brief Sets the most detailed loglevel the sink accepts.
+         @details Default: LoglevelVerbose (everything the Log outputs).
+         @param level The loglevel.
+         */
+        void setLoglevel (const Loglevel level);
+
+        /** The most detailed loglevel the sink accepts. */
+        Loglevel loglevel () const;
+
+        /**
+         @brief Sets the streams the sink accepts.
+         @details Default: LogSinkStreamAll.
+         @param streams Combination of LogSinkStream values.
+         */
+        void setStreams (const uint8_t streams);
+
+        /** The streams the sink accepts. */
+        uint8_t streams () const;
+
+        /** Determines if the sink accepts the record (level and stream). */
+        bool accepts (const LogSinkRecord &record) const;
+
+        /** Locks the sink and writes the record. */
+        void consume (const LogSinkRecord &record);
+
+        /** Locks the sink and writes its buffers. */
+        void flush ();
+
+        /** Locks the sink and writes its buffers if they are due. */
+        void flushIfDue ();
+
+        /**
+         @brief Locks the sink and finishes its output.
+         @details Called by Log::shutdown() and Log::removeSink(). Sinks that
+         write to preallocated space cut it to the written length, records
+         after that may be dropped.
+         */
+        void close ();
+
+        /**
+         @brief Locks the sink and holds its console output back or writes
+         what was held.
+         @details Driven by Log::getline() and Log::getc() for the sinks
+         that were added when the prompt started.
+         @param hold True while a prompt waits for input.
+         */
+        void holdConsoleOutput (const bool hold);
+
+        /** Number of records the sink consumed. */
+        uint64_t messages () const;
+
+        /** Number of bytes of the formatted lines the sink consumed (only
+         counted while metrics are enabled, see Log::setMetrics()). */
+        uint64_t bytes () const;
+
+    protected:
+        /**
+         @brief Creates a sink that may skip the mutex.
+         @param layout How the records are formatted for this sink.
+         @param serialized False: write() gets called without the mutex (it
+         has to be thread-safe itself), the flush methods still lock it.
+         */
+        LogSink (const LogLayout layout, const bool serialized);
+
+        /** Writes a record (the mutex is locked). */
+        virtual void write (const LogSinkRecord &record) = 0;
+
+        /** Writes buffered data (the mutex is locked). */
+        virtual void flushBuffers () {};
+
+        /** Writes buffered data if it waited too long (the mutex is locked). */
+        virtual void flushBuffersIfDue () {};
+
+        /** Finishes the output (the mutex is locked). */
+        virtual void closeOutput () {};
+
+        /** Holds output to std::cout / std::cerr back or writes it (the
+         mutex is locked, only console sinks have to implement it). */
+        virtual void setConsoleOutputHeld (const bool) {};
+
+        /** Serializes all calls of write() and the flush methods. */
+        mutable std::mutex _mutex;
+
+    private:
+        LogSink (const LogSink &) = delete;
+        LogSink &operator = (const LogSink &) = delete;
+
+        const LogLayout _layout;
+        std::shared_ptr<const LogPattern> _pattern;
+        const bool _serialized { true };
+        std::atomic<Loglevel> _loglevel { LoglevelVerbose };
+        std::atomic<uint8_t> _streams { LogSinkStreamAll };
+
+        // counters (only changed with the mutex locked if serialized)
+        std::atomic<uint64_t> _messages { 0 };
+        std::atomic<uint64_t> _bytes { 0 };
+    };
+
+    /**
+     @brief Writes records to a file.
+     @details The file stays open and is written through a buffer (like the
+     logfile of the Log class).
+     */
+    class RGPUTILS_EXPORT LogFileSink : public LogSink {
+
+    public:
+        /**
+         @brief Opens the file for appending.
+         @param filePath The path to the file.
+         @param layout How the records are formatted.
+         */
+        explicit LogFileSink (const std::string &filePath,
+                              const LogLayout layout = LogLayoutTimestamped);
+
+        virtual ~LogFileSink ();
+
+        /** Determines if the file could be opened. */
+        bool isOpen () const;
+
+        /**
+         @brief Reopens the file before the next write.
+         @details Safe to call from a signal handler.
+         */
+        void reopen ();
+
+    protected:
+        virtual void write (const LogSinkRecord &record) override;
+        virtual void flushBuffers () override;
+        virtual void flushBuffersIfDue () override;
+
+    private:
+        std::unique_ptr<LogFile> _file;
+    };
+
+    /**
+     @brief Writes records to a file in large batches.
+     @details For high volumes: the lines are collected in chunks and many
+     chunks are written per system call. With io_uring (Linux) full chunks
+     are written in the background while the writer thread fills the next
+     ones. Lines stay in memory till the ring of chunks is full, the flush
+     interval has passed (checked when the log queue runs empty) or flush()
+     is called.
+     io_uring writes at offsets the sink computes itself (not O_APPEND), so
+     the sink has to be the only writer of the file: other logfiles of this
+     library that have the file open make it fall back to writev, other
+     processes appending to it (or truncating it) must not be used with
+     LogBatchBackendIoUring / LogBatchBackendAuto.
+     */
+    class RGPUTILS_EXPORT LogBatchFileSink : public LogSink {
+
+    public:
+        /**
+         @brief Opens the file for appending (io_uring: writes after the
+         current end, see above).
+         @param filePath The path to the file.
+         @param layout How the records are formatted.
+         @param chunkSize Size of one chunk (default: 1 MiB).
+         @param chunkCount Number of chunks (default: 8, at least 2).
+         @param backend How the chunks are written.
+         */
+        explicit LogBatchFileSink (const std::string &filePath,
+                                   const LogLayout layout = LogLayoutTimestamped,
+                                   const size_t chunkSize = 1024 * 1024,
+                                   const size_t chunkCount = 8,
+                                   const LogBatchBackend backend = LogBatchBackendAuto);
+
+        virtual ~LogBatchFileSink ();
+
+        /** Determines if the file could be opened. */
+        bool isOpen () const;
+
+        /** The backend in use (LogBatchBackendWritev or
+         LogBatchBackendIoUring). */
+        LogBatchBackend backend () const;
+
+        /**
+         @brief Sets the maximum time lines may stay in memory.
+         @details Default: 1000 ms.
+         @param milliseconds The interval.
+         */
+        void setFlushInterval (const unsigned int milliseconds);
+
+    protected:
+        virtual void write (const LogSinkRecord &record) override;
+        virtual void flushBuffers () override;
+        virtual void flushBuffersIfDue () override;
+
+    private:
+        std::unique_ptr<LogBatchFile> _file;
+    };
+
+    /**
+     @brief Writes records into memory-mapped, preallocated segment files.
+     @details The segments are named "<filePath>.<n>" (existing files are
+     skipped) and get their full size when they are created (fallocate), so
+     writing a record is an atomic reservation and a copy, no system call.
+     write() doesn't take the mutex of the sink, but the Log delivers the
+     records of a stream one after another (stream mutex or writer thread),
+     so only the output and the error stream (and direct consume() calls)
+     reserve concurrently. The thread whose record doesn't fit anymore rolls
+     to the next segment, the full one is cut to the length of its data. The
+     last segment is cut by close() (Log::shutdown() at exit,
+     Log::removeSink()) or on destruction, records after close() are
+     dropped. Only available on Unix systems.
+     */
+    class RGPUTILS_EXPORT LogMappedFileSink : public LogSink {
+
+    public:
+        /**
+         @brief Creates the first segment.
+         @param filePath The path of the segments (without the number).
+         @param layout How the records are formatted.
+         @param segmentSize Size of every segment (default: 64 MiB).
+         */
+        explicit LogMappedFileSink (const std::string &filePath,
+                                    const LogLayout layout = LogLayoutTimestamped,
+                                    const size_t segmentSize = 64 * 1024 * 1024);
+
+        virtual ~LogMappedFileSink ();
+
+        /** Determines if there is a segment to write to. */
+        bool isOpen () const;
+
+        /** Number of segments created so far. */
+        uint64_t segments () const;
+
+        /** Records that could not be written (larger than a segment, or no
+         segment could be created). */
+        uint64_t dropped () const;
+
+    protected:
+        virtual void write (const LogSinkRecord &record) override;
+        virtual void closeOutput () override;
+
+    private:
+        struct Segment;
+
+        // creates and maps the next segment, nullptr on failure
+        Segment *openSegment ();
+
+        // unmaps a segment and cuts it to length
+        void closeSegment (Segment *segment, const uint64_t length);
+
+        // replaces a full segment (called by the one thread whose record
+        // crossed its end at offset end)
+        void roll (Segment *full, const uint64_t end);
+
+        // serializes roll() and closeOutput() (not taken by write())
+        std::mutex _rollMutex;
+
+        std::string _path;
+        const size_t _segmentSize;
+        uint64_t _nextIndex { 0 };
+
+        // the segment that is written to
+        std::atomic<Segment *> _segment { nullptr };
+
+        // all segments (threads may still look at retired ones, only their
+        // mapping is released)
+        std::vector<std::unique_ptr<Segment>> _segments;
+        std::atomic<uint64_t> _segmentCount { 0 };
+
+        std::atomic<uint64_t> _dropped { 0 };
+    };
+
+    /**
+     @brief Writes records to std::cout (output) and std::cerr (errors).
+     */
+    class RGPUTILS_EXPORT LogConsoleSink : public LogSink {
+
+    public:
+        /**
+         @brief Creates a console sink.
+         @param useAnsiSgrCodes Colors output records with their ANSI SGR
+         codes (the terminal has to support them).
+         @param layout How the records are formatted.
+         */
+        explicit LogConsoleSink (const bool useAnsiSgrCodes = false,
+                                 const LogLayout layout = LogLayoutMessage);
+
+        virtual ~LogConsoleSink ();
+
+    protected:
+        virtual void write (const LogSinkRecord &record) override;
+        virtual void setConsoleOutputHeld (const bool held) override;
+
+    private:
+        const bool _useAnsiSgrCodes;
+
+        // the output while a prompt waits for input (see Log::getline())
+        std::unique_ptr<LogHeldOutput> _heldOutput;
+        bool _held { false };
+    };
+
+    /**
+     @brief Keeps the last records in memory.
+     @details Useful to show recent output in an application or to attach it
+     to a bug report.
+     */
+    class RGPUTILS_EXPORT LogMemorySink : public LogSink {
+
+    public:
+        /**
+         @brief Creates a memory sink.
+         @param capacity Number of lines that are kept.
+         @param layout How the records are formatted.
+         */
+        explicit LogMemorySink (const size_t capacity = 1024,
+                                const LogLayout layout = LogLayoutTimestamped);
+
+        /** The kept lines, oldest first. */
+        std::vector<std::string> lines () const;
+
+        /** Removes all kept lines. */
+        void clear ();
+
+    protected:
+        virtual void write (const LogSinkRecord &record) override;
+
+    private:
+        std::vector<std::string> _lines;
+        size_t _next { 0 };
+        size_t _count { 0 };
+    };
+
+    /**
+     @brief Sends every record as a datagram to a Unix domain socket.
+     @details A local stand-in for syslog. The trailing newline is not sent.
+     Sending never blocks, datagrams the receiver can't take are counted as
+     dropped. Only available on Unix systems.
+     */
+    class RGPUTILS_EXPORT LogSocketSink : public LogSink {
+
+    public:
+        /**
+         @brief Connects to a datagram socket.
+         @param socketPath The path of the socket.
+         @param layout How the records are formatted.
+         */
+        explicit LogSocketSink (const std::string &socketPath,
+                                const LogLayout layout = LogLayoutMessage);
+
+        virtual ~LogSocketSink ();
+
+        /** Determines if the socket could be connected. */
+        bool isOpen () const;
+
+        /** Number of records that could not be sent. */
+        uint64_t dropped () const;
+
+    protected:
+        virtual void write (const LogSinkRecord &record) override;
+
+    private:
+        // (re)connects the socket, returns false on failure
+        bool connectSocket ();
+
+        std::string _path;
+        int _socket { -1 };
+        std::atomic<uint64_t> _dropped { 0 };
+    };
+}
+
+#endif // defined(__RGPUtils__LogSink_H__) header guard
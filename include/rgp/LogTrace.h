@@ -0,0 +1,152 @@
+/*
+ RGPUtils
+ LogTrace.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ Scoped tracing spans that can be exported to the trace event format of
+ Chrome (chrome://tracing) and Perfetto (ui.perfetto.dev).
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogTrace_H__
+#define __RGPUtils__LogTrace_H__
+
+#include <rgp/Log.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#define RGP_TRACE_CONCAT_(xx, yy) xx##yy
+#define RGP_TRACE_CONCAT(xx, yy) RGP_TRACE_CONCAT_(xx, yy)
+
+// Records the time from here to the end of the enclosing scope as a span
+// of the calling thread (if tracing is enabled). The name has to live as
+// long as the trace (a string literal), f.e.:
+// RGP_TRACE_SCOPE("parse request");
+#if !defined(RGP_TRACE_DISABLED)
+#define RGP_TRACE_SCOPE(name) \
+    rgp::LogTraceScope RGP_TRACE_CONCAT(rgpTraceScope_, __LINE__)(name)
+#else
+#define RGP_TRACE_SCOPE(name) ((void)0)
+#endif // !defined(RGP_TRACE_DISABLED)
+
+// a span for the current function
+#define RGP_TRACE_FUNCTION() RGP_TRACE_SCOPE(__func__)
+
+namespace rgp {
+
+    /**
+     @brief Collects tracing spans in per-thread buffers.
+     @details Every thread that records a span gets a ring of fixed-size
+     events on its first span. Only the owning thread writes its ring (a
+     store and a release of the write position, no lock, no fetch_add on
+     shared data), so the oldest events of a thread are overwritten when
+     its ring is full. exportChrome() copies the rings and skips events
+     that got overwritten while they were copied. The ring of an exited
+     thread is kept for the export and handed to the next new thread.
+     While tracing is disabled a scope costs one relaxed load.
+     */
+    class RGPUTILS_EXPORT LogTrace {
+
+    public:
+        /**
+         @brief Enables or disables tracing.
+         @details Disabling keeps the recorded spans (see clear()).
+         @param enabled Setting this to true will start recording spans.
+         @param eventsPerThread Number of spans the ring of every thread
+         can hold. Will be rounded up to the next power of two. Only used
+         for rings created after this call.
+         */
+        static void setEnabled (const bool enabled,
+                                const size_t eventsPerThread = 16384);
+
+        /** Determines if spans are recorded. */
+        static bool enabled () {
+            return _enabled.load(std::memory_order_relaxed);
+        };
+
+        /** Discards the recorded spans of all threads. */
+        static void clear ();
+
+        /**
+         @brief Writes the recorded spans as Chrome trace event JSON.
+         @details One complete event ("ph":"X") per span with begin and
+         duration in microseconds, thread ids are the thread numbers of the
+         log ("%t" of a LogPattern). Can be called while spans are recorded.
+         @param filePath The path of the file, it gets truncated.
+         @return True if the file could be written.
+         */
+        static bool exportChrome (const std::string &filePath);
+
+        /**
+         @brief The recorded spans as Chrome trace event JSON.
+         @sa exportChrome()
+         */
+        static std::string chromeJson ();
+
+        /** Nanoseconds of the monotonic clock used for the spans. */
+        static int64_t now () {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        };
+
+        /**
+         @brief Stores a span in the ring of the calling thread.
+         @details Use RGP_TRACE_SCOPE() instead of calling this directly.
+         @param name Name of the span (has to live as long as the trace).
+         @param begin Begin of the span (now()).
+         @param end End of the span (now()).
+         */
+        static void record (const char *name, const int64_t begin,
+                            const int64_t end);
+
+    private:
+        static std::atomic<bool> _enabled;
+    };
+
+    /** Records the lifetime of the object as a span (see RGP_TRACE_SCOPE). */
+    class LogTraceScope {
+
+    public:
+        explicit LogTraceScope (const char *name)
+            : _name(LogTrace::enabled() ? name : nullptr),
+              _begin(_name != nullptr ? LogTrace::now() : 0) {};
+
+        ~LogTraceScope () {
+            if (RGPLOG_UNLIKELY(_name != nullptr)) {
+                LogTrace::record(_name, _begin, LogTrace::now());
+            }
+        };
+
+        LogTraceScope (const LogTraceScope &) = delete;
+        LogTraceScope &operator = (const LogTraceScope &) = delete;
+
+    private:
+        const char *_name;
+        int64_t _begin;
+    };
+}
+
+#endif // defined(__RGPUtils__LogTrace_H__) header guard
@@ -25,211 +25,612 @@
 */
 
 #include <rgp/Log.h>
+#include <rgp/LogBinary.h>
+#include <rgp/LogSink.h>
+#include <rgp/LogMetrics.h>
+#include <rgp/LogCategory.h>
+#include <rgp/LogPattern.h>
+#include <rgp/LogLimit.h>
+#include <rgp/LogIndex.h>
+
+#include "LogQueue.h"
+#include "LogThreadQueue.h"
+#include "LogFile.h"
+#include "LogGroupCommit.h"
+#include "LogClock.h"
+#include "LogFlightRecorder.h"
+#include "LogMetricsRecorder.h"
+#include "LogSgr.h"
+#include "LogRepeatFilter.h"
+#include "LogSharedRing.h"
+#include "LogHeldOutput.h"
 
 #include <iostream> // cout / cerr / cin ...
-#include <sstream>  // stringstream
-#include <fstream>  // file writing
-#include <ctime>    // adding date to log file
 #include <cstring>  // strerror
+#include <cstdlib>  // atexit
+#include <chrono>
+#include <algorithm>
+#include <deque>
+
+#if defined(__APPLE__) || defined(__unix__)
+#include <unistd.h> // getpid
+#elif defined(_WIN32)
+#include <process.h> // _getpid
+#endif // defined(__APPLE__) || defined(__unix__) // defined(_WIN32)
 
 using namespace rgp;
 
-// init instance to nullptr
-Log *Log::_sharedInstance = nullptr;
+// how long the idle writer thread sleeps before it looks at the queue again
+static const std::chrono::milliseconds kWriterIdleTimeout { 100 };
 
-Log *Log::sharedLog () {
+// states of the housekeeper thread (synchronous mode)
+static const uint8_t kHousekeeperIdle = 0;
+static const uint8_t kHousekeeperRunning = 1;
+static const uint8_t kHousekeeperStopped = 2;
+
+// how long the idle collector thread sleeps before it looks at the ring
+// again (producers of other processes can't wake it up)
+static const std::chrono::milliseconds kCollectorIdleTimeout { 2 };
+
+// how often a process with LogSharedRingElected checks for a collector
+static const std::chrono::milliseconds kCollectorElectionInterval { 100 };
+
+namespace {
+    
+    // owns the queue of a logging thread and retires it on thread exit
+    struct ThreadQueueHandle {
+        std::shared_ptr<LogThreadQueue> queue;
+        
+        ~ThreadQueueHandle ();
+    };
     
-    // if first used -> alloc instance
-    if (_sharedInstance == nullptr) {
-        _sharedInstance = new Log();
+    thread_local ThreadQueueHandle threadQueueHandle;
+    
+    // fast access to the queue of the thread
+    thread_local LogThreadQueue *threadQueuePointer = nullptr;
+    
+    // set while the thread exits (log calls from other thread_local
+    // destructors have to use the shared queue)
+    thread_local bool threadQueueRetired = false;
+    
+    ThreadQueueHandle::~ThreadQueueHandle ()
+    {
+        threadQueueRetired = true;
+        threadQueuePointer = nullptr;
+        if (queue) {
+            queue->retire();
+        }
     }
+}
+
+Log::LevelCell Log::_levels[kLogCategoryCount];
+Log::LevelCell Log::_enabledLevels[kLogCategoryCount];
+bool Log::_explicitLevels[kLogCategoryCount] {};
+std::mutex Log::_levelsMutex;
+
+Log::Log () : _logFile(new LogFile()), _errorFile(new LogFile()),
+               _logCommit(new LogGroupCommit()),
+               _errorCommit(new LogGroupCommit()),
+               _spill(new std::deque<LogRecord>())
+{
+    _repeatFilters[LogStreamOutput].reset(new LogRepeatFilter());
+    _repeatFilters[LogStreamError].reset(new LogRepeatFilter());
+    _heldOutput.reset(new LogHeldOutput());
     
-    return _sharedInstance;
+    // don't lose queued records on exit
+    std::atexit(&Log::exitHandler);
+}
+
+Log::~Log ()
+{
+}
+
+void Log::exitHandler ()
+{
+    sharedLog()->shutdown();
+}
+
+Log *Log::sharedLog () {
+    
+    // created on first use (thread-safe), never deleted: other static
+    // destructors may still log
+    static Log *instance = new Log();
+    
+    return instance;
 }
 
 Loglevel Log::loglevel () const
 {
-    return _logLevel;
+    return _levels[0].value.load(std::memory_order_relaxed);
 }
 
 void Log::setLoglevel (const Loglevel level)
 {
-    _logLevel = level;
+    setCategoryLoglevel(0, level, false);
+}
+
+void Log::setCategoryLoglevel (const uint16_t category, const Loglevel level,
+                               const bool explicitLevel)
+{
+    std::lock_guard<std::mutex> lock(_levelsMutex);
+    
+    if (category == 0) {
+        // the global level is passed on to all categories without a level
+        _levels[0].value.store(level, std::memory_order_relaxed);
+        for (size_t i = 1; i < kLogCategoryCount; i++) {
+            if (!_explicitLevels[i]) {
+                _levels[i].value.store(level, std::memory_order_relaxed);
+            }
+        }
+    } else {
+        _explicitLevels[category] = explicitLevel;
+        _levels[category].value.store(explicitLevel ? level :
+            _levels[0].value.load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+    }
+    
+    updateEnabledLevels();
+}
+
+void Log::updateEnabledLevels ()
+{
+    // the flight recorder wants everything
+    bool recording = _flightRecorder.load() != nullptr;
+    for (size_t i = 0; i < kLogCategoryCount; i++) {
+        _enabledLevels[i].value.store(recording ? LoglevelVerbose :
+            _levels[i].value.load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+    }
 }
 
 // verbose level 1 print
-void Log::printv (const std::string text, const AnsiSgrFgColor fgcolor,
+void Log::printv (const std::string &text, const AnsiSgrFgColor fgcolor,
                   const AnsiSgrBgColor bgcolor)
 {
-    if (_logLevel >= LoglevelVerbose) {
-        print(text, fgcolor, bgcolor);
+    if (RGPLOG_UNLIKELY(enabled(LoglevelVerbose))) {
+        submit(LogStreamOutput, LoglevelVerbose, text.data(), text.size(),
+               fgcolor, bgcolor);
+    }
+}
+
+void Log::printv (const char *text, const AnsiSgrFgColor fgcolor,
+                  const AnsiSgrBgColor bgcolor)
+{
+    if (RGPLOG_UNLIKELY(enabled(LoglevelVerbose))) {
+        submit(LogStreamOutput, LoglevelVerbose, text, strlen(text),
+               fgcolor, bgcolor);
     }
 }
 
 // normal print
-void Log::print (const std::string text, const AnsiSgrFgColor fgcolor,
+void Log::print (const std::string &text, const AnsiSgrFgColor fgcolor,
                  const AnsiSgrBgColor bgcolor)
 {
-    if (_logLevel >= LoglevelNormal) {
-        
-        _cout_mutex.lock();
-        
-        // use log file if possible
-        if (_hasLogfile) {
-            
-            // open log file
-            std::ofstream file;
-            file.open(_logFilePath, std::ios::app);
-            
-            // write output to file
-            if (file.is_open()) {
-                
-                // add time to file
-                time_t timestamp = time(NULL); // get time now
-                tm *current_time = localtime( &timestamp );
-                file
-                << (current_time->tm_year + 1900) << '-'
-                << (current_time->tm_mon + 1) << '-'
-                <<  current_time->tm_mday << ' '
-                <<  current_time->tm_hour << ':'
-                <<  current_time->tm_min << ':'
-                <<  current_time->tm_sec << ' ';
-                
-                // append text
-                file << text << std::endl;
-            }
-            
-            // close log file
-            file.close();
-            
-        } else {
-            
-            // TODO: check if terminal supports ansi colors
-            if (_useAnsiSgrCodes)
-                std::cout << createSelectGraphicRenditionCode(fgcolor, bgcolor);
-            
-            // output to stdout
-            std::cout << text << std::endl << std::flush;
-            
-            // reset colors to default
-            if (_useAnsiSgrCodes)
-                std::cout << resetSelectGraphicRenditionCode();
-        }
-        
-        _cout_mutex.unlock();
+    if (enabled(LoglevelNormal)) {
+        submit(LogStreamOutput, LoglevelNormal, text.data(), text.size(),
+               fgcolor, bgcolor);
+    }
+}
+
+void Log::print (const char *text, const AnsiSgrFgColor fgcolor,
+                 const AnsiSgrBgColor bgcolor)
+{
+    if (enabled(LoglevelNormal)) {
+        submit(LogStreamOutput, LoglevelNormal, text, strlen(text),
+               fgcolor, bgcolor);
     }
 }
 
 // outputs text and reads line from stdin
-std::string Log::getline (const std::string text)
+std::string Log::getline (const std::string &text)
 {
-    char line_c[1024];
-    
-    _cout_mutex.lock();
-    
-    std::cout << text << std::flush;
-    std::cin.getline(line_c, 1024);
+    std::lock_guard<std::mutex> lock(_inputMutex);
     
-    _cout_mutex.unlock();
+    std::string line;
+    beginPrompt(text);
+    std::getline(std::cin, line);
+    endPrompt();
     
-    return std::string { line_c };
+    return line;
 }
 
 // outputs text and reads one character from stdin
-char Log::getc (const std::string text)
+char Log::getc (const std::string &text)
 {
-    char c = ' ';
-    
-    _cout_mutex.lock();
+    std::lock_guard<std::mutex> lock(_inputMutex);
     
-    std::cout << text << std::flush;
+    char c = ' ';
+    beginPrompt(text);
     std::cin >> c;
-    
-    _cout_mutex.unlock();
+    endPrompt();
     
     return c;
 }
 
-// error print
-void Log::error (const std::string text)
+void Log::beginPrompt (const std::string &text)
 {
-    _cerr_mutex.lock();
+    std::lock_guard<std::mutex> coutLock(_cout_mutex);
+    std::lock_guard<std::mutex> cerrLock(_cerr_mutex);
     
-    // use log file if possible
-    if (_hasErrorfile) {
-        
-        // open log file
-        std::ofstream file;
-        file.open(_errorFilePath, std::ios::app);
-        
-        // write output to file
-        if (file.is_open()) {
-            
-            // add time to file
-            time_t timestamp = time(NULL); // get time now
-            tm *current_time = localtime( &timestamp );
-            file
-            << (current_time->tm_year + 1900) << '-'
-            << (current_time->tm_mon + 1) << '-'
-            <<  current_time->tm_mday << ' '
-            <<  current_time->tm_hour << ':'
-            <<  current_time->tm_min << ':'
-            <<  current_time->tm_sec << ' ';
-            
-            // append text
-            file << text << std::endl;
-        }
-        
-        // close log file
-        file.close();
-        
-    } else {
-        
-        // output to stderr
-        std::cerr << text << std::endl << std::flush;
+    // output() and the console sinks hold std::cout and std::cerr back
+    // from now on, we wait on std::cin without the mutexes
+    _prompting = true;
+    std::shared_ptr<std::vector<std::shared_ptr<LogSink>>> sinks =
+        std::atomic_load(&_sinks);
+    if (sinks) {
+        _heldSinks = *sinks;
     }
+    for (size_t i = 0; i < _heldSinks.size(); i++) {
+        _heldSinks[i]->holdConsoleOutput(true);
+    }
+    std::cout << text << std::flush;
+}
+
+void Log::endPrompt ()
+{
+    std::lock_guard<std::mutex> coutLock(_cout_mutex);
+    std::lock_guard<std::mutex> cerrLock(_cerr_mutex);
     
-    _cerr_mutex.unlock();
+    _prompting = false;
+    _heldOutput->release();
+    for (size_t i = 0; i < _heldSinks.size(); i++) {
+        _heldSinks[i]->holdConsoleOutput(false);
+    }
+    _heldSinks.clear();
+}
+
+// error print
+void Log::error (const std::string &text)
+{
+    submit(LogStreamError, LoglevelNormal, text.data(), text.size());
+}
+
+void Log::error (const char *text)
+{
+    submit(LogStreamError, LoglevelNormal, text, strlen(text));
 }
 
 // error print with error number (errno)
-void Log::errorWithErrno (const std::string text, const int err)
+void Log::errorWithErrno (const std::string &text, const int err)
+{
+    errorWithErrno(text.data(), text.size(), err);
+}
+
+void Log::errorWithErrno (const char *text, const int err)
+{
+    errorWithErrno(text, strlen(text), err);
+}
+
+#if !defined(_WIN32)
+// only one of the overloads is used, depending on the C library
+#if defined(__GNUC__) || defined(__clang__)
+#define RGPLOG_MAYBE_UNUSED __attribute__((unused))
+#else
+#define RGPLOG_MAYBE_UNUSED
+#endif // defined(__GNUC__) || defined(__clang__)
+
+// picks the message of the XSI and the GNU version of strerror_r
+RGPLOG_MAYBE_UNUSED
+static const char *strerrorResult (const int result, const char *buffer)
+{
+    return result == 0 ? buffer : "Unknown error";
+}
+
+RGPLOG_MAYBE_UNUSED
+static const char *strerrorResult (const char *result, const char *)
+{
+    return result;
+}
+#endif // !defined(_WIN32)
+
+void Log::errorWithErrno (const char *text, const size_t length, const int err)
 {
     // create error string with text + errno
-    std::string error_string { text };
-    error_string += " ";
-    error_string += strerror(err);
+    // (strerror() isn't thread-safe, use the reentrant versions)
+    char message[256];
+#if defined(_WIN32)
+    strerror_s(message, sizeof(message), err);
+    const char *errorText = message;
+#else
+    const char *errorText = strerrorResult(strerror_r(err, message,
+                                                      sizeof(message)),
+                                           message);
+#endif // defined(_WIN32)
+    
+    std::string &buffer = formatBuffer();
+    buffer.append(text, length);
+    buffer += ' ';
+    buffer.append(errorText);
     
     // output error with errno error string
-    error( error_string );
+    submit(LogStreamError, LoglevelNormal, buffer.data(), buffer.size());
+}
+
+std::string &Log::formatBuffer ()
+{
+    static thread_local std::string buffer;
+    buffer.clear();
+    return buffer;
 }
 
 // using log file for print
 void Log::useLogfile (const std::string filePath)
 {
-    _logFilePath = filePath;
+    std::lock_guard<std::mutex> lock(_cout_mutex);
     
     // check if file is usable
-    std::ofstream file;
-    file.open(_logFilePath, std::ios::app);
-    if (file.is_open()) {
-        _hasLogfile = true;
-    }
-    file.close();
+    _hasLogfile = _logFile->open(filePath);
 }
 
 // using error file
 void Log::useErrorfile (const std::string filePath)
 {
-    _errorFilePath = filePath;
+    std::lock_guard<std::mutex> lock(_cerr_mutex);
     
     // check if file is usable
-    std::ofstream file;
-    file.open(_errorFilePath, std::ios::app);
-    if (file.is_open()) {
-        _hasErrorfile = true;
+    _hasErrorfile = _errorFile->open(filePath);
+    
+    // crash dumps go next to the errorfile
+    std::lock_guard<std::mutex> recorderLock(_flightRecorderMutex);
+    if (_flightRecorder.load() != nullptr) {
+        LogFlightRecorder::dumpOnCrash(_flightRecorder.load(),
+                                       flightRecorderPath());
+    }
+}
+
+void Log::setFlightRecorder (const bool enabled, const size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(_flightRecorderMutex);
+    
+    if (enabled) {
+        if (!_flightRecorderStorage) {
+            _flightRecorderStorage.reset(new LogFlightRecorder(capacity));
+        }
+        _flightRecorder.store(_flightRecorderStorage.get());
+        LogFlightRecorder::dumpOnCrash(_flightRecorderStorage.get(),
+                                       flightRecorderPath());
+    } else {
+        _flightRecorder.store(nullptr);
+        LogFlightRecorder::dumpOnCrash(nullptr, std::string());
     }
-    file.close();
+    
+    std::lock_guard<std::mutex> levelsLock(_levelsMutex);
+    updateEnabledLevels();
+}
+
+bool Log::flightRecorder () const
+{
+    return _flightRecorder.load() != nullptr;
+}
+
+bool Log::dumpFlightRecorder (const std::string &filePath)
+{
+    std::lock_guard<std::mutex> lock(_flightRecorderMutex);
+    
+    if (!_flightRecorderStorage) {
+        return false;
+    }
+    
+    std::string path = filePath.empty() ? flightRecorderPath() : filePath;
+    return _flightRecorderStorage->dump(path.c_str());
+}
+
+std::string Log::flightRecorderPath () const
+{
+    // the directory of the errorfile or the working directory
+    std::string directory;
+    if (_hasErrorfile) {
+        const std::string &errorfile = _errorFile->path();
+        size_t separator = errorfile.find_last_of("/\\");
+        if (separator != std::string::npos) {
+            directory = errorfile.substr(0, separator + 1);
+        }
+    }
+    
+#if defined(_WIN32)
+    int pid = _getpid();
+#else
+    int pid = (int)getpid();
+#endif // defined(_WIN32)
+    
+    std::string path = directory;
+    logFormat(path, "rgplog_flight_{}.log", pid);
+    return path;
+}
+
+bool Log::useBinaryLogfile (const std::string &filePath)
+{
+    return LogBinary::open(filePath);
+}
+
+void Log::setLogfileBufferSize (const size_t bytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(_cout_mutex);
+        _logFile->setBufferSize(bytes);
+    }
+    {
+        std::lock_guard<std::mutex> lock(_cerr_mutex);
+        _errorFile->setBufferSize(bytes);
+    }
+}
+
+void Log::setLogfileFlushInterval (const unsigned int milliseconds)
+{
+    {
+        std::lock_guard<std::mutex> lock(_cout_mutex);
+        _logFile->setFlushInterval(std::chrono::milliseconds(milliseconds));
+    }
+    {
+        std::lock_guard<std::mutex> lock(_cerr_mutex);
+        _errorFile->setFlushInterval(std::chrono::milliseconds(milliseconds));
+    }
+}
+
+void Log::setLogfileRotation (const LogRotation &rotation)
+{
+    {
+        std::lock_guard<std::mutex> lock(_cout_mutex);
+        _logFile->setRotation(rotation);
+    }
+    {
+        std::lock_guard<std::mutex> lock(_cerr_mutex);
+        _errorFile->setRotation(rotation);
+    }
+}
+
+void Log::setLogfileIndex (const size_t intervalBytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(_cout_mutex);
+        _logFile->setIndexInterval(intervalBytes);
+    }
+    {
+        std::lock_guard<std::mutex> lock(_cerr_mutex);
+        _errorFile->setIndexInterval(intervalBytes);
+    }
+    
+    _logfileIndex.store(intervalBytes > 0);
+}
+
+void Log::setLogfileDurability (const LogDurability durability,
+                                const unsigned int syncInterval)
+{
+    std::chrono::milliseconds interval(durability == LogDurabilityPeriodic ?
+                                       syncInterval : 0);
+    bool syncOnClose = durability != LogDurabilityNone;
+    {
+        std::lock_guard<std::mutex> lock(_cout_mutex);
+        _logFile->setSyncInterval(interval);
+        _logFile->setSyncOnClose(syncOnClose);
+    }
+    {
+        std::lock_guard<std::mutex> lock(_cerr_mutex);
+        _errorFile->setSyncInterval(interval);
+        _errorFile->setSyncOnClose(syncOnClose);
+    }
+    
+    _durability.store(durability);
+}
+
+LogDurability Log::logfileDurability () const
+{
+    return _durability.load();
+}
+
+LogDurabilityStatistics Log::durabilityStatistics () const
+{
+    LogDurabilityStatistics statistics;
+    statistics.syncs = _logFile->syncs() + _errorFile->syncs();
+    statistics.syncTime = _logFile->syncTime() + _errorFile->syncTime();
+    statistics.maxSyncTime = std::max(_logFile->maxSyncTime(),
+                                      _errorFile->maxSyncTime());
+    statistics.commits = _logCommit->commits() + _errorCommit->commits();
+    return statistics;
+}
+
+void Log::commitDurable (const uint8_t stream)
+{
+    bool error = stream == LogStreamError;
+    if (!(error ? _hasErrorfile : _hasLogfile).load()) {
+        return;
+    }
+    
+    // our record has to be in the file first
+    if (_asynchronous.load()) {
+        waitForWriter();
+    }
+    
+    std::mutex &mutex = error ? _cerr_mutex : _cout_mutex;
+    LogFile &file = error ? *_errorFile : *_logFile;
+    
+    uint64_t position;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        position = file.appended();
+    }
+    
+    (error ? _errorCommit : _logCommit)->commit(file, mutex, position);
+}
+
+void Log::reopenLogfiles ()
+{
+    _logFile->requestReopen();
+    _errorFile->requestReopen();
+}
+
+void Log::flushLogfilesIfDue ()
+{
+    {
+        std::lock_guard<std::mutex> lock(_cout_mutex);
+        reportRepeats(LogStreamOutput, true);
+        _logFile->flushIfDue();
+    }
+    {
+        std::lock_guard<std::mutex> lock(_cerr_mutex);
+        reportRepeats(LogStreamError, true);
+        _errorFile->flushIfDue();
+    }
+    
+    if (_hasSinks.load()) {
+        std::shared_ptr<std::vector<std::shared_ptr<LogSink>>> sinks =
+            std::atomic_load(&_sinks);
+        for (size_t i = 0; i < sinks->size(); i++) {
+            (*sinks)[i]->flushIfDue();
+        }
+    }
+}
+
+void Log::addSink (const std::shared_ptr<LogSink> &sink)
+{
+    std::lock_guard<std::mutex> lock(_sinksMutex);
+    
+    std::shared_ptr<std::vector<std::shared_ptr<LogSink>>> sinks =
+        std::make_shared<std::vector<std::shared_ptr<LogSink>>>();
+    if (_sinks) {
+        *sinks = *_sinks;
+    }
+    sinks->push_back(sink);
+    
+    std::atomic_store(&_sinks, sinks);
+    _hasSinks.store(true);
+}
+
+void Log::removeSink (const std::shared_ptr<LogSink> &sink)
+{
+    std::lock_guard<std::mutex> lock(_sinksMutex);
+    if (!_sinks) {
+        return;
+    }
+    
+    std::shared_ptr<std::vector<std::shared_ptr<LogSink>>> sinks =
+        std::make_shared<std::vector<std::shared_ptr<LogSink>>>();
+    bool removed = false;
+    for (size_t i = 0; i < _sinks->size(); i++) {
+        if ((*_sinks)[i] != sink) {
+            sinks->push_back((*_sinks)[i]);
+        } else {
+            removed = true;
+        }
+    }
+    
+    _hasSinks.store(!sinks->empty());
+    std::atomic_store(&_sinks, sinks);
+    
+    if (removed) {
+        sink->flush();
+        sink->close();
+    }
+}
+
+void Log::setUseDefaultDestinations (const bool useDefaultDestinations)
+{
+    _useDefaultDestinations.store(useDefaultDestinations);
+}
+
+bool Log::useDefaultDestinations () const
+{
+    return _useDefaultDestinations.load();
 }
 
 void Log::setUseAnsiSgrCodes (const bool useAnsiSgrCodes)
@@ -248,21 +649,1124 @@ bool Log::useAnsiSgrCodes () const
     return _useAnsiSgrCodes;
 }
 
-// creates ANSI SGR Code for given foreground and background colors
-std::string Log::createSelectGraphicRenditionCode(const AnsiSgrFgColor fgcolor,
-                                                  const AnsiSgrBgColor bgcolor)
+void Log::setLogfilePattern (const std::string &pattern)
+{
+    std::shared_ptr<const LogPattern> parsed;
+    if (!pattern.empty()) {
+        parsed = std::make_shared<LogPattern>(pattern);
+    }
+    
+    std::lock_guard<std::mutex> coutLock(_cout_mutex);
+    std::lock_guard<std::mutex> cerrLock(_cerr_mutex);
+    _logfilePattern = parsed;
+}
+
+void Log::setLogfileEncoding (const LogEncoding encoding)
+{
+    std::lock_guard<std::mutex> coutLock(_cout_mutex);
+    std::lock_guard<std::mutex> cerrLock(_cerr_mutex);
+    _logfileEncoding = encoding;
+}
+
+void Log::setConsolePattern (const std::string &pattern)
 {
-    std::stringstream sgr;
-    if (fgcolor != AnsiSgrFgColorDefault || bgcolor != AnsiSgrBgColorDefault) {
-        sgr << "\033[" << fgcolor << ";" << bgcolor << "m";
+    std::shared_ptr<const LogPattern> parsed;
+    if (!pattern.empty()) {
+        parsed = std::make_shared<LogPattern>(pattern);
     }
-    return sgr.str();
+    
+    std::lock_guard<std::mutex> coutLock(_cout_mutex);
+    std::lock_guard<std::mutex> cerrLock(_cerr_mutex);
+    _consolePattern = parsed;
+}
+
+uint32_t Log::threadNumber ()
+{
+    static std::atomic<uint32_t> next { 1 };
+    static thread_local uint32_t number = next.fetch_add(1);
+    return number;
 }
 
-// creates ANSI SGR Reset Code
-std::string Log::resetSelectGraphicRenditionCode()
+void Log::submit (const uint8_t stream, const Loglevel level,
+                  const char *text, const size_t length,
+                  const AnsiSgrFgColor fgcolor, const AnsiSgrBgColor bgcolor,
+                  const uint16_t category, const uint32_t fields)
 {
-    std::stringstream sgr;
-    sgr << "\033[0m";
-    return sgr.str();
+    LogCallMeasurement measurement(stream == LogStreamError, level, length);
+    const int64_t timestamp = LogClock::now();
+    
+    // (the flight recorder only keeps the message)
+    LogFlightRecorder *recorder = _flightRecorder.load(std::memory_order_acquire);
+    if (recorder != nullptr) {
+        recorder->record(timestamp, stream == LogStreamError, level,
+                         text, length - fields);
+    }
+    
+    // the record may only be there for the flight recorder
+    if (stream == LogStreamOutput &&
+        level > _levels[category].value.load(std::memory_order_relaxed)) {
+        return;
+    }
+    
+    // shared ring -> the collector writes the record
+    LogSharedRing *ring = _sharedRingPointer.load(std::memory_order_acquire);
+    if (RGPLOG_UNLIKELY(ring != nullptr)) {
+        ring->publish(timestamp, stream, level, fgcolor, bgcolor,
+                      category != 0 ?
+                      LogCategory::nameOf(category).c_str() : nullptr,
+                      threadNumber(), text, length, fields);
+        return;
+    }
+    
+    if (!_asynchronous.load(std::memory_order_acquire)) {
+        
+        // synchronous mode -> write directly
+        // (the record is reused to keep the capacity of its text)
+        static thread_local LogRecord record;
+        record.timestamp = timestamp;
+        record.stream = (LogStream)stream;
+        record.level = level;
+        record.fgcolor = fgcolor;
+        record.bgcolor = bgcolor;
+        record.category = category;
+        record.thread = threadNumber();
+        record.fields = fields;
+        record.text.assign(text, length);
+        
+        uint8_t housekeeper = _housekeeperState.load(std::memory_order_relaxed);
+        {
+            std::mutex &mutex = stream == LogStreamError ? _cerr_mutex : _cout_mutex;
+            std::lock_guard<std::mutex> lock(mutex);
+            deliver(record);
+            
+            // nobody checks the flush interval anymore (process exit)
+            if (RGPLOG_UNLIKELY(housekeeper == kHousekeeperStopped)) {
+                (stream == LogStreamError ? _errorFile : _logFile)->flush();
+            }
+        }
+        
+        if (RGPLOG_UNLIKELY(housekeeper == kHousekeeperIdle)) {
+            startHousekeeper();
+        }
+        
+        if (RGPLOG_UNLIKELY(_durability.load(std::memory_order_relaxed) ==
+                            LogDurabilityGroupCommit)) {
+            commitDurable(stream);
+        }
+        
+        if (RGPLOG_UNLIKELY(_metricsDumpInterval.load(std::memory_order_relaxed) != 0)) {
+            dumpMetricsIfDue(timestamp);
+        }
+        return;
+    }
+    
+    // claim a slot, if the queue is full wait for the writer
+    LogRecord *record;
+    LogThreadQueue *threadQueue = nullptr;
+    uint64_t position = 0;
+    
+    if (_perThreadQueues.load(std::memory_order_relaxed) &&
+        (threadQueue = this->threadQueue()) != nullptr) {
+        record = threadQueue->tryClaim();
+    } else {
+        record = _queue->tryClaim(position);
+    }
+    
+    if (RGPLOG_UNLIKELY(record == nullptr)) {
+        
+        // queue is full
+        LogOverflowPolicy policy = _overflowPolicy.load(std::memory_order_relaxed);
+        
+        if (policy == LogOverflowDropNewest ||
+            (policy == LogOverflowDropOldest && threadQueue != nullptr)) {
+            // (only the writer may read from a per-thread queue)
+            _droppedRecords.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        
+        if (policy == LogOverflowSpill) {
+            spill(timestamp, stream, level, text, length, fgcolor, bgcolor,
+                  category, fields);
+            recordPublished();
+            if (RGPLOG_UNLIKELY(_durability.load(std::memory_order_relaxed) ==
+                                LogDurabilityGroupCommit)) {
+                commitDurable(stream);
+            }
+            return;
+        }
+        
+        if (policy == LogOverflowBlock) {
+            _blockedCalls.fetch_add(1, std::memory_order_relaxed);
+        }
+        
+        while (record == nullptr) {
+            if (policy == LogOverflowDropOldest) {
+                // make room on our own by discarding the oldest record
+                uint64_t oldest;
+                if (_queue->tryConsume(oldest) != nullptr) {
+                    _queue->release(oldest);
+                    _overwrittenRecords.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    // oldest slot is still being written
+                    std::this_thread::yield();
+                }
+            } else if (!_asynchronous.load()) {
+                // writer got stopped meanwhile -> make room on our own
+                drainQueue();
+            } else {
+                wakeWriter();
+                std::this_thread::yield();
+            }
+            record = threadQueue != nullptr ?
+                threadQueue->tryClaim() : _queue->tryClaim(position);
+        }
+    }
+    
+    record->timestamp = timestamp;
+    record->stream = (LogStream)stream;
+    record->level = level;
+    record->fgcolor = fgcolor;
+    record->bgcolor = bgcolor;
+    record->category = category;
+    record->thread = threadNumber();
+    record->fields = fields;
+    record->text.assign(text, length);
+    
+    if (threadQueue != nullptr) {
+        threadQueue->publish();
+    } else {
+        _queue->publish(position);
+    }
+    
+    recordPublished();
+    
+    if (RGPLOG_UNLIKELY(_durability.load(std::memory_order_relaxed) ==
+                        LogDurabilityGroupCommit)) {
+        commitDurable(stream);
+    }
+}
+
+void Log::recordPublished ()
+{
+    // pairs with the fence in writerLoop(): either we see the writer
+    // going to sleep or the writer sees our record
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_writerWaiting.load(std::memory_order_relaxed)) {
+        wakeWriter();
+    }
+    
+    // the writer may have been stopped before our record was published
+    if (!_asynchronous.load()) {
+        drainQueue();
+    }
+}
+
+void Log::spill (const int64_t timestamp, const uint8_t stream,
+                 const Loglevel level,
+                 const char *text, const size_t length,
+                 const AnsiSgrFgColor fgcolor, const AnsiSgrBgColor bgcolor,
+                 const uint16_t category, const uint32_t fields)
+{
+    std::lock_guard<std::mutex> lock(_spillMutex);
+    
+    if (_spillBytes + length > _spillCapacity.load(std::memory_order_relaxed)) {
+        _droppedRecords.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    
+    _spill->emplace_back();
+    LogRecord &record = _spill->back();
+    record.timestamp = timestamp;
+    record.stream = (LogStream)stream;
+    record.level = level;
+    record.fgcolor = fgcolor;
+    record.bgcolor = bgcolor;
+    record.category = category;
+    record.thread = threadNumber();
+    record.fields = fields;
+    record.text.assign(text, length);
+    
+    _spillBytes += length;
+    _spilledRecords.fetch_add(1, std::memory_order_release);
+}
+
+void Log::reportLostRecords ()
+{
+    uint64_t lost = _droppedRecords.load(std::memory_order_relaxed) +
+        _overwrittenRecords.load(std::memory_order_relaxed);
+    if (RGPLOG_LIKELY(lost == _reportedLostRecords)) {
+        return;
+    }
+    
+    LogRecord record;
+    record.timestamp = LogClock::now();
+    record.stream = LogStreamOutput;
+    record.level = LoglevelNormal;
+    record.fgcolor = AnsiSgrFgColorDefault;
+    record.bgcolor = AnsiSgrBgColorDefault;
+    logFormat(record.text, "{} messages dropped (log queue full)",
+              lost - _reportedLostRecords);
+    _reportedLostRecords = lost;
+    
+    std::lock_guard<std::mutex> lock(_cout_mutex);
+    deliver(record);
+}
+
+void Log::deliver (const LogRecord &record)
+{
+    if (RGPLOG_UNLIKELY(_repeatWindow.load(std::memory_order_relaxed) != 0)) {
+        LogRepeatFilter &filter = *_repeatFilters[record.stream];
+        if (filter.repeats(record, _repeatWindow.load(std::memory_order_relaxed))) {
+            return;
+        }
+        
+        // the run before has ended
+        const LogRecord *summary = filter.takeSummary();
+        if (summary != nullptr) {
+            output(*summary);
+        }
+        filter.remember(record);
+    }
+    
+    output(record);
+}
+
+void Log::reportRepeats (const uint8_t stream, const bool due)
+{
+    LogRepeatFilter &filter = *_repeatFilters[stream];
+    if (!filter.pending() ||
+        (due && !filter.due(LogClock::now(),
+                            _repeatWindow.load(std::memory_order_relaxed)))) {
+        return;
+    }
+    
+    const LogRecord *summary = filter.takeSummary();
+    if (summary != nullptr) {
+        output(*summary);
+    }
+}
+
+void Log::output (const LogRecord &record)
+{
+    // every layout gets formatted once for all destinations
+    // (the buffers of the lines keep their capacity)
+    static thread_local LogSinkRecord formatted;
+    formatted.reset(record.timestamp, record.stream == LogStreamError,
+                    record.level, record.fgcolor, record.bgcolor,
+                    record.text.data(), record.text.size(),
+                    record.category != 0 ?
+                    LogCategory::nameOf(record.category).c_str() : nullptr,
+                    record.thread, record.fields);
+    
+    if (_hasSinks.load(std::memory_order_acquire)) {
+        std::shared_ptr<std::vector<std::shared_ptr<LogSink>>> sinks =
+            std::atomic_load(&_sinks);
+        for (size_t i = 0; i < sinks->size(); i++) {
+            LogSink *sink = (*sinks)[i].get();
+            if (sink->accepts(formatted)) {
+                sink->consume(formatted);
+            }
+        }
+    }
+    
+    if (!_useDefaultDestinations.load(std::memory_order_relaxed)) {
+        return;
+    }
+    
+    LogFile *file = nullptr;
+    if (record.stream == LogStreamError) {
+        if (_hasErrorfile) file = _errorFile.get();
+    } else {
+        if (_hasLogfile) file = _logFile.get();
+    }
+    
+    // use log file if possible
+    if (file != nullptr) {
+        
+        // time + text (or the pattern), logfmt or JSON
+        const std::string &line =
+            _logfileEncoding == LogEncodingLogfmt ?
+            formatted.line(LogLayoutLogfmt) :
+            _logfileEncoding == LogEncodingJson ?
+            formatted.line(LogLayoutJson) :
+            _logfilePattern ? formatted.line(*_logfilePattern) :
+            formatted.line(LogLayoutTimestamped);
+        if (RGPLOG_UNLIKELY(_logfileIndex.load(std::memory_order_relaxed))) {
+            file->writeRecord(line.data(), line.size(), record.timestamp,
+                              record.stream == LogStreamError ?
+                              LogIndexLevelError :
+                              record.level == LoglevelVerbose ?
+                              LogIndexLevelVerbose : LogIndexLevelInfo);
+        } else {
+            file->write(line.data(), line.size());
+        }
+        
+        return;
+    }
+    
+    // "[category] " + text (or the pattern)
+    const std::string &line = _consolePattern ?
+        formatted.line(*_consolePattern) : formatted.line(LogLayoutMessage);
+    
+    // TODO: check if terminal supports ansi colors
+    // (a pattern places the colors itself with %^ and %$)
+    bool colored = record.stream == LogStreamOutput && _useAnsiSgrCodes &&
+        !_consolePattern && logSgrColored(record.fgcolor, record.bgcolor);
+    
+    // a prompt waits for input -> written when it returns
+    _heldOutput->write(_prompting, record.stream == LogStreamError, line,
+                       colored, record.fgcolor, record.bgcolor);
+}
+
+// asynchronous mode
+
+void Log::setAsynchronous (const bool asynchronous, const size_t queueCapacity)
+{
+    std::lock_guard<std::mutex> asyncLock(_asyncMutex);
+    
+    if (asynchronous == _asynchronous.load()) {
+        return;
+    }
+    
+    if (asynchronous) {
+        
+        if (!_queue) {
+            _queue.reset(new LogQueue(queueCapacity));
+        }
+        
+        _stopWriter = false;
+        _writerThread = std::thread(&Log::writerLoop, this);
+        _asynchronous.store(true);
+        
+    } else {
+        
+        // new records will be written directly from now on
+        _asynchronous.store(false);
+        
+        {
+            std::lock_guard<std::mutex> lock(_writerMutex);
+            _stopWriter = true;
+        }
+        _writerCondition.notify_one();
+        _writerThread.join();
+        
+        // records published after the writer's last look at the queue
+        drainQueue();
+        
+        std::lock_guard<std::mutex> lock(_writerMutex);
+        _flushCondition.notify_all();
+    }
+}
+
+bool Log::asynchronous () const
+{
+    return _asynchronous.load();
+}
+
+void Log::setPerThreadQueues (const bool perThreadQueues,
+                              const size_t queueCapacity)
+{
+    _threadQueueCapacity.store(queueCapacity);
+    _perThreadQueues.store(perThreadQueues);
+}
+
+void Log::setOverflowPolicy (const LogOverflowPolicy policy,
+                              const size_t spillCapacity)
+{
+    _spillCapacity.store(spillCapacity);
+    _overflowPolicy.store(policy);
+}
+
+LogOverflowPolicy Log::overflowPolicy () const
+{
+    return _overflowPolicy.load();
+}
+
+LogOverflowStatistics Log::overflowStatistics () const
+{
+    LogOverflowStatistics statistics;
+    statistics.dropped = _droppedRecords.load();
+    statistics.overwritten = _overwrittenRecords.load();
+    statistics.blocked = _blockedCalls.load();
+    statistics.spilled = _spilledRecords.load();
+    return statistics;
+}
+
+void Log::setMetrics (const bool enabled,
+                      const unsigned int dumpIntervalMilliseconds)
+{
+    LogMetricsRecorder::setEnabled(enabled);
+    
+    int64_t interval = enabled ? (int64_t)dumpIntervalMilliseconds * 1000 : 0;
+    _nextMetricsDump.store(LogClock::now() + interval);
+    _metricsDumpInterval.store(interval);
+}
+
+bool Log::metricsEnabled () const
+{
+    return LogMetricsRecorder::enabled();
+}
+
+LogMetrics Log::metrics () const
+{
+    LogMetrics metrics;
+    LogMetricsRecorder::collect(metrics);
+    
+    std::shared_ptr<std::vector<std::shared_ptr<LogSink>>> sinks =
+        std::atomic_load(&_sinks);
+    if (sinks) {
+        for (size_t i = 0; i < sinks->size(); i++) {
+            LogSinkMetrics sink;
+            sink.sink = (*sinks)[i];
+            sink.messages = sink.sink->messages();
+            sink.bytes = sink.sink->bytes();
+            metrics.sinks.push_back(sink);
+        }
+    }
+    
+    metrics.overflow = overflowStatistics();
+    return metrics;
+}
+
+void Log::setSuppressionReportInterval (const unsigned int milliseconds)
+{
+    _suppressionReportInterval.store((int64_t)milliseconds * 1000);
+    _nextSuppressionReport.store(0);
+}
+
+void Log::setRepeatCoalescing (const unsigned int windowMilliseconds)
+{
+    std::lock_guard<std::mutex> coutLock(_cout_mutex);
+    std::lock_guard<std::mutex> cerrLock(_cerr_mutex);
+    
+    for (uint8_t stream = LogStreamOutput; stream <= LogStreamError; stream++) {
+        reportRepeats(stream, false);
+        _repeatFilters[stream]->reset();
+    }
+    
+    _repeatWindow.store((int64_t)windowMilliseconds * 1000);
+}
+
+void Log::reportSuppressedIfDue (const int64_t now, const bool writer)
+{
+    // the writer can't log through its own queue, it writes directly
+    if (!writer && _asynchronous.load(std::memory_order_relaxed)) {
+        return;
+    }
+    
+    int64_t due = _nextSuppressionReport.load(std::memory_order_relaxed);
+    if (now < due || LogCallSiteLimit::first() == nullptr ||
+        !_nextSuppressionReport.compare_exchange_strong(
+            due, now + _suppressionReportInterval.load(std::memory_order_relaxed))) {
+        return;
+    }
+    
+    LogRecord record;
+    record.stream = LogStreamError;
+    record.level = LoglevelNormal;
+    record.thread = threadNumber();
+    
+    for (LogCallSiteLimit *limit = LogCallSiteLimit::first(); limit != nullptr;
+         limit = limit->next()) {
+        uint64_t suppressed = limit->takeSuppressed();
+        if (suppressed == 0) {
+            continue;
+        }
+        
+        // only the name of the file
+        const char *file = limit->file();
+        for (const char *c = file; *c != '\0'; c++) {
+            if (*c == '/' || *c == '\\') {
+                file = c + 1;
+            }
+        }
+        
+        record.timestamp = LogClock::now();
+        record.text.clear();
+        logFormat(record.text, "{}:{}: suppressed {} similar messages",
+                  file, limit->line(), suppressed);
+        
+        std::lock_guard<std::mutex> lock(_cerr_mutex);
+        deliver(record);
+    }
+}
+
+void Log::dumpMetricsIfDue (const int64_t now)
+{
+    int64_t interval = _metricsDumpInterval.load(std::memory_order_relaxed);
+    int64_t due = _nextMetricsDump.load(std::memory_order_relaxed);
+    if (interval == 0 || now < due ||
+        !_nextMetricsDump.compare_exchange_strong(due, now + interval)) {
+        return;
+    }
+    
+    LogMetrics metrics = this->metrics();
+    
+    LogRecord record;
+    record.timestamp = now;
+    record.stream = LogStreamOutput;
+    record.level = LoglevelNormal;
+    record.fgcolor = AnsiSgrFgColorDefault;
+    record.bgcolor = AnsiSgrBgColorDefault;
+    logFormat(record.text, "log metrics: normal={} verbose={} errors={} "
+              "bytes={} queue_high_water_mark={} enqueue_ns(p50={} p99={} "
+              "max={}) flush_ns(p50={} p99={} max={}) dropped={} "
+              "overwritten={} blocked={} spilled={}",
+              metrics.messages[LoglevelNormal],
+              metrics.messages[LoglevelVerbose],
+              metrics.errorMessages,
+              metrics.bytes[LoglevelNormal] + metrics.bytes[LoglevelVerbose] +
+              metrics.errorBytes,
+              metrics.queueHighWaterMark,
+              metrics.enqueueLatency.percentile(50),
+              metrics.enqueueLatency.percentile(99),
+              metrics.enqueueLatency.max,
+              metrics.flushLatency.percentile(50),
+              metrics.flushLatency.percentile(99),
+              metrics.flushLatency.max,
+              metrics.overflow.dropped,
+              metrics.overflow.overwritten,
+              metrics.overflow.blocked,
+              metrics.overflow.spilled);
+    
+    std::lock_guard<std::mutex> lock(_cout_mutex);
+    deliver(record);
+}
+
+bool Log::perThreadQueues () const
+{
+    return _perThreadQueues.load();
+}
+
+LogThreadQueue *Log::threadQueue ()
+{
+    if (RGPLOG_LIKELY(threadQueuePointer != nullptr)) {
+        return threadQueuePointer;
+    }
+    
+    if (threadQueueRetired) {
+        return nullptr;
+    }
+    
+    // not make_shared, it would ignore the cache line alignment
+    std::shared_ptr<LogThreadQueue> queue(
+        new LogThreadQueue(_threadQueueCapacity.load()));
+    
+    {
+        // publish a new list that contains the queue
+        std::lock_guard<std::mutex> lock(_threadQueuesMutex);
+        std::shared_ptr<std::vector<std::shared_ptr<LogThreadQueue>>> queues =
+            std::make_shared<std::vector<std::shared_ptr<LogThreadQueue>>>();
+        if (_threadQueues) {
+            *queues = *_threadQueues;
+        }
+        queues->push_back(queue);
+        std::atomic_store(&_threadQueues, queues);
+    }
+    
+    threadQueueHandle.queue = queue;
+    threadQueuePointer = queue.get();
+    return threadQueuePointer;
+}
+
+void Log::removeRetiredQueues ()
+{
+    std::lock_guard<std::mutex> lock(_threadQueuesMutex);
+    if (!_threadQueues) {
+        return;
+    }
+    
+    // retired and drained -> nobody will ever write to it again
+    std::shared_ptr<std::vector<std::shared_ptr<LogThreadQueue>>> queues =
+        std::make_shared<std::vector<std::shared_ptr<LogThreadQueue>>>();
+    for (size_t i = 0; i < _threadQueues->size(); i++) {
+        const std::shared_ptr<LogThreadQueue> &queue = (*_threadQueues)[i];
+        if (!queue->retired() ||
+            queue->enqueuePosition() != queue->dequeuePosition()) {
+            queues->push_back(queue);
+        }
+    }
+    
+    if (queues->size() != _threadQueues->size()) {
+        std::atomic_store(&_threadQueues, queues);
+    }
+}
+
+bool Log::hasPendingRecords () const
+{
+    if (_queue && _queue->enqueuePosition() != _queue->dequeuePosition()) {
+        return true;
+    }
+    
+    if (_spilledRecords.load() != _spillDelivered.load()) {
+        return true;
+    }
+    
+    std::shared_ptr<std::vector<std::shared_ptr<LogThreadQueue>>> queues =
+        std::atomic_load(&_threadQueues);
+    if (queues) {
+        for (size_t i = 0; i < queues->size(); i++) {
+            if ((*queues)[i]->enqueuePosition() !=
+                (*queues)[i]->dequeuePosition()) {
+                return true;
+            }
+        }
+    }
+    
+    return false;
+}
+
+void Log::flush ()
+{
+    if (_asynchronous.load()) {
+        waitForWriter();
+    }
+    
+    if (_collecting.load()) {
+        while (collect() > 0) {
+        }
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(_cout_mutex);
+        reportRepeats(LogStreamOutput, false);
+        _logFile->flush();
+        std::cout << std::flush;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_cerr_mutex);
+        reportRepeats(LogStreamError, false);
+        _errorFile->flush();
+        std::cerr << std::flush;
+    }
+    
+    if (_hasSinks.load()) {
+        std::shared_ptr<std::vector<std::shared_ptr<LogSink>>> sinks =
+            std::atomic_load(&_sinks);
+        for (size_t i = 0; i < sinks->size(); i++) {
+            (*sinks)[i]->flush();
+        }
+    }
+    
+    LogBinary::flush();
+}
+
+void Log::waitForWriter ()
+{
+    // remember how far every queue has to be drained
+    uint64_t target = _queue->enqueuePosition();
+    uint64_t spillTarget = _spilledRecords.load();
+    std::vector<std::pair<std::shared_ptr<LogThreadQueue>, uint64_t>>
+        threadTargets;
+    std::shared_ptr<std::vector<std::shared_ptr<LogThreadQueue>>> queues =
+        std::atomic_load(&_threadQueues);
+    if (queues) {
+        for (size_t i = 0; i < queues->size(); i++) {
+            threadTargets.push_back(std::make_pair((*queues)[i],
+                (*queues)[i]->enqueuePosition()));
+        }
+    }
+    
+    std::unique_lock<std::mutex> lock(_writerMutex);
+    _flushWaiters++;
+    _writerCondition.notify_one();
+    _flushCondition.wait(lock, [this, target, spillTarget, &threadTargets] {
+        if (!_asynchronous.load()) {
+            return true;
+        }
+        // released: delivered by the writer or discarded by a producer
+        if (_queue->releasedCount() < target ||
+            _spillDelivered.load() < spillTarget) {
+            return false;
+        }
+        for (size_t i = 0; i < threadTargets.size(); i++) {
+            if (threadTargets[i].first->dequeuePosition() <
+                threadTargets[i].second) {
+                return false;
+            }
+        }
+        return true;
+    });
+    _flushWaiters--;
+    lock.unlock();
+    
+    // writer got stopped while we were waiting
+    if (!_asynchronous.load()) {
+        drainQueue();
+    }
+}
+
+void Log::shutdown ()
+{
+    setAsynchronous(false);
+    
+    // write through from now on (exit handlers and static destructors may
+    // still log)
+    {
+        std::lock_guard<std::mutex> lock(_housekeeperMutex);
+        _housekeeperState.store(kHousekeeperStopped);
+        _stopHousekeeper = true;
+    }
+    _housekeeperCondition.notify_one();
+    if (_housekeeperThread.joinable()) {
+        _housekeeperThread.join();
+    }
+    
+    // the collector writes what is left in the ring and steps down
+    if (_collectorThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(_collectorMutex);
+            _stopCollector = true;
+        }
+        _collectorCondition.notify_one();
+        _collectorThread.join();
+    }
+    
+    flush();
+    
+    // cut preallocated output to its length (the Log is never destroyed)
+    if (_hasSinks.load()) {
+        std::shared_ptr<std::vector<std::shared_ptr<LogSink>>> sinks =
+            std::atomic_load(&_sinks);
+        for (size_t i = 0; i < sinks->size(); i++) {
+            (*sinks)[i]->close();
+        }
+    }
+}
+
+// shared ring
+
+bool Log::useSharedRing (const std::string &name, const LogSharedRingRole role,
+                         const size_t slotCount, const size_t slotSize)
+{
+    std::lock_guard<std::mutex> asyncLock(_asyncMutex);
+    
+    if (_sharedRing) {
+        return false;
+    }
+    
+    std::unique_ptr<LogSharedRing> ring(LogSharedRing::open(name, slotCount,
+                                                            slotSize));
+    if (!ring) {
+        return false;
+    }
+    
+    if (role == LogSharedRingCollector) {
+        if (!ring->claimCollector()) {
+            return false;
+        }
+        _collecting.store(true);
+    }
+    
+    _sharedRing = std::move(ring);
+    _sharedRingRole = role;
+    
+    if (role != LogSharedRingProducer) {
+        _stopCollector = false;
+        _collectorThread = std::thread(&Log::collectorLoop, this);
+    }
+    
+    _sharedRingPointer.store(_sharedRing.get(), std::memory_order_release);
+    return true;
+}
+
+bool Log::removeSharedRing (const std::string &name)
+{
+    return LogSharedRing::remove(name);
+}
+
+size_t Log::collect ()
+{
+    std::lock_guard<std::mutex> collectLock(_collectMutex);
+    
+    // another process may be the collector since we stepped down
+    if (!_collecting.load()) {
+        return 0;
+    }
+    
+    static thread_local LogRecord record;
+    std::string category;
+    
+    // don't starve flush() waiters when producers never stop
+    const size_t limit = _sharedRing->capacity();
+    size_t count = 0;
+    
+    while (count < limit && _sharedRing->consume(record, category)) {
+        
+        // categories are matched by name, the indices differ per process
+        if (!category.empty()) {
+            std::unordered_map<std::string, uint16_t>::const_iterator it =
+                _ringCategories.find(category);
+            if (it == _ringCategories.end()) {
+                it = _ringCategories.insert(std::make_pair(category,
+                    LogCategory(category).index())).first;
+            }
+            record.category = it->second;
+        }
+        
+        std::mutex &mutex = record.stream == LogStreamError ?
+            _cerr_mutex : _cout_mutex;
+        std::lock_guard<std::mutex> lock(mutex);
+        deliver(record);
+        count++;
+    }
+    
+    uint64_t lost = _sharedRing->takeLost();
+    if (lost > 0) {
+        record.timestamp = LogClock::now();
+        record.stream = LogStreamOutput;
+        record.level = LoglevelNormal;
+        record.fgcolor = AnsiSgrFgColorDefault;
+        record.bgcolor = AnsiSgrBgColorDefault;
+        record.category = 0;
+        record.thread = threadNumber();
+        record.fields = 0;
+        record.text.clear();
+        logFormat(record.text, "{} messages lost (shared log ring)", lost);
+        
+        std::lock_guard<std::mutex> lock(_cout_mutex);
+        deliver(record);
+    }
+    
+    return count;
+}
+
+void Log::collectorLoop ()
+{
+    for (;;) {
+        
+        if (!_collecting.load() && _sharedRing->claimCollector()) {
+            _collecting.store(true);
+        }
+        
+        size_t count = _collecting.load() ? collect() : 0;
+        
+        if (count > 0) {
+            continue;
+        }
+        
+        // ring is empty -> good time to write the file buffers
+        if (_collecting.load()) {
+            flushLogfilesIfDue();
+        }
+        
+        std::unique_lock<std::mutex> lock(_collectorMutex);
+        if (_stopCollector) {
+            break;
+        }
+        _collectorCondition.wait_for(lock, _collecting.load() ?
+                                     kCollectorIdleTimeout :
+                                     kCollectorElectionInterval);
+    }
+    
+    while (collect() > 0) {
+    }
+    
+    std::lock_guard<std::mutex> collectLock(_collectMutex);
+    if (_collecting.load()) {
+        _collecting.store(false);
+        _sharedRing->releaseCollector();
+    }
+}
+
+size_t Log::drainQueue ()
+{
+    if (!_queue) {
+        return 0;
+    }
+    
+    std::lock_guard<std::mutex> drainLock(_drainMutex);
+    
+    std::shared_ptr<std::vector<std::shared_ptr<LogThreadQueue>>> queues =
+        std::atomic_load(&_threadQueues);
+    
+    if (LogMetricsRecorder::enabled()) {
+        uint64_t depth = _queue->enqueuePosition() - _queue->releasedCount() +
+            _spilledRecords.load() - _spillDelivered.load();
+        if (queues) {
+            for (size_t i = 0; i < queues->size(); i++) {
+                depth += (*queues)[i]->enqueuePosition() -
+                    (*queues)[i]->dequeuePosition();
+            }
+        }
+        LogMetricsRecorder::recordQueueDepth(depth);
+    }
+    
+    // don't starve flush() waiters when producers never stop
+    const size_t limit = _queue->capacity();
+    size_t count = 0;
+    bool retiredQueues = false;
+    
+    while (count < limit) {
+        
+        // merge: pick the oldest record at the front of all queues
+        // (best-effort, records that are still being queued can't be seen)
+        // (the record of the shared queue gets claimed first: producers
+        // discard its oldest records with LogOverflowDropOldest, it stays
+        // claimed till it's delivered)
+        if (_claimedRecord == nullptr) {
+            _claimedRecord = _queue->tryConsume(_claimedPosition);
+        }
+        const LogRecord *oldest = _claimedRecord;
+        LogThreadQueue *source = nullptr;
+        LogRecord *spilled = nullptr;
+        
+        if (queues) {
+            for (size_t i = 0; i < queues->size(); i++) {
+                LogThreadQueue *queue = (*queues)[i].get();
+                LogRecord *candidate = queue->front();
+                if (candidate != nullptr &&
+                    (oldest == nullptr || candidate->timestamp < oldest->timestamp)) {
+                    oldest = candidate;
+                    source = queue;
+                }
+                if (queue->retired()) {
+                    retiredQueues = true;
+                }
+            }
+        }
+        
+        if (_spilledRecords.load(std::memory_order_acquire) !=
+            _spillDelivered.load(std::memory_order_relaxed)) {
+            // (references to deque elements stay valid on push_back)
+            std::lock_guard<std::mutex> lock(_spillMutex);
+            LogRecord *candidate = &_spill->front();
+            if (oldest == nullptr || candidate->timestamp < oldest->timestamp) {
+                oldest = spilled = candidate;
+                source = nullptr;
+            }
+        }
+        
+        if (oldest == nullptr) {
+            break;
+        }
+        
+        LogRecord *record;
+        if (spilled != nullptr) {
+            record = spilled;
+        } else if (source != nullptr) {
+            record = source->front();
+        } else {
+            record = _claimedRecord;
+        }
+        
+        {
+            std::mutex &mutex = record->stream == LogStreamError ?
+                _cerr_mutex : _cout_mutex;
+            std::lock_guard<std::mutex> lock(mutex);
+            deliver(*record);
+        }
+        
+        if (spilled != nullptr) {
+            std::lock_guard<std::mutex> lock(_spillMutex);
+            _spillBytes -= spilled->text.size();
+            _spill->pop_front();
+            _spillDelivered.fetch_add(1, std::memory_order_release);
+        } else if (source != nullptr) {
+            source->pop();
+        } else {
+            _queue->release(_claimedPosition);
+            _claimedRecord = nullptr;
+        }
+        count++;
+    }
+    
+    if (retiredQueues) {
+        removeRetiredQueues();
+    }
+    
+    reportLostRecords();
+    
+    return count;
+}
+
+void Log::wakeWriter ()
+{
+    std::lock_guard<std::mutex> lock(_writerMutex);
+    _writerCondition.notify_one();
+}
+
+void Log::startHousekeeper ()
+{
+    std::lock_guard<std::mutex> lock(_housekeeperMutex);
+    if (_housekeeperState.load() != kHousekeeperIdle) {
+        return;
+    }
+    
+    _housekeeperThread = std::thread(&Log::housekeeperLoop, this);
+    _housekeeperState.store(kHousekeeperRunning);
+}
+
+void Log::housekeeperLoop ()
+{
+    std::unique_lock<std::mutex> lock(_housekeeperMutex);
+    
+    for (;;) {
+        _housekeeperCondition.wait_for(lock, kWriterIdleTimeout);
+        if (_stopHousekeeper) {
+            break;
+        }
+        
+        // the writer thread does this in asynchronous mode
+        if (_asynchronous.load()) {
+            continue;
+        }
+        
+        lock.unlock();
+        
+        // writes the repeat summaries as well
+        flushLogfilesIfDue();
+        
+        if (RGPLOG_UNLIKELY(LogCallSiteLimit::first() != nullptr)) {
+            reportSuppressedIfDue(LogClock::coarse(), false);
+        }
+        
+        lock.lock();
+    }
+}
+
+void Log::writerLoop ()
+{
+    for (;;) {
+        
+        size_t count = drainQueue();
+        
+        if (RGPLOG_UNLIKELY(_metricsDumpInterval.load(std::memory_order_relaxed) != 0)) {
+            dumpMetricsIfDue(LogClock::now());
+        }
+        
+        if (count > 0 && _flushWaiters.load() > 0) {
+            std::lock_guard<std::mutex> lock(_writerMutex);
+            _flushCondition.notify_all();
+        }
+        
+        if (count > 0) {
+            continue;
+        }
+        
+        // queue is empty -> good time to write the file buffers
+        flushLogfilesIfDue();
+        
+        if (RGPLOG_UNLIKELY(LogCallSiteLimit::first() != nullptr)) {
+            reportSuppressedIfDue(LogClock::coarse(), true);
+        }
+        
+        // go to sleep
+        std::unique_lock<std::mutex> lock(_writerMutex);
+        _flushCondition.notify_all();
+        
+        if (_stopWriter) {
+            break;
+        }
+        
+        _writerWaiting.store(true, std::memory_order_relaxed);
+        // pairs with the fence in submit()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        
+        if (!hasPendingRecords() && _flushWaiters.load() == 0) {
+            _writerCondition.wait_for(lock, kWriterIdleTimeout);
+        }
+        
+        _writerWaiting.store(false, std::memory_order_relaxed);
+    }
 }
@@ -0,0 +1,152 @@
+/*
+ RGPUtils
+ LogAligned.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ Cache line aligned allocation (C++11 new only guarantees the alignment of
+ max_align_t, so over-aligned members would not be honoured on the heap).
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogAligned_H__
+#define __RGPUtils__LogAligned_H__
+
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+
+#if defined(_WIN32)
+#include <malloc.h> // _aligned_malloc
+#endif // defined(_WIN32)
+
+namespace rgp {
+
+    /** Size of a cache line (members that are written by different
+     threads are aligned to it). */
+    static const size_t kLogCacheLineSize = 64;
+
+    /** Allocates memory with the given alignment (a power of two), throws
+     std::bad_alloc. */
+    inline void *logAlignedAllocate (const size_t size, size_t alignment)
+    {
+        if (alignment < sizeof(void *)) {
+            alignment = sizeof(void *);
+        }
+
+        void *memory = nullptr;
+#if defined(__APPLE__) || defined(__unix__)
+        if (posix_memalign(&memory, alignment, size > 0 ? size : 1) != 0) {
+            memory = nullptr;
+        }
+#elif defined(_WIN32)
+        memory = _aligned_malloc(size > 0 ? size : 1, alignment);
+#endif // defined(__APPLE__) || defined(__unix__) // defined(_WIN32)
+
+        if (memory == nullptr) {
+            throw std::bad_alloc();
+        }
+        return memory;
+    }
+
+    /** Frees memory of logAlignedAllocate(). */
+    inline void logAlignedFree (void *memory)
+    {
+#if defined(__APPLE__) || defined(__unix__)
+        free(memory);
+#elif defined(_WIN32)
+        _aligned_free(memory);
+#endif // defined(__APPLE__) || defined(__unix__) // defined(_WIN32)
+    }
+
+    /**
+     @brief Base of classes with cache line aligned members.
+     @details new and delete of the derived classes return cache line
+     aligned memory (std::make_shared doesn't use them, use shared_ptr with
+     new instead).
+     */
+    struct LogCacheAligned {
+        static void *operator new (const size_t size) {
+            return logAlignedAllocate(size, kLogCacheLineSize);
+        };
+
+        static void operator delete (void *memory) {
+            logAlignedFree(memory);
+        };
+    };
+
+    /**
+     @brief A fixed-size array with the alignment of its elements.
+     @details The elements are value-initialized.
+     */
+    template <typename T>
+    class LogAlignedArray {
+
+    public:
+        LogAlignedArray () {};
+        ~LogAlignedArray () { clear(); };
+
+        /** Replaces the elements with count new ones. */
+        void reset (const size_t count) {
+            clear();
+
+            T *items = (T *)logAlignedAllocate(sizeof(T) * count, alignof(T));
+            size_t constructed = 0;
+            try {
+                for (; constructed < count; constructed++) {
+                    new (items + constructed) T();
+                }
+            } catch (...) {
+                while (constructed > 0) {
+                    items[--constructed].~T();
+                }
+                logAlignedFree(items);
+                throw;
+            }
+
+            _items = items;
+            _count = count;
+        };
+
+        T &operator [] (const size_t index) { return _items[index]; };
+        const T &operator [] (const size_t index) const { return _items[index]; };
+
+    private:
+        LogAlignedArray (const LogAlignedArray &) = delete;
+        LogAlignedArray &operator = (const LogAlignedArray &) = delete;
+
+        void clear () {
+            for (size_t i = 0; i < _count; i++) {
+                _items[i].~T();
+            }
+            if (_items != nullptr) {
+                logAlignedFree(_items);
+            }
+            _items = nullptr;
+            _count = 0;
+        };
+
+        T *_items { nullptr };
+        size_t _count { 0 };
+    };
+}
+
+#endif // defined(__RGPUtils__LogAligned_H__) header guard
@@ -0,0 +1,656 @@
+/*
+ RGPUtils
+ LogBatchFile.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include "LogBatchFile.h"
+#include "LogFile.h"
+#include "LogMetricsRecorder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <climits> // IOV_MAX
+#include <fcntl.h>
+
+#if defined(__APPLE__) || defined(__unix__)
+#include <unistd.h>
+#include <sys/uio.h> // writev
+#include <sys/file.h> // flock
+#elif defined(_WIN32)
+#include <io.h>
+#include <sys/stat.h>
+#endif // defined(__APPLE__) || defined(__unix__) // defined(_WIN32)
+
+// io_uring is used through the raw system calls (no liburing needed)
+#if defined(__linux__) && defined(RGPLOG_USE_IO_URING)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && \
+    defined(__NR_io_uring_register)
+#define RGPLOG_HAS_IO_URING 1
+#endif // io_uring system calls
+#endif // defined(__linux__) && defined(RGPLOG_USE_IO_URING)
+
+using namespace rgp;
+
+// iovecs per writev call
+#if defined(IOV_MAX) && IOV_MAX < 64
+static const int kMaxIovecs = IOV_MAX;
+#else
+static const int kMaxIovecs = 64;
+#endif // defined(IOV_MAX) && IOV_MAX < 64
+
+// default time data may stay in the chunks
+static const std::chrono::milliseconds kDefaultFlushInterval { 1000 };
+
+static void closeDescriptor (const int fd)
+{
+#if defined(__APPLE__) || defined(__unix__)
+    ::close(fd);
+#elif defined(_WIN32)
+    ::_close(fd);
+#endif // defined(__APPLE__) || defined(__unix__) // defined(_WIN32)
+}
+
+#if defined(__APPLE__) || defined(__unix__)
+
+// writes all iovecs (handles partial writes)
+static void writeVectorsFully (const int fd, iovec *vectors, int count)
+{
+    while (count > 0) {
+        ssize_t written = ::writev(fd, vectors, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // nowhere to report this -> drop the data
+            return;
+        }
+
+        while (count > 0 && (size_t)written >= vectors->iov_len) {
+            written -= (ssize_t)vectors->iov_len;
+            vectors++;
+            count--;
+        }
+        if (count > 0) {
+            vectors->iov_base = (char *)vectors->iov_base + written;
+            vectors->iov_len -= (size_t)written;
+        }
+    }
+}
+
+#elif defined(_WIN32)
+
+static void writeFully (const int fd, const char *data, size_t length)
+{
+    while (length > 0) {
+        int written = ::_write(fd, data, (unsigned int)length);
+        if (written < 0) {
+            return;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+}
+
+#endif // defined(__APPLE__) || defined(__unix__) // defined(_WIN32)
+
+#ifdef RGPLOG_HAS_IO_URING
+
+namespace rgp {
+
+    // a minimal io_uring: writes of the chunks, the index of the chunk is
+    // the user data of the completion
+    class LogUring {
+
+    public:
+        ~LogUring ();
+
+        // sets up a ring, nullptr if the kernel doesn't allow it
+        static LogUring *create (const unsigned int entries,
+                                 std::vector<iovec> &buffers);
+
+        // queues a write, false if the submission queue is full
+        bool prepareWrite (const int fd, const unsigned int chunk,
+                           const char *data, const size_t length,
+                           const uint64_t offset);
+
+        // submits the queued writes and waits for minComplete completions
+        bool enter (const unsigned int minComplete);
+
+        // takes the next completion, false if there is none
+        bool complete (unsigned int &chunk, int &result);
+
+    private:
+        LogUring () {};
+
+        int _fd { -1 };
+        bool _registered { false };
+
+        void *_sqRing { MAP_FAILED };
+        size_t _sqRingSize { 0 };
+        void *_cqRing { MAP_FAILED };
+        size_t _cqRingSize { 0 };
+        io_uring_sqe *_sqes { static_cast<io_uring_sqe *>(MAP_FAILED) };
+        size_t _sqesSize { 0 };
+
+        unsigned int *_sqHead { nullptr };
+        unsigned int *_sqTail { nullptr };
+        unsigned int *_sqMask { nullptr };
+        unsigned int *_sqArray { nullptr };
+        unsigned int _sqEntries { 0 };
+        unsigned int _toSubmit { 0 };
+
+        unsigned int *_cqHead { nullptr };
+        unsigned int *_cqTail { nullptr };
+        unsigned int *_cqMask { nullptr };
+        io_uring_cqe *_cqes { nullptr };
+    };
+}
+
+LogUring::~LogUring ()
+{
+    if (_sqes != MAP_FAILED) {
+        munmap(_sqes, _sqesSize);
+    }
+    if (_cqRing != MAP_FAILED && _cqRing != _sqRing) {
+        munmap(_cqRing, _cqRingSize);
+    }
+    if (_sqRing != MAP_FAILED) {
+        munmap(_sqRing, _sqRingSize);
+    }
+    if (_fd >= 0) {
+        ::close(_fd);
+    }
+}
+
+LogUring *LogUring::create (const unsigned int entries,
+                            std::vector<iovec> &buffers)
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    // fails with ENOSYS / EPERM if the kernel (or a seccomp filter) says no
+    int fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    std::unique_ptr<LogUring> ring(new LogUring());
+    ring->_fd = fd;
+
+    ring->_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    ring->_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMap) {
+        ring->_sqRingSize = std::max(ring->_sqRingSize, ring->_cqRingSize);
+    }
+
+    ring->_sqRing = mmap(nullptr, ring->_sqRingSize, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (ring->_sqRing == MAP_FAILED) {
+        return nullptr;
+    }
+
+    if (singleMap) {
+        ring->_cqRing = ring->_sqRing;
+    } else {
+        ring->_cqRing = mmap(nullptr, ring->_cqRingSize, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (ring->_cqRing == MAP_FAILED) {
+            return nullptr;
+        }
+    }
+
+    ring->_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    ring->_sqes = static_cast<io_uring_sqe *>(
+        mmap(nullptr, ring->_sqesSize, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+    if (ring->_sqes == MAP_FAILED) {
+        return nullptr;
+    }
+
+    char *sq = static_cast<char *>(ring->_sqRing);
+    ring->_sqHead = reinterpret_cast<unsigned int *>(sq + params.sq_off.head);
+    ring->_sqTail = reinterpret_cast<unsigned int *>(sq + params.sq_off.tail);
+    ring->_sqMask = reinterpret_cast<unsigned int *>(sq + params.sq_off.ring_mask);
+    ring->_sqArray = reinterpret_cast<unsigned int *>(sq + params.sq_off.array);
+    ring->_sqEntries = params.sq_entries;
+
+    char *cq = static_cast<char *>(ring->_cqRing);
+    ring->_cqHead = reinterpret_cast<unsigned int *>(cq + params.cq_off.head);
+    ring->_cqTail = reinterpret_cast<unsigned int *>(cq + params.cq_off.tail);
+    ring->_cqMask = reinterpret_cast<unsigned int *>(cq + params.cq_off.ring_mask);
+    ring->_cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+    // registered buffers save the page pinning on every write, they may
+    // exceed RLIMIT_MEMLOCK on older kernels -> plain writes then
+    ring->_registered = syscall(__NR_io_uring_register, fd,
+                                IORING_REGISTER_BUFFERS, buffers.data(),
+                                (unsigned int)buffers.size()) == 0;
+
+    return ring.release();
+}
+
+bool LogUring::prepareWrite (const int fd, const unsigned int chunk,
+                             const char *data, const size_t length,
+                             const uint64_t offset)
+{
+    unsigned int tail = *_sqTail;
+    if (tail - __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE) == _sqEntries) {
+        return false;
+    }
+
+    unsigned int index = tail & *_sqMask;
+    io_uring_sqe *sqe = &_sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+
+    sqe->opcode = _registered ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)data;
+    sqe->len = (uint32_t)length;
+    sqe->off = offset;
+    sqe->buf_index = _registered ? (uint16_t)chunk : 0;
+    sqe->user_data = chunk;
+
+    _sqArray[index] = index;
+    __atomic_store_n(_sqTail, tail + 1, __ATOMIC_RELEASE);
+    _toSubmit++;
+    return true;
+}
+
+bool LogUring::enter (const unsigned int minComplete)
+{
+    for (;;) {
+        long result = syscall(__NR_io_uring_enter, _fd, _toSubmit, minComplete,
+                              minComplete > 0 ? IORING_ENTER_GETEVENTS : 0,
+                              nullptr, 0);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        _toSubmit -= (unsigned int)result;
+        if (_toSubmit == 0) {
+            return true;
+        }
+        if (result == 0) {
+            // the kernel takes nothing anymore
+            return false;
+        }
+    }
+}
+
+bool LogUring::complete (unsigned int &chunk, int &result)
+{
+    unsigned int head = *_cqHead;
+    if (head == __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+
+    const io_uring_cqe &cqe = _cqes[head & *_cqMask];
+    chunk = (unsigned int)cqe.user_data;
+    result = cqe.res;
+
+    __atomic_store_n(_cqHead, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+#endif // RGPLOG_HAS_IO_URING
+
+LogBatchFile::LogBatchFile (const size_t chunkSize, const size_t chunkCount)
+    : _chunks(std::max<size_t>(chunkCount, 2)),
+      _chunkSize(std::max<size_t>(chunkSize, 1)),
+      _flushInterval(kDefaultFlushInterval),
+      _lastFlush(std::chrono::steady_clock::now())
+{
+    for (size_t i = 0; i < _chunks.size(); i++) {
+        _chunks[i].data.reset(new char[_chunkSize]);
+    }
+}
+
+LogBatchFile::~LogBatchFile ()
+{
+    close();
+}
+
+bool LogBatchFile::open (const std::string &path, const LogBatchBackend backend)
+{
+    close();
+
+#ifdef RGPLOG_HAS_IO_URING
+    if (backend != LogBatchBackendWritev) {
+
+        // no O_APPEND: every chunk gets its own offset, writes that are in
+        // flight at the same time would be appended in random order
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+
+        // so the file must not have other writers: appenders of this
+        // library hold a shared lock, if there is one -> writev
+        if (::flock(fd, LOCK_EX | LOCK_NB) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+
+        std::vector<iovec> buffers(_chunks.size());
+        for (size_t i = 0; i < _chunks.size(); i++) {
+            buffers[i].iov_base = _chunks[i].data.get();
+            buffers[i].iov_len = _chunkSize;
+        }
+
+        off_t end = fd >= 0 ? lseek(fd, 0, SEEK_END) : -1;
+        if (end >= 0) {
+            _uring.reset(LogUring::create((unsigned int)_chunks.size(), buffers));
+        }
+
+        if (_uring) {
+            _fd = fd;
+            _offset = (uint64_t)end;
+            _lastFlush = std::chrono::steady_clock::now();
+            return true;
+        }
+
+        // io_uring is not available (or the file is shared) -> writev
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+#else
+    (void)backend;
+#endif // RGPLOG_HAS_IO_URING
+
+    int fd = LogFile::openForAppending(path);
+    if (fd < 0) {
+        return false;
+    }
+
+    _fd = fd;
+    _lastFlush = std::chrono::steady_clock::now();
+    return true;
+}
+
+void LogBatchFile::close ()
+{
+    if (_fd < 0) {
+        return;
+    }
+
+    flush();
+    _uring.reset();
+    closeDescriptor(_fd);
+    _fd = -1;
+
+    _head = _submitted = _current = 0;
+    for (size_t i = 0; i < _chunks.size(); i++) {
+        _chunks[i].used = 0;
+    }
+}
+
+LogBatchBackend LogBatchFile::backend () const
+{
+    return _uring ? LogBatchBackendIoUring : LogBatchBackendWritev;
+}
+
+void LogBatchFile::append (const char *data, size_t length)
+{
+    if (_fd < 0) {
+        return;
+    }
+
+    while (length > 0) {
+        Chunk &current = chunk(_current);
+        size_t count = std::min(length, _chunkSize - current.used);
+        memcpy(current.data.get() + current.used, data, count);
+        current.used += count;
+        data += count;
+        length -= count;
+
+        if (current.used == _chunkSize) {
+            nextChunk();
+        }
+    }
+}
+
+void LogBatchFile::flush ()
+{
+    if (_fd < 0) {
+        return;
+    }
+
+    commit(true);
+    while (_uring && _head < _submitted) {
+        reap(true);
+    }
+
+    _lastFlush = std::chrono::steady_clock::now();
+}
+
+void LogBatchFile::flushIfDue ()
+{
+    if (_fd < 0) {
+        return;
+    }
+
+    // hand finished chunks back
+    if (_uring) {
+        reap(false);
+    }
+
+    if (_submitted == _current && chunk(_current).used == 0) {
+        return;
+    }
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now - _lastFlush >= _flushInterval) {
+        commit(true);
+        _lastFlush = now;
+    }
+}
+
+void LogBatchFile::commit (const bool partial)
+{
+    uint64_t start = LogMetricsRecorder::enabled() ? LogMetricsRecorder::now() : 0;
+
+    if (_uring) {
+        commitUring(partial);
+    } else {
+        commitWritev(partial);
+    }
+
+    if (start != 0) {
+        LogMetricsRecorder::recordFlush(LogMetricsRecorder::now() - start);
+    }
+}
+
+void LogBatchFile::nextChunk ()
+{
+    _current++;
+
+    if (_uring) {
+        // the full chunk goes to the kernel right away
+        commit(false);
+    } else if (_current - _head == _chunks.size()) {
+        // all chunks are full -> one writev for all of them
+        commit(false);
+    }
+}
+
+void LogBatchFile::commitWritev (const bool partial)
+{
+    uint64_t end = _current;
+    if (partial && chunk(_current).used > 0) {
+        end++;
+    }
+
+    if (_submitted == end) {
+        return;
+    }
+
+#if defined(__APPLE__) || defined(__unix__)
+    uint64_t position = _submitted;
+    while (position < end) {
+        iovec vectors[kMaxIovecs];
+        int count = 0;
+        for (; position < end && count < kMaxIovecs; position++, count++) {
+            vectors[count].iov_base = chunk(position).data.get();
+            vectors[count].iov_len = chunk(position).used;
+        }
+        writeVectorsFully(_fd, vectors, count);
+    }
+#elif defined(_WIN32)
+    for (uint64_t position = _submitted; position < end; position++) {
+        writeFully(_fd, chunk(position).data.get(), chunk(position).used);
+    }
+#endif // defined(__APPLE__) || defined(__unix__) // defined(_WIN32)
+
+    for (uint64_t position = _submitted; position < end; position++) {
+        chunk(position).used = 0;
+    }
+
+    // the current chunk is empty now (written or reused)
+    _head = _submitted = _current;
+}
+
+void LogBatchFile::commitUring (const bool partial)
+{
+#ifdef RGPLOG_HAS_IO_URING
+    if (partial && chunk(_current).used > 0) {
+        _current++;
+    }
+
+    if (_submitted == _current) {
+        return;
+    }
+
+    for (; _submitted < _current; _submitted++) {
+        Chunk &full = chunk(_submitted);
+        full.offset = _offset;
+        full.inFlight = true;
+        _offset += full.used;
+
+        // never full: the queue has an entry for every chunk
+        _uring->prepareWrite(_fd, (unsigned int)(_submitted % _chunks.size()),
+                             full.data.get(), full.used, full.offset);
+    }
+
+    if (!_uring->enter(0)) {
+        fallBackToWritev();
+        return;
+    }
+
+    // the next chunk has to be back from the kernel before it gets filled
+    while (_uring && _current - _head == _chunks.size()) {
+        reap(true);
+    }
+#else
+    (void)partial;
+#endif // RGPLOG_HAS_IO_URING
+}
+
+void LogBatchFile::reap (const bool wait)
+{
+#ifdef RGPLOG_HAS_IO_URING
+    if (wait && !_uring->enter(1)) {
+        fallBackToWritev();
+        return;
+    }
+
+    unsigned int index;
+    int result;
+    while (_uring->complete(index, result)) {
+        Chunk &done = _chunks[index];
+
+        if (result < 0) {
+            // f.e. IORING_OP_WRITE is not supported -> write it ourselves
+            writeAt(done.data.get(), done.used, done.offset);
+        } else if ((size_t)result < done.used) {
+            // short write -> the rest
+            writeAt(done.data.get() + result, done.used - (size_t)result,
+                    done.offset + (uint64_t)result);
+        }
+
+        done.inFlight = false;
+    }
+
+    // completions may come in any order, chunks are reused in ring order
+    while (_head < _submitted && !chunk(_head).inFlight) {
+        chunk(_head).used = 0;
+        _head++;
+    }
+#else
+    (void)wait;
+#endif // RGPLOG_HAS_IO_URING
+}
+
+void LogBatchFile::fallBackToWritev ()
+{
+#ifdef RGPLOG_HAS_IO_URING
+    // closing the ring cancels what is left, so write everything that may
+    // still be in flight again (same data at the same offsets, harmless if
+    // it got written already)
+    _uring.reset();
+
+    for (uint64_t position = _head; position < _submitted; position++) {
+        Chunk &pending = chunk(position);
+        writeAt(pending.data.get(), pending.used, pending.offset);
+        pending.used = 0;
+        pending.inFlight = false;
+    }
+    _head = _submitted;
+
+    // writev continues at the end of our data
+    lseek(_fd, (off_t)_offset, SEEK_SET);
+#endif // RGPLOG_HAS_IO_URING
+}
+
+void LogBatchFile::writeAt (const char *data, size_t length, uint64_t offset)
+{
+#if defined(__APPLE__) || defined(__unix__)
+    while (length > 0) {
+        ssize_t written = ::pwrite(_fd, data, length, (off_t)offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // nowhere to report this -> drop the data
+            return;
+        }
+        data += written;
+        length -= (size_t)written;
+        offset += (uint64_t)written;
+    }
+#else
+    (void)data;
+    (void)length;
+    (void)offset;
+#endif // defined(__APPLE__) || defined(__unix__)
+}
@@ -0,0 +1,162 @@
+/*
+ RGPUtils
+ LogBatchFile.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ A logfile that collects lines in large chunks and writes many chunks per
+ system call (writev or io_uring).
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogBatchFile_H__
+#define __RGPUtils__LogBatchFile_H__
+
+#include <rgp/LogSink.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace rgp {
+
+    class LogUring;
+
+    /**
+     @brief A logfile written in chunks.
+     @details Lines are copied into a ring of chunks. A full chunk is not
+     written on its own:
+     - writev: all chunks are collected and written with one writev() when
+       the ring is full (or on flush).
+     - io_uring: every full chunk is submitted at once and stays in flight
+       while the next chunks are filled. The chunks are registered with the
+       kernel, writes use explicit file offsets so they land in order even if
+       they complete out of order. That requires the file for itself: it is
+       locked exclusively (flock), if another appender of this library holds
+       it writev is used.
+     The class is not thread-safe (LogBatchFileSink locks its mutex).
+     */
+    class LogBatchFile {
+
+    public:
+        /**
+         @brief Creates the chunks.
+         @param chunkSize Size of every chunk.
+         @param chunkCount Number of chunks (at least 2).
+         */
+        LogBatchFile (const size_t chunkSize, const size_t chunkCount);
+        ~LogBatchFile ();
+
+        /**
+         @brief Opens the file for appending.
+         @details LogBatchBackendAuto and LogBatchBackendIoUring use io_uring
+         if the kernel allows it and writev otherwise.
+         @param path The path to the file.
+         @param backend The requested backend.
+         @return True on success.
+         */
+        bool open (const std::string &path, const LogBatchBackend backend);
+
+        /** Writes everything and closes the file. */
+        void close ();
+
+        /** Determines if there is an open file. */
+        bool isOpen () const { return _fd >= 0; };
+
+        /** The backend in use (writev if no file is open). */
+        LogBatchBackend backend () const;
+
+        /** Appends data (data larger than a chunk is split). */
+        void append (const char *data, size_t length);
+
+        /** Writes everything and waits till the kernel has it. */
+        void flush ();
+
+        /** Writes the collected data if the flush interval has passed. */
+        void flushIfDue ();
+
+        /** Sets the maximum time data may stay in the chunks. */
+        void setFlushInterval (const std::chrono::milliseconds interval) {
+            _flushInterval = interval;
+        };
+
+    private:
+        LogBatchFile (const LogBatchFile &) = delete;
+        LogBatchFile &operator = (const LogBatchFile &) = delete;
+
+        struct Chunk {
+            std::unique_ptr<char[]> data;
+            size_t used { 0 };
+            bool inFlight { false };
+            // file offset of the io_uring write
+            uint64_t offset { 0 };
+        };
+
+        Chunk &chunk (const uint64_t position) {
+            return _chunks[position % _chunks.size()];
+        };
+
+        // hands the chunks [_submitted, _current) to the backend, includes
+        // the current chunk if it is not empty and partial is set
+        void commit (const bool partial);
+
+        // writes the chunks with writev (synchronous)
+        void commitWritev (const bool partial);
+
+        // submits the chunks to the io_uring (asynchronous)
+        void commitUring (const bool partial);
+
+        // moves to the next chunk, waits for it if it is still in flight
+        void nextChunk ();
+
+        // marks finished io_uring writes, waits for one if wait is set
+        void reap (const bool wait);
+
+        // drops the io_uring after an error, rewrites what was in flight
+        void fallBackToWritev ();
+
+        // writes data at offset with pwrite (rest of a short io_uring write)
+        void writeAt (const char *data, size_t length, uint64_t offset);
+
+        std::vector<Chunk> _chunks;
+        const size_t _chunkSize;
+
+        // ring positions: [_head, _submitted) in flight,
+        // [_submitted, _current) full, _current is being filled
+        uint64_t _head { 0 };
+        uint64_t _submitted { 0 };
+        uint64_t _current { 0 };
+
+        int _fd { -1 };
+        std::unique_ptr<LogUring> _uring;
+
+        // file offset of the next io_uring write
+        uint64_t _offset { 0 };
+
+        std::chrono::milliseconds _flushInterval;
+        std::chrono::steady_clock::time_point _lastFlush;
+    };
+}
+
+#endif // defined(__RGPUtils__LogBatchFile_H__) header guard
@@ -0,0 +1,308 @@
+/*
+ RGPUtils
+ LogBinary.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/LogBinary.h>
+
+#include "LogFile.h"
+#include "LogClock.h"
+
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+using namespace rgp;
+
+/*
+ File format (host byte order):
+ "RGPBLOG1"                  starts a session (call site ids are per session)
+ chunks: kind (1 byte), payload length (uint32), payload
+   'S' call site: id (uint32), line (uint32), file, format, types
+                  (the strings are terminated with \0)
+   'B' buffer:    thread (uint32), records
+ record: call site id (uint32), timestamp (int64), arguments
+*/
+
+static const char kSessionMagic[] = "RGPBLOG1";
+static const char kChunkCallSite = 'S';
+static const char kChunkBuffer = 'B';
+
+// initial size of every thread buffer
+static const size_t kThreadBufferSize = 64 * 1024;
+
+std::atomic<bool> LogBinary::_enabled { false };
+
+namespace {
+
+    struct CallSite {
+        uint32_t line;
+        std::string file;
+        std::string format;
+        std::string types;
+    };
+
+    struct ThreadBuffer {
+        std::mutex mutex;
+        std::unique_ptr<char[]> data;
+        size_t capacity { 0 };
+        size_t used { 0 };
+        uint32_t thread { 0 };
+    };
+
+    // the file, the call sites and the buffers of all threads
+    // (lock order: ThreadBuffer::mutex before BinaryState::mutex)
+    struct BinaryState {
+        std::mutex mutex;
+        LogFile file;
+        std::vector<CallSite> callSites;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        uint32_t nextThread { 1 };
+    };
+
+    // never destroyed: threads may still log while the process exits
+    BinaryState &state ()
+    {
+        static BinaryState *binaryState = new BinaryState();
+        return *binaryState;
+    }
+
+    // writes a chunk header (BinaryState::mutex has to be locked)
+    void writeChunkHeader (BinaryState &binaryState, const char kind,
+                           const uint32_t length)
+    {
+        char header[1 + sizeof(uint32_t)];
+        header[0] = kind;
+        memcpy(header + 1, &length, sizeof(length));
+        binaryState.file.write(header, sizeof(header));
+    }
+
+    // writes a call site chunk (BinaryState::mutex has to be locked)
+    void writeCallSite (BinaryState &binaryState, const uint32_t id,
+                        const CallSite &callSite)
+    {
+        uint32_t length = (uint32_t)(2 * sizeof(uint32_t) +
+                                     callSite.file.size() + 1 +
+                                     callSite.format.size() + 1 +
+                                     callSite.types.size() + 1);
+
+        writeChunkHeader(binaryState, kChunkCallSite, length);
+        binaryState.file.write((const char *)&id, sizeof(id));
+        binaryState.file.write((const char *)&callSite.line,
+                               sizeof(callSite.line));
+        binaryState.file.write(callSite.file.c_str(), callSite.file.size() + 1);
+        binaryState.file.write(callSite.format.c_str(),
+                               callSite.format.size() + 1);
+        binaryState.file.write(callSite.types.c_str(), callSite.types.size() + 1);
+    }
+
+    // writes the buffer to the file (the buffer has to be locked)
+    void writeBuffer (ThreadBuffer &buffer)
+    {
+        if (buffer.used == 0) {
+            return;
+        }
+
+        BinaryState &binaryState = state();
+        std::lock_guard<std::mutex> lock(binaryState.mutex);
+
+        if (binaryState.file.isOpen()) {
+            writeChunkHeader(binaryState, kChunkBuffer,
+                             (uint32_t)(sizeof(uint32_t) + buffer.used));
+            binaryState.file.write((const char *)&buffer.thread,
+                                   sizeof(buffer.thread));
+            binaryState.file.write(buffer.data.get(), buffer.used);
+        }
+
+        buffer.used = 0;
+    }
+
+    // fast access to the buffer of the thread (a plain pointer doesn't need
+    // the initialization check of the handle)
+    thread_local ThreadBuffer *threadBufferPointer = nullptr;
+
+    // owns the buffer of a thread, writes and unregisters it on thread exit
+    struct ThreadHandle {
+        std::shared_ptr<ThreadBuffer> buffer;
+
+        ~ThreadHandle () {
+            if (!buffer) {
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(buffer->mutex);
+                writeBuffer(*buffer);
+            }
+
+            threadBufferPointer = nullptr;
+
+            BinaryState &binaryState = state();
+            std::lock_guard<std::mutex> lock(binaryState.mutex);
+            binaryState.buffers.erase(std::remove(binaryState.buffers.begin(),
+                                                  binaryState.buffers.end(),
+                                                  buffer),
+                                      binaryState.buffers.end());
+        }
+    };
+
+    thread_local ThreadHandle threadHandle;
+
+    // the buffer of the calling thread (registered on first use)
+    ThreadBuffer &threadBuffer ()
+    {
+        if (RGPLOG_LIKELY(threadBufferPointer != nullptr)) {
+            return *threadBufferPointer;
+        }
+
+        if (!threadHandle.buffer) {
+            std::shared_ptr<ThreadBuffer> buffer = std::make_shared<ThreadBuffer>();
+            buffer->data.reset(new char[kThreadBufferSize]);
+            buffer->capacity = kThreadBufferSize;
+
+            BinaryState &binaryState = state();
+            std::lock_guard<std::mutex> lock(binaryState.mutex);
+            buffer->thread = binaryState.nextThread++;
+            binaryState.buffers.push_back(buffer);
+
+            threadHandle.buffer = buffer;
+        }
+
+        threadBufferPointer = threadHandle.buffer.get();
+        return *threadBufferPointer;
+    }
+}
+
+bool LogBinary::open (const std::string &filePath)
+{
+    close();
+
+    BinaryState &binaryState = state();
+    std::lock_guard<std::mutex> lock(binaryState.mutex);
+
+    if (!binaryState.file.open(filePath)) {
+        return false;
+    }
+
+    // start a new session, repeat the call sites that are already known
+    binaryState.file.write(kSessionMagic, sizeof(kSessionMagic) - 1);
+    for (size_t i = 0; i < binaryState.callSites.size(); i++) {
+        writeCallSite(binaryState, (uint32_t)(i + 1), binaryState.callSites[i]);
+    }
+
+    _enabled.store(true);
+    return true;
+}
+
+void LogBinary::close ()
+{
+    _enabled.store(false);
+    flush();
+
+    BinaryState &binaryState = state();
+    std::lock_guard<std::mutex> lock(binaryState.mutex);
+    binaryState.file.close();
+}
+
+void LogBinary::flush ()
+{
+    BinaryState &binaryState = state();
+
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(binaryState.mutex);
+        buffers = binaryState.buffers;
+    }
+
+    for (size_t i = 0; i < buffers.size(); i++) {
+        std::lock_guard<std::mutex> lock(buffers[i]->mutex);
+        writeBuffer(*buffers[i]);
+    }
+
+    std::lock_guard<std::mutex> lock(binaryState.mutex);
+    binaryState.file.flush();
+}
+
+uint32_t LogBinary::registerCallSite (std::atomic<uint32_t> &callSite,
+                                      const char *file, const int line,
+                                      const char *format, const char *types)
+{
+    BinaryState &binaryState = state();
+    std::lock_guard<std::mutex> lock(binaryState.mutex);
+
+    // another thread may have been faster
+    uint32_t id = callSite.load(std::memory_order_acquire);
+    if (id != 0) {
+        return id;
+    }
+
+    CallSite site;
+    site.line = (uint32_t)line;
+    site.file = file;
+    site.format = format;
+    site.types = types;
+    binaryState.callSites.push_back(site);
+
+    id = (uint32_t)binaryState.callSites.size();
+    if (binaryState.file.isOpen()) {
+        writeCallSite(binaryState, id, site);
+    }
+
+    callSite.store(id, std::memory_order_release);
+    return id;
+}
+
+char *LogBinary::reserve (const size_t length)
+{
+    ThreadBuffer &buffer = threadBuffer();
+    buffer.mutex.lock();
+
+    if (buffer.used + length > buffer.capacity) {
+        writeBuffer(buffer);
+
+        // a single record larger than the buffer -> grow the buffer
+        if (length > buffer.capacity) {
+            buffer.data.reset(new char[length]);
+            buffer.capacity = length;
+        }
+    }
+
+    return buffer.data.get() + buffer.used;
+}
+
+void LogBinary::commit (const size_t length)
+{
+    ThreadBuffer &buffer = *threadBufferPointer;
+    buffer.used += length;
+    buffer.mutex.unlock();
+}
+
+char *LogBinary::encodeHeader (char *out, const uint32_t id)
+{
+    int64_t timestamp = LogClock::now();
+    memcpy(out, &id, sizeof(id));
+    memcpy(out + sizeof(id), &timestamp, sizeof(timestamp));
+    return out + kHeaderSize;
+}
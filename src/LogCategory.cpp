@@ -0,0 +1,118 @@
+/*
+ RGPUtils
+ LogCategory.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/LogCategory.h>
+
+#include <atomic>
+#include <mutex>
+
+using namespace rgp;
+
+namespace {
+
+    // names by index (written once before the count is raised)
+    struct Registry {
+        std::mutex mutex;
+        std::string names[kLogCategoryCount];
+        std::atomic<size_t> count { 1 };
+    };
+
+    // never deleted, categories may be used during static destruction
+    Registry &registry ()
+    {
+        static Registry *registry = new Registry();
+        return *registry;
+    }
+}
+
+LogCategory::LogCategory (const std::string &name) : _index(0)
+{
+    Registry &categories = registry();
+    std::unique_lock<std::mutex> lock(categories.mutex);
+
+    size_t count = categories.count.load(std::memory_order_relaxed);
+    for (size_t i = 1; i < count; i++) {
+        if (categories.names[i] == name) {
+            _index = (uint16_t)i;
+            return;
+        }
+    }
+
+    if (count == kLogCategoryCount) {
+        // table is full -> use the global category
+        return;
+    }
+
+    categories.names[count] = name;
+    categories.count.store(count + 1, std::memory_order_release);
+    _index = (uint16_t)count;
+    lock.unlock();
+
+    // new categories follow the global loglevel
+    Log::sharedLog()->setCategoryLoglevel(_index, LoglevelNormal, false);
+}
+
+const std::string &LogCategory::name () const
+{
+    return nameOf(_index);
+}
+
+void LogCategory::setLoglevel (const Loglevel level) const
+{
+    Log::sharedLog()->setCategoryLoglevel(_index, level, true);
+}
+
+Loglevel LogCategory::loglevel () const
+{
+    return Log::_levels[_index].value.load(std::memory_order_relaxed);
+}
+
+void LogCategory::followGlobalLoglevel () const
+{
+    if (_index != 0) {
+        Log::sharedLog()->setCategoryLoglevel(_index, LoglevelNormal, false);
+    }
+}
+
+std::vector<std::string> LogCategory::names ()
+{
+    Registry &categories = registry();
+    std::lock_guard<std::mutex> lock(categories.mutex);
+
+    size_t count = categories.count.load(std::memory_order_relaxed);
+    return std::vector<std::string>(categories.names + 1,
+                                    categories.names + count);
+}
+
+const std::string &LogCategory::nameOf (const uint16_t index)
+{
+    Registry &categories = registry();
+
+    if (index >= categories.count.load(std::memory_order_acquire)) {
+        return categories.names[0];
+    }
+    return categories.names[index];
+}
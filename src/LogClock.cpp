@@ -0,0 +1,182 @@
+/*
+ RGPUtils
+ LogClock.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include "LogClock.h"
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <cstring>
+
+#if defined(__linux__)
+#include <time.h> // clock_gettime
+#endif // defined(__linux__)
+
+using namespace rgp;
+
+// length of "2026-10-18T09:15:02"
+static const size_t kSecondsLength = 19;
+
+// how often the offset to the wall clock is measured again (monotonic
+// microseconds)
+static const int64_t kCalibrationInterval = 1000000;
+
+// offset between the monotonic clock and the wall clock (microseconds) and
+// the monotonic time of the next calibration (constant initialized, usable
+// before main())
+static std::atomic<int64_t> wallClockOffset { 0 };
+static std::atomic<int64_t> nextCalibration { INT64_MIN };
+
+// writes value as zero padded decimal number with the given width
+static void writeDigits (char *out, unsigned int value, size_t width)
+{
+    while (width > 0) {
+        out[--width] = (char)('0' + value % 10);
+        value /= 10;
+    }
+}
+
+int64_t LogClock::now ()
+{
+    using namespace std::chrono;
+
+    int64_t steady =
+        duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+
+    // follow steps of the wall clock (NTP, manual changes, suspend)
+    // (the offset is stored before the next calibration time is released)
+    if (steady >= nextCalibration.load(std::memory_order_acquire)) {
+        int64_t offset =
+            duration_cast<microseconds>(system_clock::now().time_since_epoch()).count() -
+            steady;
+        wallClockOffset.store(offset, std::memory_order_relaxed);
+        nextCalibration.store(steady + kCalibrationInterval,
+                              std::memory_order_release);
+        return steady + offset;
+    }
+
+    return steady + wallClockOffset.load(std::memory_order_relaxed);
+}
+
+int64_t LogClock::coarse ()
+{
+#if defined(__linux__) && defined(CLOCK_MONOTONIC_COARSE)
+    timespec time;
+    if (clock_gettime(CLOCK_MONOTONIC_COARSE, &time) == 0) {
+        return (int64_t)time.tv_sec * 1000000 + time.tv_nsec / 1000;
+    }
+#endif // defined(__linux__) && defined(CLOCK_MONOTONIC_COARSE)
+
+    using namespace std::chrono;
+
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void LogClock::format (const int64_t microseconds, char *out)
+{
+    // formatted date and time of the last second this thread has seen
+    static thread_local int64_t cachedSecond = -1;
+    static thread_local char cachedText[kSecondsLength];
+
+    int64_t second = microseconds / 1000000;
+    int64_t fraction = microseconds % 1000000;
+    if (fraction < 0) {
+        fraction += 1000000;
+        second--;
+    }
+
+    if (second != cachedSecond) {
+
+        time_t timestamp = (time_t)second;
+        tm localTime;
+#if defined(_WIN32)
+        localtime_s(&localTime, &timestamp);
+#else
+        localtime_r(&timestamp, &localTime);
+#endif // defined(_WIN32)
+
+        writeDigits(cachedText, (unsigned int)(localTime.tm_year + 1900), 4);
+        cachedText[4] = '-';
+        writeDigits(cachedText + 5, (unsigned int)(localTime.tm_mon + 1), 2);
+        cachedText[7] = '-';
+        writeDigits(cachedText + 8, (unsigned int)localTime.tm_mday, 2);
+        cachedText[10] = 'T';
+        writeDigits(cachedText + 11, (unsigned int)localTime.tm_hour, 2);
+        cachedText[13] = ':';
+        writeDigits(cachedText + 14, (unsigned int)localTime.tm_min, 2);
+        cachedText[16] = ':';
+        writeDigits(cachedText + 17, (unsigned int)localTime.tm_sec, 2);
+
+        cachedSecond = second;
+    }
+
+    memcpy(out, cachedText, kSecondsLength);
+    out[kSecondsLength] = '.';
+    writeDigits(out + kSecondsLength + 1, (unsigned int)fraction, 6);
+}
+
+void LogClock::formatUtc (const int64_t microseconds, char *out)
+{
+    int64_t second = microseconds / 1000000;
+    int64_t fraction = microseconds % 1000000;
+    if (fraction < 0) {
+        fraction += 1000000;
+        second--;
+    }
+
+    int64_t days = second / 86400;
+    int64_t secondOfDay = second % 86400;
+    if (secondOfDay < 0) {
+        secondOfDay += 86400;
+        days--;
+    }
+
+    // civil date from days since 1970-01-01 (Howard Hinnant's algorithm)
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const int64_t dayOfEra = days - era * 146097;
+    const int64_t yearOfEra =
+        (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const int64_t monthIndex = (5 * dayOfYear + 2) / 153;
+    const int64_t day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    const int64_t month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    const int64_t year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+
+    writeDigits(out, (unsigned int)year, 4);
+    out[4] = '-';
+    writeDigits(out + 5, (unsigned int)month, 2);
+    out[7] = '-';
+    writeDigits(out + 8, (unsigned int)day, 2);
+    out[10] = 'T';
+    writeDigits(out + 11, (unsigned int)(secondOfDay / 3600), 2);
+    out[13] = ':';
+    writeDigits(out + 14, (unsigned int)(secondOfDay / 60 % 60), 2);
+    out[16] = ':';
+    writeDigits(out + 17, (unsigned int)(secondOfDay % 60), 2);
+    out[kSecondsLength] = '.';
+    writeDigits(out + kSecondsLength + 1, (unsigned int)fraction, 6);
+}
@@ -0,0 +1,82 @@
+/*
+ RGPUtils
+ LogClock.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ Cheap timestamps for log records and a cached ISO-8601 formatter.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogClock_H__
+#define __RGPUtils__LogClock_H__
+
+#include <cstdint>
+#include <cstddef>
+
+namespace rgp {
+
+    /**
+     @brief Timestamps for the Log class.
+     @details now() reads the monotonic clock and adds the offset to the
+     wall clock, which is measured again once a second, so taking a
+     timestamp rarely touches the realtime clock and never the timezone.
+     Steps of the wall clock (NTP, manual changes, suspend and resume) show
+     up in the timestamps within a second. format() keeps the
+     formatted date and time of the last second per thread and only has to
+     fill in the microseconds as long as the second didn't change.
+     */
+    class LogClock {
+
+    public:
+        /** Length of a formatted timestamp ("2026-10-18T09:15:02.123456"). */
+        static const size_t kFormattedLength = 26;
+
+        /** Microseconds since the epoch (UTC). */
+        static int64_t now ();
+
+        /**
+         @brief Microseconds of a monotonic clock with a resolution of a few
+         milliseconds.
+         @details Cheaper than now() where the kernel offers a coarse clock
+         (Linux), meant for rate limits and intervals.
+         */
+        static int64_t coarse ();
+
+        /**
+         @brief Writes the timestamp as local time in ISO-8601 format.
+         @param microseconds A timestamp returned by now().
+         @param out Receives kFormattedLength characters (not terminated).
+         */
+        static void format (const int64_t microseconds, char *out);
+
+        /**
+         @brief Writes the timestamp as UTC in ISO-8601 format.
+         @details Only does arithmetic (no timezone lookup, no cache), so it
+         is async-signal-safe.
+         @param microseconds A timestamp returned by now().
+         @param out Receives kFormattedLength characters (not terminated).
+         */
+        static void formatUtc (const int64_t microseconds, char *out);
+    };
+}
+
+#endif // defined(__RGPUtils__LogClock_H__) header guard
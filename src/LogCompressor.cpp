@@ -0,0 +1,332 @@
+/*
+ RGPUtils
+ LogCompressor.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/LogCompressor.h>
+
+#include <fstream>
+#include <vector>
+#include <cstdio>  // rename / remove
+#include <cstring>
+#include <cstdint>
+
+using namespace rgp;
+
+static const char kMagic[4] = { 'R', 'L', 'Z', '1' };
+
+// a match needs at least 4 bytes, the last 5 bytes of a block are always
+// literals and no match starts in the last 12 bytes
+static const size_t kMinMatch = 4;
+static const size_t kLastLiterals = 5;
+static const size_t kMatchLimit = 12;
+static const size_t kMaxOffset = 65535;
+
+static const unsigned int kHashBits = 14;
+
+static inline uint32_t read32 (const char *data)
+{
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static inline uint32_t hash (const uint32_t value)
+{
+    return (value * 2654435761u) >> (32 - kHashBits);
+}
+
+// appends a length that didn't fit into the 4 bits of the token
+static void appendLength (std::string &out, size_t length)
+{
+    while (length >= 255) {
+        out += (char)255;
+        length -= 255;
+    }
+    out += (char)length;
+}
+
+static void appendSequence (std::string &out, const char *literals,
+                            const size_t literalLength, const size_t offset,
+                            const size_t matchLength)
+{
+    size_t matchCode = matchLength > 0 ? matchLength - kMinMatch : 0;
+    uint8_t token = (uint8_t)((literalLength < 15 ? literalLength : 15) << 4) |
+        (uint8_t)(matchCode < 15 ? matchCode : 15);
+    out += (char)token;
+
+    if (literalLength >= 15) {
+        appendLength(out, literalLength - 15);
+    }
+    out.append(literals, literalLength);
+
+    // the last sequence has no match
+    if (matchLength == 0) {
+        return;
+    }
+
+    out += (char)(offset & 0xff);
+    out += (char)(offset >> 8);
+    if (matchCode >= 15) {
+        appendLength(out, matchCode - 15);
+    }
+}
+
+void LogCompressor::compressBlock (const char *data, const size_t length,
+                                   std::string &out)
+{
+    out.clear();
+
+    // positions by the hash of their first 4 bytes
+    static thread_local std::vector<uint32_t> table;
+    table.assign((size_t)1 << kHashBits, 0);
+
+    size_t anchor = 0;
+    size_t position = 0;
+    size_t limit = length > kMatchLimit ? length - kMatchLimit : 0;
+
+    while (position < limit) {
+        uint32_t value = read32(data + position);
+        uint32_t &entry = table[hash(value)];
+        size_t candidate = entry;
+        entry = (uint32_t)position;
+
+        if (candidate >= position || position - candidate > kMaxOffset ||
+            read32(data + candidate) != value) {
+            position++;
+            continue;
+        }
+
+        size_t matchLength = kMinMatch;
+        while (position + matchLength < length - kLastLiterals &&
+               data[candidate + matchLength] == data[position + matchLength]) {
+            matchLength++;
+        }
+
+        appendSequence(out, data + anchor, position - anchor,
+                       position - candidate, matchLength);
+        position += matchLength;
+        anchor = position;
+    }
+
+    appendSequence(out, data + anchor, length - anchor, 0, 0);
+}
+
+// reads a length continuation, false at the end of the data
+static bool readLength (const uint8_t *&in, const uint8_t *end, size_t &length)
+{
+    uint8_t byte;
+    do {
+        if (in == end) {
+            return false;
+        }
+        byte = *in++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+bool LogCompressor::decompressBlock (const char *data, const size_t length,
+                                     const size_t rawLength, std::string &out)
+{
+    size_t start = out.size();
+    out.resize(start + rawLength);
+    char *output = &out[0] + start;
+    size_t produced = 0;
+
+    const uint8_t *in = reinterpret_cast<const uint8_t *>(data);
+    const uint8_t *end = in + length;
+
+    while (in < end) {
+        uint8_t token = *in++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !readLength(in, end, literalLength)) {
+            return false;
+        }
+        if ((size_t)(end - in) < literalLength ||
+            rawLength - produced < literalLength) {
+            return false;
+        }
+        memcpy(output + produced, in, literalLength);
+        in += literalLength;
+        produced += literalLength;
+
+        if (in == end) {
+            break;
+        }
+
+        if (end - in < 2) {
+            return false;
+        }
+        size_t offset = (size_t)in[0] | ((size_t)in[1] << 8);
+        in += 2;
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !readLength(in, end, matchLength)) {
+            return false;
+        }
+        matchLength += kMinMatch;
+
+        if (offset == 0 || offset > produced ||
+            rawLength - produced < matchLength) {
+            return false;
+        }
+
+        // byte by byte, the match may overlap with its own output
+        const char *match = output + produced - offset;
+        for (size_t i = 0; i < matchLength; i++) {
+            output[produced + i] = match[i];
+        }
+        produced += matchLength;
+    }
+
+    if (produced != rawLength) {
+        out.resize(start + produced);
+        return false;
+    }
+    return true;
+}
+
+static void appendUint32 (std::string &out, const uint32_t value)
+{
+    for (int i = 0; i < 4; i++) {
+        out += (char)((value >> (8 * i)) & 0xff);
+    }
+}
+
+static uint32_t readUint32 (const char *data)
+{
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data);
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) |
+        ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+bool LogCompressor::compressFile (const std::string &source,
+                                  const std::string &target,
+                                  const std::atomic<bool> *cancel)
+{
+    std::ifstream input(source.c_str(), std::ios::binary);
+    if (!input.is_open()) {
+        return false;
+    }
+
+    std::string temporary = target + ".tmp";
+    std::ofstream output(temporary.c_str(), std::ios::binary | std::ios::trunc);
+    if (!output.is_open()) {
+        return false;
+    }
+
+    output.write(kMagic, sizeof(kMagic));
+
+    std::vector<char> block(kBlockSize);
+    std::string compressed;
+    std::string header;
+
+    for (;;) {
+        if (cancel != nullptr && cancel->load()) {
+            output.close();
+            std::remove(temporary.c_str());
+            return false;
+        }
+
+        input.read(block.data(), (std::streamsize)block.size());
+        size_t length = (size_t)input.gcount();
+        if (length == 0) {
+            break;
+        }
+
+        compressBlock(block.data(), length, compressed);
+
+        // incompressible -> stored
+        const char *payload = compressed.data();
+        if (compressed.size() >= length) {
+            payload = block.data();
+            compressed.resize(length);
+        }
+
+        header.clear();
+        appendUint32(header, (uint32_t)length);
+        appendUint32(header, (uint32_t)compressed.size());
+        output.write(header.data(), (std::streamsize)header.size());
+        output.write(payload, (std::streamsize)compressed.size());
+    }
+
+    output.close();
+    if (!output || input.bad()) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+
+    if (std::rename(temporary.c_str(), target.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool LogCompressor::decompressFile (const std::string &source, std::ostream &out)
+{
+    std::ifstream input(source.c_str(), std::ios::binary);
+    if (!input.is_open()) {
+        return false;
+    }
+
+    char magic[sizeof(kMagic)];
+    if (!input.read(magic, sizeof(magic)) ||
+        memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+
+    std::vector<char> compressed;
+    std::string raw;
+    char header[8];
+
+    while (input.read(header, sizeof(header))) {
+        size_t rawLength = readUint32(header);
+        size_t length = readUint32(header + 4);
+        if (rawLength > kBlockSize || length > kBlockSize) {
+            return false;
+        }
+
+        compressed.resize(length);
+        if (!input.read(compressed.data(), (std::streamsize)length)) {
+            return false;
+        }
+
+        if (length == rawLength) {
+            out.write(compressed.data(), (std::streamsize)length);
+            continue;
+        }
+
+        raw.clear();
+        if (!decompressBlock(compressed.data(), length, rawLength, raw)) {
+            return false;
+        }
+        out.write(raw.data(), (std::streamsize)raw.size());
+    }
+
+    // a partial header is a truncated file
+    return input.gcount() == 0;
+}
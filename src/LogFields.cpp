@@ -0,0 +1,304 @@
+/*
+ RGPUtils
+ LogFields.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/LogFields.h>
+
+#include <cmath>
+
+using namespace rgp;
+
+static const char kHexDigits[] = "0123456789abcdef";
+
+// keys of the record members in the structured layouts, fields with these
+// keys get kReservedKeyPrefix in front (no duplicate JSON members)
+static const char *const kReservedKeys[] = { "ts", "level", "category",
+                                             "thread", "msg" };
+static const char kReservedKeyPrefix[] = "fields.";
+
+namespace {
+
+    // a decoded field (key and string data point into the encoded bytes)
+    struct Field {
+        LogFieldType type;
+        const char *key;
+        size_t keyLength;
+        uint64_t bits;
+        bool boolean;
+        const char *data;
+        size_t length;
+    };
+
+    // decodes the field at position, false at the end or if the rest is
+    // torn (f.e. cut by the shared ring)
+    bool nextField (const char *data, const size_t length, size_t &position,
+                    Field &field)
+    {
+        if (length - position < 2) {
+            return false;
+        }
+        field.type = (LogFieldType)data[position];
+        field.keyLength = (unsigned char)data[position + 1];
+        position += 2;
+
+        if (length - position < field.keyLength) {
+            return false;
+        }
+        field.key = data + position;
+        position += field.keyLength;
+
+        switch (field.type) {
+            case LogFieldBool:
+                if (length - position < 1) {
+                    return false;
+                }
+                field.boolean = data[position] != 0;
+                position += 1;
+                return true;
+            case LogFieldString: {
+                uint32_t stringLength;
+                if (length - position < sizeof(stringLength)) {
+                    return false;
+                }
+                memcpy(&stringLength, data + position, sizeof(stringLength));
+                position += sizeof(stringLength);
+                if (length - position < stringLength) {
+                    return false;
+                }
+                field.data = data + position;
+                field.length = stringLength;
+                position += stringLength;
+                return true;
+            }
+            case LogFieldInt:
+            case LogFieldUnsigned:
+            case LogFieldDouble:
+                if (length - position < sizeof(field.bits)) {
+                    return false;
+                }
+                memcpy(&field.bits, data + position, sizeof(field.bits));
+                position += sizeof(field.bits);
+                return true;
+        }
+        return false;
+    }
+
+    // numbers and bools (the same in both formats), false for strings
+    bool appendScalar (std::string &out, const Field &field, const bool json)
+    {
+        switch (field.type) {
+            case LogFieldInt: {
+                int64_t value;
+                memcpy(&value, &field.bits, sizeof(value));
+                logFormatValue(out, (long long)value);
+                return true;
+            }
+            case LogFieldUnsigned:
+                logFormatValue(out, (unsigned long long)field.bits);
+                return true;
+            case LogFieldDouble: {
+                double value;
+                memcpy(&value, &field.bits, sizeof(value));
+                if (std::isfinite(value)) {
+                    logFormatValue(out, value);
+                } else if (json) {
+                    out.append("null", 4);
+                } else {
+                    out += std::isnan(value) ? "NaN" : value > 0 ? "+Inf" : "-Inf";
+                }
+                return true;
+            }
+            case LogFieldBool:
+                if (field.boolean) {
+                    out.append("true", 4);
+                } else {
+                    out.append("false", 5);
+                }
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // length of the well-formed UTF-8 sequence that starts with a byte
+    // >= 0x80, 0 if it's invalid (overlong, surrogate, above U+10FFFF, cut)
+    size_t utf8SequenceLength (const unsigned char *data, const size_t length)
+    {
+        unsigned char lead = data[0];
+        unsigned char min = 0x80;
+        unsigned char max = 0xbf;
+        size_t count;
+        if (lead >= 0xc2 && lead <= 0xdf) {
+            count = 2;
+        } else if (lead >= 0xe0 && lead <= 0xef) {
+            count = 3;
+            if (lead == 0xe0) {
+                min = 0xa0;
+            } else if (lead == 0xed) {
+                max = 0x9f;
+            }
+        } else if (lead >= 0xf0 && lead <= 0xf4) {
+            count = 4;
+            if (lead == 0xf0) {
+                min = 0x90;
+            } else if (lead == 0xf4) {
+                max = 0x8f;
+            }
+        } else {
+            return 0;
+        }
+
+        if (length < count || data[1] < min || data[1] > max) {
+            return 0;
+        }
+        for (size_t i = 2; i < count; i++) {
+            if ((data[i] & 0xc0) != 0x80) {
+                return 0;
+            }
+        }
+        return count;
+    }
+
+    bool reservedKey (const char *key, const size_t length)
+    {
+        for (size_t i = 0; i < sizeof(kReservedKeys) / sizeof(kReservedKeys[0]); i++) {
+            if (strlen(kReservedKeys[i]) == length &&
+                memcmp(kReservedKeys[i], key, length) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // appends a control character or a byte that isn't valid UTF-8 as
+    // \u00XX
+    void appendUnicodeEscape (std::string &out, const unsigned char c)
+    {
+        char escaped[6] = { '\\', 'u', '0', '0',
+                            kHexDigits[c >> 4], kHexDigits[c & 0xf] };
+        out.append(escaped, sizeof(escaped));
+    }
+
+    // appends text with quotes, backslashes, control characters and
+    // invalid UTF-8 escaped (runs of plain characters are appended at once)
+    void appendEscaped (std::string &out, const char *data, const size_t length)
+    {
+        size_t plain = 0;
+        for (size_t i = 0; i < length; i++) {
+            unsigned char c = (unsigned char)data[i];
+            if (c >= 0x80) {
+                size_t sequence = utf8SequenceLength((const unsigned char *)data + i,
+                                                     length - i);
+                if (sequence > 0) {
+                    i += sequence - 1;
+                    continue;
+                }
+            } else if (c >= 0x20 && c != '"' && c != '\\' && c != 0x7f) {
+                continue;
+            }
+
+            out.append(data + plain, i - plain);
+            plain = i + 1;
+
+            switch (c) {
+                case '"': out.append("\\\"", 2); break;
+                case '\\': out.append("\\\\", 2); break;
+                case '\n': out.append("\\n", 2); break;
+                case '\r': out.append("\\r", 2); break;
+                case '\t': out.append("\\t", 2); break;
+                default: appendUnicodeEscape(out, c); break;
+            }
+        }
+        out.append(data + plain, length - plain);
+    }
+}
+
+void rgp::logJsonAppendString (std::string &out, const char *data,
+                               const size_t length)
+{
+    out += '"';
+    appendEscaped(out, data, length);
+    out += '"';
+}
+
+void rgp::logfmtAppendString (std::string &out, const char *data,
+                              const size_t length)
+{
+    bool quote = length == 0;
+    for (size_t i = 0; i < length && !quote; i++) {
+        unsigned char c = (unsigned char)data[i];
+        if (c >= 0x80) {
+            size_t sequence = utf8SequenceLength((const unsigned char *)data + i,
+                                                 length - i);
+            quote = sequence == 0;
+            i += sequence > 0 ? sequence - 1 : 0;
+        } else {
+            quote = c <= ' ' || c == '"' || c == '=' || c == '\\' || c == 0x7f;
+        }
+    }
+
+    if (quote) {
+        logJsonAppendString(out, data, length);
+    } else {
+        out.append(data, length);
+    }
+}
+
+void rgp::logFieldsAppendLogfmt (std::string &out, const char *data,
+                                 const size_t length)
+{
+    size_t position = 0;
+    Field field;
+    while (nextField(data, length, position, field)) {
+        out += ' ';
+        if (reservedKey(field.key, field.keyLength)) {
+            out.append(kReservedKeyPrefix, sizeof(kReservedKeyPrefix) - 1);
+        }
+        // keys with spaces, "=" or quotes are quoted like values
+        logfmtAppendString(out, field.key, field.keyLength);
+        out += '=';
+        if (!appendScalar(out, field, false)) {
+            logfmtAppendString(out, field.data, field.length);
+        }
+    }
+}
+
+void rgp::logFieldsAppendJson (std::string &out, const char *data,
+                               const size_t length)
+{
+    size_t position = 0;
+    Field field;
+    while (nextField(data, length, position, field)) {
+        out.append(",\"", 2);
+        if (reservedKey(field.key, field.keyLength)) {
+            out.append(kReservedKeyPrefix, sizeof(kReservedKeyPrefix) - 1);
+        }
+        appendEscaped(out, field.key, field.keyLength);
+        out.append("\":", 2);
+        if (!appendScalar(out, field, true)) {
+            logJsonAppendString(out, field.data, field.length);
+        }
+    }
+}
@@ -0,0 +1,427 @@
+/*
+ RGPUtils
+ LogFile.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include "LogFile.h"
+#include "LogMetricsRecorder.h"
+#include "LogRotator.h"
+
+#include <rgp/LogIndex.h>
+
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+
+#if defined(__APPLE__) || defined(__unix__)
+#include <unistd.h>
+#include <sys/file.h> // flock
+#elif defined(_WIN32)
+#include <io.h>
+#include <sys/stat.h>
+#endif // defined(__APPLE__) || defined(__unix__) // defined(_WIN32)
+
+using namespace rgp;
+
+// thin wrappers around the platform file api
+int LogFile::openForAppending (const std::string &path)
+{
+#if defined(__APPLE__) || defined(__unix__)
+    int fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (fd >= 0) {
+        // tells a LogBatchFile with io_uring that it isn't the only writer
+        // (advisory, appending works without the lock as well)
+        ::flock(fd, LOCK_SH | LOCK_NB);
+    }
+    return fd;
+#elif defined(_WIN32)
+    return ::_open(path.c_str(), _O_WRONLY | _O_APPEND | _O_CREAT | _O_BINARY,
+                   _S_IREAD | _S_IWRITE);
+#endif // defined(__APPLE__) || defined(__unix__) // defined(_WIN32)
+}
+
+static long writeToDescriptor (const int fd, const char *data, const size_t length)
+{
+#if defined(__APPLE__) || defined(__unix__)
+    return (long)::write(fd, data, length);
+#elif defined(_WIN32)
+    return (long)::_write(fd, data, (unsigned int)length);
+#endif // defined(__APPLE__) || defined(__unix__) // defined(_WIN32)
+}
+
+static int duplicate (const int fd)
+{
+#if defined(__APPLE__) || defined(__unix__)
+    return ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+#elif defined(_WIN32)
+    return ::_dup(fd);
+#endif // defined(__APPLE__) || defined(__unix__) // defined(_WIN32)
+}
+
+static void syncData (const int fd)
+{
+#if defined(__APPLE__)
+    ::fsync(fd);
+#elif defined(__unix__)
+    ::fdatasync(fd);
+#elif defined(_WIN32)
+    ::_commit(fd);
+#endif // defined(__APPLE__) // defined(__unix__) // defined(_WIN32)
+}
+
+static uint64_t fileSize (const int fd)
+{
+#if defined(__APPLE__) || defined(__unix__)
+    off_t size = ::lseek(fd, 0, SEEK_END);
+#elif defined(_WIN32)
+    __int64 size = ::_lseeki64(fd, 0, SEEK_END);
+#endif // defined(__APPLE__) || defined(__unix__) // defined(_WIN32)
+    return size > 0 ? (uint64_t)size : 0;
+}
+
+void LogFile::closeDescriptor (const int fd)
+{
+#if defined(__APPLE__) || defined(__unix__)
+    ::close(fd);
+#elif defined(_WIN32)
+    ::_close(fd);
+#endif // defined(__APPLE__) || defined(__unix__) // defined(_WIN32)
+}
+
+// default size of the user-space buffer
+static const size_t kDefaultBufferSize = 64 * 1024;
+
+// default time data may stay in the buffer
+static const std::chrono::milliseconds kDefaultFlushInterval { 1000 };
+
+LogFile::LogFile () : _flushInterval(kDefaultFlushInterval),
+                      _lastFlush(std::chrono::steady_clock::now())
+{
+    setBufferSize(kDefaultBufferSize);
+}
+
+LogFile::~LogFile ()
+{
+    close();
+}
+
+void LogFile::setIndexInterval (const size_t bytes)
+{
+    _indexInterval = bytes;
+
+    if (_index) {
+        flush();
+        _index->close(_fileSize);
+        _index.reset();
+    }
+
+    if (_fd >= 0 && _indexInterval > 0) {
+        _index.reset(new LogIndex());
+        _index->open(_path, _fileSize, _indexInterval);
+    }
+}
+
+bool LogFile::open (const std::string &path)
+{
+    close();
+
+    int fd = openForAppending(path);
+    if (fd < 0) {
+        return false;
+    }
+
+    _fd = fd;
+    _path = path;
+    _fileSize = fileSize(fd);
+    _rotationRequested = false;
+    _lastFlush = std::chrono::steady_clock::now();
+
+    if (_indexInterval > 0) {
+        _index.reset(new LogIndex());
+        _index->open(path, _fileSize, _indexInterval);
+    }
+
+    // a reopen keeps the running rotator
+    if (rotationEnabled() && (!_rotator || _rotator->path() != path)) {
+        _rotator.reset(new LogRotator(path, _rotation));
+    }
+    return true;
+}
+
+void LogFile::close ()
+{
+    if (_fd < 0) {
+        return;
+    }
+
+    flush();
+    if (_index) {
+        _index->close(_fileSize);
+        _index.reset();
+    }
+    closeFile();
+    _fd = -1;
+}
+
+void LogFile::writeRecord (const char *data, const size_t length,
+                           const int64_t timestamp, const uint8_t levels)
+{
+    // the offset has to refer to the file the record goes to
+    reopenIfRequested();
+    adoptRotatedFile();
+
+    if (_index && _fd >= 0) {
+        _index->record(_fileSize + _used, timestamp, levels);
+    }
+
+    write(data, length);
+}
+
+void LogFile::write (const char *data, const size_t length)
+{
+    reopenIfRequested();
+    adoptRotatedFile();
+    if (_rotator) {
+        _rotator->written();
+    }
+
+    if (_fd < 0) {
+        return;
+    }
+
+    _appended += length;
+
+    if (_used + length > _bufferSize) {
+        flush();
+    }
+
+    if (length >= _bufferSize) {
+        // doesn't fit anyway -> skip the buffer
+        writeToFile(data, length);
+    } else {
+        memcpy(_buffer.get() + _used, data, length);
+        _used += length;
+    }
+
+    flushIfDue();
+}
+
+void LogFile::flush ()
+{
+    if (_used > 0) {
+        writeToFile(_buffer.get(), _used);
+        _used = 0;
+    }
+    _lastFlush = std::chrono::steady_clock::now();
+}
+
+void LogFile::flushIfDue ()
+{
+    reopenIfRequested();
+    adoptRotatedFile();
+
+    if (_used == 0 && !_unsynced) {
+        return;
+    }
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (_used > 0 && now - _lastFlush >= _flushInterval) {
+        flush();
+    }
+
+    // periodic durability
+    if (_unsynced && _syncInterval.count() > 0 && now - _lastSync >= _syncInterval) {
+        flush();
+        syncDescriptor(_fd);
+        _unsynced = false;
+        _lastSync = now;
+    }
+}
+
+void LogFile::setBufferSize (const size_t size)
+{
+    flush();
+
+    _bufferSize = size > 0 ? size : 1;
+    _buffer.reset(new char[_bufferSize]);
+}
+
+void LogFile::setFlushInterval (const std::chrono::milliseconds interval)
+{
+    _flushInterval = interval;
+}
+
+void LogFile::setSyncInterval (const std::chrono::milliseconds interval)
+{
+    _syncInterval = interval;
+    _lastSync = std::chrono::steady_clock::now();
+}
+
+void LogFile::setRotation (const LogRotation &rotation)
+{
+    _rotation = rotation;
+    _rotator.reset();
+
+    if (_fd >= 0 && rotationEnabled()) {
+        _rotator.reset(new LogRotator(_path, _rotation));
+    }
+}
+
+bool LogFile::rotationEnabled () const
+{
+    return _rotation.maxSize > 0 || _rotation.interval > 0 ||
+        _rotation.maxFiles > 0 || _rotation.maxAge > 0 || _rotation.compress;
+}
+
+void LogFile::adoptRotatedFile ()
+{
+    if (!_rotator) {
+        return;
+    }
+
+    int fd = _rotator->takeDescriptor();
+    if (fd < 0) {
+        return;
+    }
+
+    // the rest of the buffer still belongs to the rotated file
+    // (so does the index, the rotator renamed it along with the file)
+    flush();
+    if (_index) {
+        _index->close(_fileSize);
+    }
+    closeFile();
+
+    _fd = fd;
+    _fileSize = 0;
+    _rotationRequested = false;
+    if (_index) {
+        _index->open(_path, 0, _indexInterval);
+    }
+    _rotator->released();
+}
+
+void LogFile::closeFile ()
+{
+    // a group commit waiter may be told its record is durable by a sync
+    // of the next file
+    if (_syncOnClose && _unsynced) {
+        syncDescriptor(_fd);
+    }
+    _unsynced = false;
+    closeDescriptor(_fd);
+}
+
+int LogFile::duplicateDescriptor ()
+{
+    reopenIfRequested();
+
+    if (_fd < 0) {
+        return -1;
+    }
+
+    flush();
+    _unsynced = false;
+    return duplicate(_fd);
+}
+
+void LogFile::syncAndClose (const int fd)
+{
+    syncDescriptor(fd);
+    closeDescriptor(fd);
+}
+
+void LogFile::syncDescriptor (const int fd)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    syncData(fd);
+    uint64_t time = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    _syncs.fetch_add(1, std::memory_order_relaxed);
+    _syncTime.fetch_add(time, std::memory_order_relaxed);
+
+    uint64_t longest = _maxSyncTime.load(std::memory_order_relaxed);
+    while (time > longest &&
+           !_maxSyncTime.compare_exchange_weak(longest, time,
+                                               std::memory_order_relaxed)) {
+    }
+}
+
+void LogFile::writeToFile (const char *data, size_t length)
+{
+    if (_fd < 0) {
+        return;
+    }
+
+    _unsynced = true;
+    _fileSize += length;
+
+    if (_rotator && _rotation.maxSize > 0 && !_rotationRequested &&
+        _fileSize >= _rotation.maxSize) {
+        // the rotator swaps the file in the background
+        _rotationRequested = true;
+        _rotator->requestRotation();
+    }
+
+    if (LogMetricsRecorder::enabled()) {
+        uint64_t start = LogMetricsRecorder::now();
+        writeToDescriptorFully(data, length);
+        LogMetricsRecorder::recordFlush(LogMetricsRecorder::now() - start);
+    } else {
+        writeToDescriptorFully(data, length);
+    }
+}
+
+void LogFile::writeToDescriptorFully (const char *data, size_t length)
+{
+    while (length > 0) {
+        long written = writeToDescriptor(_fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // nowhere to report this -> drop the data
+            return;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+}
+
+void LogFile::reopenIfRequested ()
+{
+    if (!_reopenRequested.load(std::memory_order_relaxed)) {
+        return;
+    }
+    _reopenRequested.store(false);
+
+    if (_path.empty()) {
+        return;
+    }
+
+    // write the pending data to the old file and continue with a new one
+    std::string path = _path;
+    open(path);
+}
@@ -0,0 +1,235 @@
+/*
+ RGPUtils
+ LogFile.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ A persistent, buffered logfile used by the Log class.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogFile_H__
+#define __RGPUtils__LogFile_H__
+
+#include <rgp/Log.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace rgp {
+
+    class LogRotator;
+    class LogIndex;
+
+    /**
+     @brief A logfile that stays open and writes through a user-space buffer.
+     @details The buffer is written to the file when it is full, when the
+     flush interval has passed or when flush() gets called. The class is not
+     thread-safe, the Log class serializes the access with the stream mutexes.
+     Only requestReopen() may be called from anywhere (even signal handlers).
+     */
+    class LogFile {
+
+    public:
+        LogFile ();
+        ~LogFile ();
+
+        /**
+         @brief Opens the file for appending (a previously opened file will be
+         flushed and closed).
+         @param path The path to the file.
+         @return True on success.
+         */
+        bool open (const std::string &path);
+
+        /** Writes the buffer and closes the file. */
+        void close ();
+
+        /** Determines if there is an open file. */
+        bool isOpen () const { return _fd >= 0; };
+
+        /** The path of the current file. */
+        const std::string &path () const { return _path; };
+
+        /**
+         @brief Appends data to the buffer.
+         @details Data larger than the buffer is written directly.
+         */
+        void write (const char *data, const size_t length);
+
+        /**
+         @brief Appends a record to the buffer and adds it to the index.
+         @param data The formatted record.
+         @param length Length of the record.
+         @param timestamp Time of the record (LogClock microseconds).
+         @param levels LogIndexLevel bit of the record.
+         */
+        void writeRecord (const char *data, const size_t length,
+                          const int64_t timestamp, const uint8_t levels);
+
+        /** Writes the buffer to the file. */
+        void flush ();
+
+        /** Writes the buffer if the flush interval has passed. */
+        void flushIfDue ();
+
+        /**
+         @brief Sets the size of the user-space buffer.
+         @details The current buffer content is written first.
+         */
+        void setBufferSize (const size_t size);
+
+        /** Sets the maximum time data may stay in the buffer. */
+        void setFlushInterval (const std::chrono::milliseconds interval);
+
+        /**
+         @brief Sets how often written data is synced to the disk.
+         @details Checked with the flush interval, 0 (default): never, the
+         operating system decides.
+         */
+        void setSyncInterval (const std::chrono::milliseconds interval);
+
+        /**
+         @brief Syncs the data of a file before it gets closed (rotation,
+         reopen, close).
+         @details Needed for durability: the periodic and the group commit
+         sync only reach the current file.
+         */
+        void setSyncOnClose (const bool sync) { _syncOnClose = sync; };
+
+        /** Bytes passed to write() so far (over all opened files). */
+        uint64_t appended () const { return _appended; };
+
+        /**
+         @brief Writes the buffer and returns a duplicate of the descriptor.
+         @details Lets a caller sync the file without holding the stream
+         mutex, see syncAndClose(). -1 if there is no open file.
+         */
+        int duplicateDescriptor ();
+
+        /**
+         @brief Syncs the data of a descriptor to the disk and closes it.
+         @details Thread-safe (no member but the counters is used).
+         */
+        void syncAndClose (const int fd);
+
+        /** Number of syncs. */
+        uint64_t syncs () const { return _syncs.load(std::memory_order_relaxed); };
+
+        /** Sum of the time all syncs took (microseconds). */
+        uint64_t syncTime () const { return _syncTime.load(std::memory_order_relaxed); };
+
+        /** The longest sync (microseconds). */
+        uint64_t maxSyncTime () const { return _maxSyncTime.load(std::memory_order_relaxed); };
+
+        /**
+         @brief Reopens the file before the next write.
+         @details Only sets a flag, so it is safe to call this from a signal
+         handler (f.e. on SIGHUP after logrotate moved the file).
+         */
+        void requestReopen () { _reopenRequested.store(true); };
+
+        /**
+         @brief Sets the rotation of the file.
+         @details Rotating happens on a background thread (see LogRotator),
+         the new file is taken on the next write.
+         */
+        void setRotation (const LogRotation &rotation);
+
+        /**
+         @brief Sets the block size of the side index (see LogIndex).
+         @details 0 (default): no index.
+         */
+        void setIndexInterval (const size_t bytes);
+
+        /** Opens a file for appending, returns the descriptor or -1. */
+        static int openForAppending (const std::string &path);
+
+        /** Closes a descriptor. */
+        static void closeDescriptor (const int fd);
+
+    private:
+        LogFile (const LogFile &) = delete;
+        LogFile &operator = (const LogFile &) = delete;
+
+        // writes data to the file descriptor (measured if metrics are on)
+        void writeToFile (const char *data, size_t length);
+
+        // writes data to the file descriptor (handles partial writes)
+        void writeToDescriptorFully (const char *data, size_t length);
+
+        // reopens the file if requested
+        void reopenIfRequested ();
+
+        // fdatasync (counted)
+        void syncDescriptor (const int fd);
+
+        // switches to the file the rotator opened (if there is one)
+        void adoptRotatedFile ();
+
+        // closes the descriptor of the current file (synced first if
+        // _syncOnClose is set)
+        void closeFile ();
+
+        bool rotationEnabled () const;
+
+        int _fd { -1 };
+        std::string _path;
+
+        std::unique_ptr<char[]> _buffer;
+        size_t _bufferSize { 0 };
+        size_t _used { 0 };
+
+        std::chrono::milliseconds _flushInterval;
+        std::chrono::steady_clock::time_point _lastFlush;
+
+        uint64_t _appended { 0 };
+
+        // data reached the descriptor after the last sync
+        bool _unsynced { false };
+        std::chrono::milliseconds _syncInterval { 0 };
+        std::chrono::steady_clock::time_point _lastSync;
+        bool _syncOnClose { false };
+
+        std::atomic<uint64_t> _syncs { 0 };
+        std::atomic<uint64_t> _syncTime { 0 };
+        std::atomic<uint64_t> _maxSyncTime { 0 };
+
+        std::atomic<bool> _reopenRequested { false };
+
+        LogRotation _rotation;
+        std::unique_ptr<LogRotator> _rotator;
+
+        // bytes in the current file
+        uint64_t _fileSize { 0 };
+        bool _rotationRequested { false };
+
+        // the side index (open while the file is and _indexInterval > 0)
+        std::unique_ptr<LogIndex> _index;
+        size_t _indexInterval { 0 };
+    };
+}
+
+#endif // defined(__RGPUtils__LogFile_H__) header guard
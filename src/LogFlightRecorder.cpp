@@ -0,0 +1,239 @@
+/*
+ RGPUtils
+ LogFlightRecorder.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include "LogFlightRecorder.h"
+#include "LogClock.h"
+
+#include <csignal>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+
+#if defined(__APPLE__) || defined(__unix__)
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <io.h>
+#include <sys/stat.h>
+#endif // defined(__APPLE__) || defined(__unix__) // defined(_WIN32)
+
+using namespace rgp;
+
+// async-signal-safe wrappers around the platform file api
+static int openForDump (const char *path)
+{
+#if defined(__APPLE__) || defined(__unix__)
+    return ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#elif defined(_WIN32)
+    return ::_open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY,
+                   _S_IREAD | _S_IWRITE);
+#endif // defined(__APPLE__) || defined(__unix__) // defined(_WIN32)
+}
+
+static bool writeAll (const int fd, const char *data, size_t length)
+{
+    while (length > 0) {
+#if defined(__APPLE__) || defined(__unix__)
+        long written = (long)::write(fd, data, length);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+#elif defined(_WIN32)
+        long written = (long)::_write(fd, data, (unsigned int)length);
+#endif // defined(__APPLE__) || defined(__unix__) // defined(_WIN32)
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+    return true;
+}
+
+static void closeDump (const int fd)
+{
+#if defined(__APPLE__) || defined(__unix__)
+    ::close(fd);
+#elif defined(_WIN32)
+    ::_close(fd);
+#endif // defined(__APPLE__) || defined(__unix__) // defined(_WIN32)
+}
+
+namespace {
+
+    // state of the crash handler (only plain memory, read in the handler)
+    std::atomic<LogFlightRecorder *> crashRecorder { nullptr };
+    char crashPath[4096];
+    std::atomic<bool> crashHandlersInstalled { false };
+
+    const int kCrashSignals[] = { SIGSEGV, SIGABRT };
+    const size_t kCrashSignalCount = sizeof(kCrashSignals) / sizeof(kCrashSignals[0]);
+
+#if defined(__APPLE__) || defined(__unix__)
+    struct sigaction previousActions[kCrashSignalCount];
+#else
+    void (*previousHandlers[kCrashSignalCount]) (int);
+#endif // defined(__APPLE__) || defined(__unix__)
+
+    void crashHandler (int signalNumber)
+    {
+        // only the first crashing thread dumps
+        LogFlightRecorder *recorder = crashRecorder.exchange(nullptr);
+        if (recorder != nullptr) {
+            recorder->dump(crashPath);
+        }
+
+        // let the previous handler (or the default action) finish the job
+        for (size_t i = 0; i < kCrashSignalCount; i++) {
+            if (kCrashSignals[i] == signalNumber) {
+#if defined(__APPLE__) || defined(__unix__)
+                sigaction(signalNumber, &previousActions[i], nullptr);
+#else
+                signal(signalNumber, previousHandlers[i]);
+#endif // defined(__APPLE__) || defined(__unix__)
+            }
+        }
+        raise(signalNumber);
+    }
+}
+
+LogFlightRecorder::LogFlightRecorder (const size_t capacity)
+{
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    _mask = size - 1;
+    _slots.reset(size);
+
+    for (size_t i = 0; i < size; i++) {
+        _slots[i].sequence.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LogFlightRecorder::record (const int64_t timestamp, const bool error,
+                                const Loglevel level, const char *text,
+                                const size_t length)
+{
+    uint64_t position = _position.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = _slots[position & _mask];
+
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    size_t copied = length < sizeof(slot.text) ? length : sizeof(slot.text);
+    slot.timestamp = timestamp;
+    slot.length = (uint16_t)copied;
+    slot.error = error ? 1 : 0;
+    slot.level = level;
+    memcpy(slot.text, text, copied);
+
+    slot.sequence.store(position + 1, std::memory_order_release);
+}
+
+bool LogFlightRecorder::dump (const char *path) const
+{
+    int fd = openForDump(path);
+    if (fd < 0) {
+        return false;
+    }
+
+    static const char kHeader[] = "flight recorder (UTC, oldest first)\n";
+    bool success = writeAll(fd, kHeader, sizeof(kHeader) - 1);
+
+    uint64_t end = _position.load(std::memory_order_acquire);
+    uint64_t begin = end > capacity() ? end - capacity() : 0;
+
+    for (uint64_t position = begin; position < end && success; position++) {
+        const Slot &slot = _slots[position & _mask];
+
+        // copy the slot and check that nobody wrote to it meanwhile
+        if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+            continue;
+        }
+        Slot copy;
+        copy.timestamp = slot.timestamp;
+        copy.length = slot.length;
+        copy.error = slot.error;
+        copy.level = slot.level;
+        memcpy(copy.text, slot.text, sizeof(copy.text));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != position + 1) {
+            continue;
+        }
+
+        char line[LogClock::kFormattedLength + 16 + sizeof(copy.text)];
+        size_t length = 0;
+
+        LogClock::formatUtc(copy.timestamp, line);
+        length += LogClock::kFormattedLength;
+
+        const char *level = copy.error ? " ERROR " :
+            (copy.level == LoglevelVerbose ? " VERBOSE " : " INFO ");
+        size_t levelLength = strlen(level);
+        memcpy(line + length, level, levelLength);
+        length += levelLength;
+
+        size_t textLength = copy.length < sizeof(copy.text) ?
+            copy.length : sizeof(copy.text);
+        memcpy(line + length, copy.text, textLength);
+        length += textLength;
+        line[length++] = '\n';
+
+        success = writeAll(fd, line, length);
+    }
+
+    closeDump(fd);
+    return success;
+}
+
+void LogFlightRecorder::dumpOnCrash (LogFlightRecorder *recorder,
+                                     const std::string &path)
+{
+    // the handler may run at any time -> no dump while the path changes
+    crashRecorder.store(nullptr);
+    size_t length = path.size() < sizeof(crashPath) - 1 ?
+        path.size() : sizeof(crashPath) - 1;
+    memcpy(crashPath, path.c_str(), length);
+    crashPath[length] = '\0';
+    crashRecorder.store(recorder);
+
+    if (recorder == nullptr || crashHandlersInstalled.exchange(true)) {
+        return;
+    }
+
+    for (size_t i = 0; i < kCrashSignalCount; i++) {
+#if defined(__APPLE__) || defined(__unix__)
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = &crashHandler;
+        sigemptyset(&action.sa_mask);
+        sigaction(kCrashSignals[i], &action, &previousActions[i]);
+#else
+        previousHandlers[i] = signal(kCrashSignals[i], &crashHandler);
+#endif // defined(__APPLE__) || defined(__unix__)
+    }
+}
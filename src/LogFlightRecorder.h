@@ -0,0 +1,111 @@
+/*
+ RGPUtils
+ LogFlightRecorder.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ A fixed-size ring of the most recent log records that can be dumped from a
+ signal handler.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogFlightRecorder_H__
+#define __RGPUtils__LogFlightRecorder_H__
+
+#include <rgp/Log.h>
+
+#include "LogAligned.h"
+
+#include <atomic>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace rgp {
+
+    /**
+     @brief Ring of the last records with fixed-size slots.
+     @details Writers take the next slot with a single fetch_add and copy the
+     text into it (truncated to the slot size). Every slot carries a sequence
+     number that is cleared while the slot is written, so dump() skips slots
+     that are torn. dump() only uses open(), write() and close(), it may be
+     called from a signal handler.
+     */
+    class LogFlightRecorder : public LogCacheAligned {
+
+    public:
+        /** Size of a slot in bytes. */
+        static const size_t kSlotSize = 256;
+
+        /**
+         @brief Creates a recorder.
+         @param capacity Number of slots. Will be rounded up to the next power
+         of two (minimum 2).
+         */
+        explicit LogFlightRecorder (const size_t capacity);
+
+        /** Copies a record into the next slot. */
+        void record (const int64_t timestamp, const bool error,
+                     const Loglevel level, const char *text,
+                     const size_t length);
+
+        /**
+         @brief Writes the records (oldest first) to a file (async-signal-safe).
+         @param path Path of the file, it gets truncated.
+         @return True on success.
+         */
+        bool dump (const char *path) const;
+
+        /** The number of slots. */
+        size_t capacity () const { return _mask + 1; };
+
+        /**
+         @brief Dumps the recorder when SIGSEGV or SIGABRT is raised.
+         @details The handlers are installed on the first call. The previous
+         handlers are restored and called after the dump.
+         @param recorder The recorder to dump, nullptr to dump nothing.
+         @param path The path of the dump file.
+         */
+        static void dumpOnCrash (LogFlightRecorder *recorder,
+                                 const std::string &path);
+
+    private:
+        struct alignas(64) Slot {
+            // position + 1 of the record in the slot, 0 while it is written
+            std::atomic<uint64_t> sequence;
+            int64_t timestamp;
+            uint16_t length;
+            uint8_t error;
+            uint8_t level;
+            char text[kSlotSize - sizeof(uint64_t) - sizeof(int64_t) - 4];
+        };
+
+        LogFlightRecorder (const LogFlightRecorder &) = delete;
+        LogFlightRecorder &operator = (const LogFlightRecorder &) = delete;
+
+        LogAlignedArray<Slot> _slots;
+        size_t _mask;
+
+        alignas(64) std::atomic<uint64_t> _position { 0 };
+    };
+}
+
+#endif // defined(__RGPUtils__LogFlightRecorder_H__) header guard
@@ -0,0 +1,206 @@
+/*
+ RGPUtils
+ LogFormat.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/LogFormat.h>
+
+#include <cstdio>  // snprintf
+#include <cstdlib> // strtod / strtof
+#include <cstring> // strlen / memcpy
+#include <cstdint>
+
+using namespace rgp;
+
+// "00" "01" ... "99" -> two digits per division
+static const char kDigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// appends the decimal digits of value
+static void appendUnsigned (std::string &out, unsigned long long value)
+{
+    char digits[24];
+    char *end = digits + sizeof(digits);
+    char *begin = end;
+
+    while (value >= 100) {
+        unsigned int pair = (unsigned int)(value % 100) * 2;
+        value /= 100;
+        *--begin = kDigitPairs[pair + 1];
+        *--begin = kDigitPairs[pair];
+    }
+    if (value >= 10) {
+        unsigned int pair = (unsigned int)value * 2;
+        *--begin = kDigitPairs[pair + 1];
+        *--begin = kDigitPairs[pair];
+    } else {
+        *--begin = (char)('0' + value);
+    }
+
+    out.append(begin, (size_t)(end - begin));
+}
+
+// appends the decimal digits of value (with sign)
+static void appendSigned (std::string &out, long long value)
+{
+    if (value < 0) {
+        out += '-';
+        // negate in unsigned arithmetic to handle the minimum value
+        appendUnsigned(out, 0ULL - (unsigned long long)value);
+    } else {
+        appendUnsigned(out, (unsigned long long)value);
+    }
+}
+
+const char *rgp::logFormatLiteral (std::string &out, const char *format)
+{
+    const char *begin = format;
+
+    for (;;) {
+        char c = *format;
+
+        if (c == '\0') {
+            out.append(begin, (size_t)(format - begin));
+            return nullptr;
+        }
+
+        if (c == '{' || c == '}') {
+            if (c == '{' && format[1] == '}') {
+                // placeholder
+                out.append(begin, (size_t)(format - begin));
+                return format + 2;
+            }
+            if (format[1] == c) {
+                // escaped brace -> keep one of them
+                out.append(begin, (size_t)(format - begin) + 1);
+                format += 2;
+                begin = format;
+                continue;
+            }
+        }
+
+        format++;
+    }
+}
+
+void rgp::logFormatValue (std::string &out, const int value)
+{
+    appendSigned(out, value);
+}
+
+void rgp::logFormatValue (std::string &out, const unsigned int value)
+{
+    appendUnsigned(out, value);
+}
+
+void rgp::logFormatValue (std::string &out, const long value)
+{
+    appendSigned(out, value);
+}
+
+void rgp::logFormatValue (std::string &out, const unsigned long value)
+{
+    appendUnsigned(out, value);
+}
+
+void rgp::logFormatValue (std::string &out, const long long value)
+{
+    appendSigned(out, value);
+}
+
+void rgp::logFormatValue (std::string &out, const unsigned long long value)
+{
+    appendUnsigned(out, value);
+}
+
+void rgp::logFormatValue (std::string &out, const double value)
+{
+    // the shortest text that reads back as the same double
+    // (snprintf works on the stack, the string only grows if needed)
+    char digits[32];
+    int length = 0;
+    for (int precision = 15; precision <= 17; precision++) {
+        length = snprintf(digits, sizeof(digits), "%.*g", precision, value);
+        if (strtod(digits, nullptr) == value) {
+            break;
+        }
+    }
+    if (length > 0) {
+        out.append(digits, (size_t)length);
+    }
+}
+
+void rgp::logFormatValue (std::string &out, const float value)
+{
+    // the same with the precision of a float (1.1f isn't 1.10000002384186)
+    char digits[32];
+    int length = 0;
+    for (int precision = 6; precision <= 9; precision++) {
+        length = snprintf(digits, sizeof(digits), "%.*g", precision, (double)value);
+        if (strtof(digits, nullptr) == value) {
+            break;
+        }
+    }
+    if (length > 0) {
+        out.append(digits, (size_t)length);
+    }
+}
+
+void rgp::logFormatValue (std::string &out, const char *value)
+{
+    if (value == nullptr) {
+        out.append("(null)", 6);
+        return;
+    }
+    out.append(value, strlen(value));
+}
+
+void rgp::logFormatValue (std::string &out, const void *value)
+{
+    static const char kHexDigits[] = "0123456789abcdef";
+
+    uintptr_t address = (uintptr_t)value;
+    char digits[2 + sizeof(uintptr_t) * 2];
+    char *end = digits + sizeof(digits);
+    char *begin = end;
+
+    do {
+        *--begin = kHexDigits[address & 0xf];
+        address >>= 4;
+    } while (address != 0);
+
+    *--begin = 'x';
+    *--begin = '0';
+
+    out.append(begin, (size_t)(end - begin));
+}
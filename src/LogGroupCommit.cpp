@@ -0,0 +1,76 @@
+/*
+ RGPUtils
+ LogGroupCommit.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include "LogGroupCommit.h"
+#include "LogFile.h"
+
+using namespace rgp;
+
+void LogGroupCommit::commit (LogFile &file, std::mutex &streamMutex,
+                             const uint64_t position)
+{
+    _commits.fetch_add(1, std::memory_order_relaxed);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (_durable < position) {
+
+        if (_syncing) {
+            // the running sync may not cover us -> wait and check again
+            _condition.wait(lock);
+            continue;
+        }
+
+        // become the leader, everything appended till now is synced
+        _syncing = true;
+        lock.unlock();
+
+        uint64_t target;
+        int fd;
+        {
+            std::lock_guard<std::mutex> streamLock(streamMutex);
+            target = file.appended();
+            fd = file.duplicateDescriptor();
+        }
+
+        // appending goes on meanwhile
+        if (fd >= 0) {
+            file.syncAndClose(fd);
+        }
+
+        lock.lock();
+        _syncing = false;
+        if (target > _durable) {
+            _durable = target;
+        }
+        _condition.notify_all();
+
+        if (fd < 0) {
+            // the file is gone, nothing to wait for
+            break;
+        }
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ RGPUtils
+ LogGroupCommit.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ Makes log calls wait till their record is on the disk, concurrent calls
+ share one sync.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogGroupCommit_H__
+#define __RGPUtils__LogGroupCommit_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <cstdint>
+
+namespace rgp {
+
+    class LogFile;
+
+    /**
+     @brief Group commit for a LogFile.
+     @details The first waiting caller becomes the leader: it syncs
+     everything that was appended up to then (outside of the stream mutex,
+     through a duplicate of the descriptor). Callers that arrive meanwhile
+     wait for the next sync, which covers all of them at once.
+     */
+    class LogGroupCommit {
+
+    public:
+        /**
+         @brief Waits till the file is durable up to position.
+         @param file The file (see LogFile::appended()).
+         @param streamMutex The mutex that serializes access to the file.
+         @param position The appended bytes that have to be on the disk.
+         */
+        void commit (LogFile &file, std::mutex &streamMutex,
+                     const uint64_t position);
+
+        /** Number of callers that waited. */
+        uint64_t commits () const { return _commits.load(std::memory_order_relaxed); };
+
+    private:
+        std::mutex _mutex;
+        std::condition_variable _condition;
+
+        // appended bytes that are known to be on the disk
+        uint64_t _durable { 0 };
+
+        // a leader is syncing
+        bool _syncing { false };
+
+        std::atomic<uint64_t> _commits { 0 };
+    };
+}
+
+#endif // defined(__RGPUtils__LogGroupCommit_H__) header guard
@@ -0,0 +1,107 @@
+/*
+ RGPUtils
+ LogHeldOutput.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include "LogHeldOutput.h"
+#include "LogSgr.h"
+
+#include <rgp/LogFormat.h>
+
+#include <iostream>
+
+using namespace rgp;
+
+std::string *LogHeldOutput::buffer (const bool error, const size_t length)
+{
+    std::string &held = _held[error ? 1 : 0];
+    if (held.size() + length > Log::kHeldOutputLimit) {
+        _dropped[error ? 1 : 0]++;
+        return nullptr;
+    }
+    return &held;
+}
+
+void LogHeldOutput::release ()
+{
+    for (int stream = 0; stream < 2; stream++) {
+        std::ostream &out = stream == 0 ? std::cout : std::cerr;
+        std::string &held = _held[stream];
+
+        out.write(held.data(), held.size());
+        if (_dropped[stream] > 0) {
+            std::string line;
+            logFormat(line, "{} lines dropped while waiting for input\n",
+                      _dropped[stream]);
+            out << line;
+            _dropped[stream] = 0;
+        }
+        out << std::flush;
+
+        // don't keep a large buffer for the next prompt
+        if (held.capacity() > 64 * 1024) {
+            std::string().swap(held);
+        } else {
+            held.clear();
+        }
+    }
+}
+
+void LogHeldOutput::write (const bool held, const bool error,
+                           const std::string &line, const bool colored,
+                           const AnsiSgrFgColor fgcolor,
+                           const AnsiSgrBgColor bgcolor)
+{
+    if (held) {
+        std::string *buffer = this->buffer(error, line.size());
+        if (buffer != nullptr) {
+            if (colored) {
+                logSgrAppend(*buffer, fgcolor, bgcolor);
+            }
+            *buffer += line;
+            if (colored) {
+                buffer->append(kLogSgrReset.text, kLogSgrReset.length);
+            }
+        }
+        return;
+    }
+
+    std::ostream &out = error ? std::cerr : std::cout;
+
+    if (colored) {
+        LogSgrSequence fg = logSgrForeground(fgcolor);
+        LogSgrSequence bg = logSgrBackground(bgcolor);
+        out.write(fg.text, fg.length);
+        out.write(bg.text, bg.length);
+    }
+
+    out << line;
+
+    // reset colors to default
+    if (colored) {
+        out.write(kLogSgrReset.text, kLogSgrReset.length);
+    }
+
+    out << std::flush;
+}
@@ -0,0 +1,83 @@
+/*
+ RGPUtils
+ LogHeldOutput.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ Console output that is held back while a prompt waits for input.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogHeldOutput_H__
+#define __RGPUtils__LogHeldOutput_H__
+
+#include <rgp/Log.h>
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace rgp {
+
+    /**
+     @brief Buffers the lines for std::cout and std::cerr during a prompt
+     (see Log::getline()).
+     @details Each stream keeps up to Log::kHeldOutputLimit bytes, further
+     lines are counted and reported per stream on release. The buffers of
+     the two streams are independent, so each may be used with the mutex
+     of its stream only. release() needs both.
+     */
+    class LogHeldOutput {
+
+    public:
+        /**
+         @brief The buffer a line of a stream is appended to.
+         @param error True for std::cerr.
+         @param length Length of the line.
+         @return The buffer, nullptr if the line doesn't fit any more (it
+         got counted as dropped).
+         */
+        std::string *buffer (const bool error, const size_t length);
+
+        /** Writes the held lines and the drop counts to the streams. */
+        void release ();
+
+        /**
+         @brief Writes a line to std::cout / std::cerr or holds it back.
+         @param held True while a prompt waits for input.
+         @param error True for std::cerr.
+         @param line The line.
+         @param colored True: the line is surrounded by the escape sequences
+         of the colors.
+         @param fgcolor The foreground color.
+         @param bgcolor The background color.
+         */
+        void write (const bool held, const bool error, const std::string &line,
+                    const bool colored, const AnsiSgrFgColor fgcolor,
+                    const AnsiSgrBgColor bgcolor);
+
+    private:
+        std::string _held[2];
+        uint64_t _dropped[2] { 0, 0 };
+    };
+}
+
+#endif // defined(__RGPUtils__LogHeldOutput_H__) header guard
@@ -0,0 +1,149 @@
+/*
+ RGPUtils
+ LogIndex.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/LogIndex.h>
+
+#include <cstring>
+
+using namespace rgp;
+
+static_assert(sizeof(LogIndexEntry) == 32, "index entries are stored as is");
+
+static const char kMagic[8] = { 'R', 'G', 'P', 'L', 'I', 'D', 'X', '1' };
+
+std::string LogIndex::pathFor (const std::string &logfile)
+{
+    return logfile + ".idx";
+}
+
+bool LogIndex::read (const std::string &logfile,
+                     std::vector<LogIndexEntry> &entries)
+{
+    entries.clear();
+
+    std::ifstream file(pathFor(logfile).c_str(), std::ios::binary);
+    char magic[sizeof(kMagic)];
+    if (!file.read(magic, sizeof(magic)) ||
+        memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+
+    // a torn entry at the end is ignored
+    LogIndexEntry entry;
+    while (file.read((char *)&entry, sizeof(entry))) {
+        entries.push_back(entry);
+    }
+    return true;
+}
+
+bool LogIndex::open (const std::string &logfile, const uint64_t fileSize,
+                     const size_t interval)
+{
+    close(0);
+
+    _interval = interval;
+
+    std::vector<LogIndexEntry> entries;
+    bool valid = read(logfile, entries);
+    if (valid && !entries.empty()) {
+        const LogIndexEntry &last = entries.back();
+        valid = last.offset + last.length <= fileSize;
+    }
+
+    std::string path = pathFor(logfile);
+    if (valid) {
+        uint64_t length = sizeof(kMagic) + entries.size() * sizeof(LogIndexEntry);
+        std::ifstream size(path.c_str(), std::ios::binary | std::ios::ate);
+        if (size.is_open() && (uint64_t)size.tellg() != length) {
+            // a torn entry at the end (crash while appending) -> write the
+            // complete entries again without it
+            size.close();
+            _file.open(path.c_str(), std::ios::binary | std::ios::trunc);
+            _file.write(kMagic, sizeof(kMagic));
+            if (!entries.empty()) {
+                _file.write((const char *)entries.data(),
+                            (std::streamsize)(entries.size() * sizeof(LogIndexEntry)));
+            }
+            _file.flush();
+        } else {
+            _file.open(path.c_str(), std::ios::binary | std::ios::app);
+        }
+    } else {
+        _file.open(path.c_str(), std::ios::binary | std::ios::trunc);
+        _file.write(kMagic, sizeof(kMagic));
+        _file.flush();
+    }
+
+    return _file.good();
+}
+
+void LogIndex::close (const uint64_t end)
+{
+    if (!_file.is_open()) {
+        return;
+    }
+
+    if (_hasBlock && end > _block.offset) {
+        _block.length = (uint32_t)(end - _block.offset);
+        append(_block);
+    }
+    _hasBlock = false;
+    _file.close();
+}
+
+void LogIndex::record (const uint64_t offset, const int64_t timestamp,
+                       const uint8_t levels)
+{
+    if (_hasBlock && offset - _block.offset >= _interval) {
+        _block.length = (uint32_t)(offset - _block.offset);
+        append(_block);
+        _hasBlock = false;
+    }
+
+    if (!_hasBlock) {
+        _block.offset = offset;
+        _block.length = 0;
+        _block.levels = 0;
+        _block.minTime = timestamp;
+        _block.maxTime = timestamp;
+        _hasBlock = true;
+    }
+
+    _block.levels |= levels;
+    if (timestamp < _block.minTime) {
+        _block.minTime = timestamp;
+    }
+    if (timestamp > _block.maxTime) {
+        _block.maxTime = timestamp;
+    }
+}
+
+void LogIndex::append (const LogIndexEntry &entry)
+{
+    // readers see complete blocks right away
+    _file.write((const char *)&entry, sizeof(entry));
+    _file.flush();
+}
@@ -0,0 +1,94 @@
+/*
+ RGPUtils
+ LogLimit.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/LogLimit.h>
+
+#include "LogClock.h"
+
+using namespace rgp;
+
+// all limits that ever suppressed a call (constant initialized, limits are
+// only pushed at the front)
+static std::atomic<LogCallSiteLimit *> listHead { nullptr };
+
+LogCallSiteLimit *LogCallSiteLimit::first ()
+{
+    return listHead.load(std::memory_order_acquire);
+}
+
+void LogCallSiteLimit::enlist ()
+{
+    if (_registered.exchange(true)) {
+        return;
+    }
+
+    LogCallSiteLimit *head = listHead.load(std::memory_order_relaxed);
+    do {
+        _next.store(head, std::memory_order_relaxed);
+    } while (!listHead.compare_exchange_weak(head, this,
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed));
+}
+
+void LogCallSiteLimit::passed (const int64_t now)
+{
+    if (listHead.load(std::memory_order_relaxed) != nullptr) {
+        Log::sharedLog()->reportSuppressedIfDue(now, false);
+    }
+}
+
+bool LogRateLimiter::allow ()
+{
+    const int64_t now = LogClock::coarse();
+
+    int64_t arrival = _arrival.load(std::memory_order_relaxed);
+    for (;;) {
+        int64_t start = arrival > now ? arrival : now;
+        if (start - now > _tolerance) {
+            // bucket is empty
+            suppress();
+            return false;
+        }
+        if (_arrival.compare_exchange_weak(arrival, start + _interval,
+                                           std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    passed(now);
+    return true;
+}
+
+bool LogSampler::allow ()
+{
+    if (_count.fetch_add(1, std::memory_order_relaxed) % _n != 0) {
+        suppress();
+        return false;
+    }
+
+    passed(LogClock::coarse());
+    return true;
+}
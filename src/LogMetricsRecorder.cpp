@@ -0,0 +1,333 @@
+/*
+ RGPUtils
+ LogMetricsRecorder.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include "LogMetricsRecorder.h"
+#include "LogAligned.h"
+
+#include <mutex>
+#include <vector>
+#include <cstring>
+
+using namespace rgp;
+
+// LogHistogram
+
+// sub-buckets per power of two (3 bits)
+static const unsigned int kSubBucketBits = 3;
+static const uint64_t kSubBucketCount = 1 << kSubBucketBits;
+
+// position of the highest set bit
+static unsigned int highestBit (const uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - (unsigned int)__builtin_clzll(value);
+#else
+    unsigned int bit = 0;
+    uint64_t rest = value;
+    while (rest >>= 1) {
+        bit++;
+    }
+    return bit;
+#endif // defined(__GNUC__) || defined(__clang__)
+}
+
+size_t LogHistogram::bucketIndex (const uint64_t value)
+{
+    if (value < kSubBucketCount) {
+        return (size_t)value;
+    }
+
+    // 8 linear buckets per power of two, keyed by the 3 bits below the
+    // highest set bit
+    unsigned int exponent = highestBit(value);
+    uint64_t subBucket = (value >> (exponent - kSubBucketBits)) & (kSubBucketCount - 1);
+    size_t index = (size_t)((exponent - kSubBucketBits + 1) * kSubBucketCount + subBucket);
+
+    return index < kBucketCount ? index : kBucketCount - 1;
+}
+
+uint64_t LogHistogram::bucketLowerBound (const size_t index)
+{
+    if (index < kSubBucketCount) {
+        return index;
+    }
+
+    unsigned int exponent = (unsigned int)(index / kSubBucketCount) + kSubBucketBits - 1;
+    uint64_t subBucket = index % kSubBucketCount;
+    return (kSubBucketCount + subBucket) << (exponent - kSubBucketBits);
+}
+
+uint64_t LogHistogram::percentile (const double percentile) const
+{
+    if (count == 0) {
+        return 0;
+    }
+
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)count + 0.5);
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            // upper bound of the bucket, but never above the real maximum
+            uint64_t bound = i + 1 < kBucketCount ? bucketLowerBound(i + 1) - 1 : max;
+            return bound < max ? bound : max;
+        }
+    }
+
+    return max;
+}
+
+uint64_t LogHistogram::mean () const
+{
+    return count > 0 ? sum / count : 0;
+}
+
+// LogMetricsRecorder
+
+std::atomic<bool> LogMetricsRecorder::_enabled { false };
+
+namespace {
+
+    // adds to a counter, plain load / store if only one thread writes to it
+    inline void increment (std::atomic<uint64_t> &counter, const uint64_t value,
+                           const bool shared)
+    {
+        if (shared) {
+            counter.fetch_add(value, std::memory_order_relaxed);
+        } else {
+            counter.store(counter.load(std::memory_order_relaxed) + value,
+                          std::memory_order_relaxed);
+        }
+    }
+
+    struct HistogramCounter {
+        std::atomic<uint64_t> buckets[LogHistogram::kBucketCount];
+        std::atomic<uint64_t> count;
+        std::atomic<uint64_t> sum;
+        std::atomic<uint64_t> max;
+
+        HistogramCounter () {
+            for (size_t i = 0; i < LogHistogram::kBucketCount; i++) {
+                buckets[i].store(0, std::memory_order_relaxed);
+            }
+            count.store(0, std::memory_order_relaxed);
+            sum.store(0, std::memory_order_relaxed);
+            max.store(0, std::memory_order_relaxed);
+        };
+
+        void add (const uint64_t value, const bool shared) {
+            increment(buckets[LogHistogram::bucketIndex(value)], 1, shared);
+            increment(count, 1, shared);
+            increment(sum, value, shared);
+
+            uint64_t current = max.load(std::memory_order_relaxed);
+            while (value > current &&
+                   !max.compare_exchange_weak(current, value,
+                                              std::memory_order_relaxed)) {
+            }
+        };
+
+        void addTo (LogHistogram &histogram) const {
+            for (size_t i = 0; i < LogHistogram::kBucketCount; i++) {
+                histogram.buckets[i] += buckets[i].load(std::memory_order_relaxed);
+            }
+            histogram.count += count.load(std::memory_order_relaxed);
+            histogram.sum += sum.load(std::memory_order_relaxed);
+            uint64_t value = max.load(std::memory_order_relaxed);
+            if (value > histogram.max) {
+                histogram.max = value;
+            }
+        };
+    };
+
+    // counters of one logging thread
+    struct alignas(64) Shard : LogCacheAligned {
+        std::atomic<uint64_t> messages[3];
+        std::atomic<uint64_t> bytes[3];
+        std::atomic<uint64_t> errorMessages;
+        std::atomic<uint64_t> errorBytes;
+        HistogramCounter enqueueLatency;
+
+        Shard () {
+            for (size_t i = 0; i < 3; i++) {
+                messages[i].store(0, std::memory_order_relaxed);
+                bytes[i].store(0, std::memory_order_relaxed);
+            }
+            errorMessages.store(0, std::memory_order_relaxed);
+            errorBytes.store(0, std::memory_order_relaxed);
+        };
+    };
+
+    // all shards and the writer side counters
+    // (never deleted, threads may log during static destruction)
+    struct Registry : LogCacheAligned {
+        std::mutex mutex;
+        std::vector<Shard *> shards;
+        std::vector<Shard *> freeShards;
+
+        // used by threads that are exiting (shared, atomic adds)
+        Shard sharedShard;
+
+        HistogramCounter flushLatency;
+        std::atomic<uint64_t> queueHighWaterMark { 0 };
+    };
+
+    Registry &registry ()
+    {
+        static Registry *registry = new Registry();
+        return *registry;
+    }
+
+    // hands the shard of the thread to the next new thread on exit
+    struct ShardHandle {
+        Shard *shard { nullptr };
+
+        ~ShardHandle ();
+    };
+
+    thread_local ShardHandle shardHandle;
+
+    // fast access to the shard of the thread
+    thread_local Shard *threadShard = nullptr;
+
+    // set while the thread exits
+    thread_local bool threadShardRetired = false;
+
+    ShardHandle::~ShardHandle ()
+    {
+        threadShardRetired = true;
+        threadShard = nullptr;
+        if (shard != nullptr) {
+            Registry &metrics = registry();
+            std::lock_guard<std::mutex> lock(metrics.mutex);
+            metrics.freeShards.push_back(shard);
+        }
+    }
+
+    // the shard of the calling thread, sets shared for the shared shard
+    Shard *shardOfThread (bool &shared)
+    {
+        shared = false;
+        if (RGPLOG_LIKELY(threadShard != nullptr)) {
+            return threadShard;
+        }
+
+        Registry &metrics = registry();
+        if (threadShardRetired) {
+            shared = true;
+            return &metrics.sharedShard;
+        }
+
+        std::lock_guard<std::mutex> lock(metrics.mutex);
+        Shard *shard;
+        if (!metrics.freeShards.empty()) {
+            shard = metrics.freeShards.back();
+            metrics.freeShards.pop_back();
+        } else {
+            shard = new Shard();
+            metrics.shards.push_back(shard);
+        }
+
+        shardHandle.shard = shard;
+        threadShard = shard;
+        return shard;
+    }
+}
+
+void LogMetricsRecorder::setEnabled (const bool enabled)
+{
+    // create the registry before the first log call needs it
+    registry();
+    _enabled.store(enabled);
+}
+
+void LogMetricsRecorder::recordCall (const bool error, const Loglevel level,
+                                     const size_t length, const uint64_t latency)
+{
+    bool shared;
+    Shard *shard = shardOfThread(shared);
+
+    if (error) {
+        increment(shard->errorMessages, 1, shared);
+        increment(shard->errorBytes, length, shared);
+    } else if (level < 3) {
+        increment(shard->messages[level], 1, shared);
+        increment(shard->bytes[level], length, shared);
+    }
+
+    shard->enqueueLatency.add(latency, shared);
+}
+
+void LogMetricsRecorder::recordFlush (const uint64_t latency)
+{
+    registry().flushLatency.add(latency, true);
+}
+
+void LogMetricsRecorder::recordQueueDepth (const uint64_t depth)
+{
+    std::atomic<uint64_t> &highWaterMark = registry().queueHighWaterMark;
+
+    uint64_t current = highWaterMark.load(std::memory_order_relaxed);
+    while (depth > current &&
+           !highWaterMark.compare_exchange_weak(current, depth,
+                                                std::memory_order_relaxed)) {
+    }
+}
+
+void LogMetricsRecorder::collect (LogMetrics &metrics)
+{
+    memset(metrics.messages, 0, sizeof(metrics.messages));
+    memset(metrics.bytes, 0, sizeof(metrics.bytes));
+    metrics.errorMessages = 0;
+    metrics.errorBytes = 0;
+    memset(&metrics.enqueueLatency, 0, sizeof(metrics.enqueueLatency));
+    memset(&metrics.flushLatency, 0, sizeof(metrics.flushLatency));
+
+    Registry &registry = ::registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    std::vector<const Shard *> shards(registry.shards.begin(),
+                                      registry.shards.end());
+    shards.push_back(&registry.sharedShard);
+
+    for (size_t i = 0; i < shards.size(); i++) {
+        const Shard *shard = shards[i];
+        for (size_t level = 0; level < 3; level++) {
+            metrics.messages[level] += shard->messages[level].load(std::memory_order_relaxed);
+            metrics.bytes[level] += shard->bytes[level].load(std::memory_order_relaxed);
+        }
+        metrics.errorMessages += shard->errorMessages.load(std::memory_order_relaxed);
+        metrics.errorBytes += shard->errorBytes.load(std::memory_order_relaxed);
+        shard->enqueueLatency.addTo(metrics.enqueueLatency);
+    }
+
+    registry.flushLatency.addTo(metrics.flushLatency);
+    metrics.queueHighWaterMark = registry.queueHighWaterMark.load();
+}
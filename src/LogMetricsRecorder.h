@@ -0,0 +1,108 @@
+/*
+ RGPUtils
+ LogMetricsRecorder.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ Sharded counters behind Log::metrics().
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogMetricsRecorder_H__
+#define __RGPUtils__LogMetricsRecorder_H__
+
+#include <rgp/LogMetrics.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+namespace rgp {
+
+    /**
+     @brief Collects the counters of the Log class.
+     @details Every logging thread counts into its own cache-aligned shard
+     (plain loads and stores, no locked instructions). Shards of exited
+     threads are handed to new threads, so their counts are kept. The
+     writer side (flushes, queue depth) is rare enough to share atomics.
+     */
+    class LogMetricsRecorder {
+
+    public:
+        /** Determines if metrics are collected. */
+        static bool enabled () {
+            return _enabled.load(std::memory_order_relaxed);
+        };
+
+        /** Enables or disables the collection. */
+        static void setEnabled (const bool enabled);
+
+        /** Steady clock in nanoseconds (for the latency histograms). */
+        static uint64_t now () {
+            return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        };
+
+        /** Counts a log call of the calling thread. */
+        static void recordCall (const bool error, const Loglevel level,
+                                const size_t length, const uint64_t latency);
+
+        /** Records the time a file buffer needed to be written. */
+        static void recordFlush (const uint64_t latency);
+
+        /** Records the number of waiting records. */
+        static void recordQueueDepth (const uint64_t depth);
+
+        /** Adds up all shards (sinks and overflow are filled by Log). */
+        static void collect (LogMetrics &metrics);
+
+    private:
+        static std::atomic<bool> _enabled;
+    };
+
+    /**
+     @brief Measures a log call (from construction to destruction).
+     */
+    class LogCallMeasurement {
+
+    public:
+        LogCallMeasurement (const bool error, const Loglevel level,
+                            const size_t length)
+            : _start(LogMetricsRecorder::enabled() ? LogMetricsRecorder::now() : 0),
+              _length(length), _error(error), _level(level) {};
+
+        ~LogCallMeasurement () {
+            if (RGPLOG_UNLIKELY(_start != 0)) {
+                LogMetricsRecorder::recordCall(_error, _level, _length,
+                                               LogMetricsRecorder::now() - _start);
+            }
+        };
+
+    private:
+        const uint64_t _start;
+        const size_t _length;
+        const bool _error;
+        const Loglevel _level;
+    };
+}
+
+#endif // defined(__RGPUtils__LogMetricsRecorder_H__) header guard
@@ -0,0 +1,230 @@
+/*
+ RGPUtils
+ LogPattern.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/LogPattern.h>
+#include <rgp/LogSink.h>
+
+#include "LogClock.h"
+#include "LogSgr.h"
+
+#include <cstring>
+
+using namespace rgp;
+
+// what LogClock::format() writes, the separators are copied from there
+static const char kTimeTemplate[] = "0000-00-00T00:00:00.000000";
+
+static_assert(sizeof(kTimeTemplate) - 1 == LogClock::kFormattedLength,
+              "time template doesn't match LogClock");
+
+LogPattern::LogPattern (const std::string &pattern) : _pattern(pattern)
+{
+    for (size_t i = 0; i < pattern.size(); i++) {
+        if (pattern[i] != '%' || i + 1 == pattern.size()) {
+            addLiteral(pattern[i]);
+            continue;
+        }
+
+        char specifier = pattern[++i];
+        switch (specifier) {
+            case 'Y': add(OpTime, 0, 4); break;
+            case 'm': add(OpTime, 5, 2); break;
+            case 'd': add(OpTime, 8, 2); break;
+            case 'H': add(OpTime, 11, 2); break;
+            case 'M': add(OpTime, 14, 2); break;
+            case 'S': add(OpTime, 17, 2); break;
+            case 'f': add(OpTime, 20, 6); break;
+            case 'e': add(OpTime, 20, 3); break;
+            case 'l': add(OpLevel, 0, 0); break;
+            case 'L': add(OpLevelLetter, 0, 0); break;
+            case 't': add(OpThread, 0, 0); break;
+            case 'n': add(OpCategory, 0, 0); break;
+            case 'v': add(OpText, 0, 0); break;
+            case '^': add(OpColorStart, 0, 0); break;
+            case '$': add(OpColorEnd, 0, 0); break;
+            case '%': addLiteral('%'); break;
+            default:
+                _valid = false;
+                addLiteral('%');
+                addLiteral(specifier);
+                break;
+        }
+    }
+    addLiteral('\n');
+
+    for (size_t i = 0; i < _ops.size(); i++) {
+        switch (_ops[i].code) {
+            case OpLiteral:
+            case OpTime: _fixedLength += _ops[i].length; break;
+            case OpLevel: _fixedLength += 7; break;
+            case OpLevelLetter: _fixedLength += 1; break;
+            case OpThread: _fixedLength += 10; break;
+            case OpCategory: _categoryCount++; break;
+            case OpText: _textCount++; break;
+            case OpColorStart:
+                _fixedLength += kLogSgrForeground[0].length +
+                    kLogSgrBackground[8].length;
+                break;
+            case OpColorEnd: _fixedLength += kLogSgrReset.length; break;
+        }
+    }
+}
+
+void LogPattern::add (const OpCode code, const uint16_t offset,
+                      const uint16_t length)
+{
+    if (code == OpTime) {
+        _usesTime = true;
+
+        // "%H:%M" -> one copy of the timestamp
+        if (!_ops.empty() && _ops.back().code == OpTime &&
+            _ops.back().offset + _ops.back().length == offset) {
+            _ops.back().length += length;
+            return;
+        }
+    }
+
+    Op op = { code, offset, length };
+    _ops.push_back(op);
+}
+
+void LogPattern::addLiteral (const char c)
+{
+    if (!_ops.empty()) {
+        Op &last = _ops.back();
+
+        // the separators of the timestamp are part of it already
+        size_t end = last.offset + last.length;
+        if (last.code == OpTime && end < LogClock::kFormattedLength &&
+            kTimeTemplate[end] == c && (c < '0' || c > '9')) {
+            last.length++;
+            return;
+        }
+
+        // literals are stored one after the other
+        if (last.code == OpLiteral) {
+            _literals += c;
+            last.length++;
+            return;
+        }
+    }
+
+    add(OpLiteral, (uint16_t)_literals.size(), 1);
+    _literals += c;
+}
+
+void LogPattern::format (const LogSinkRecord &record, std::string &out) const
+{
+    char time[LogClock::kFormattedLength];
+    if (_usesTime) {
+        LogClock::format(record.timestamp(), time);
+    }
+
+    bool colored = logSgrColored(record.fgcolor(), record.bgcolor());
+    size_t categoryLength = record.category() != nullptr ?
+        strlen(record.category()) : 0;
+    // the message is followed by the fields (as logfmt pairs)
+    const std::string &fields = record.fieldsText();
+
+    // size the output once, the ops copy into it
+    size_t start = out.size();
+    out.resize(start + _fixedLength +
+               _textCount * (record.length() + fields.size()) +
+               _categoryCount * categoryLength);
+    char *begin = &out[start];
+    char *p = begin;
+
+    for (size_t i = 0; i < _ops.size(); i++) {
+        const Op &op = _ops[i];
+        switch (op.code) {
+            case OpLiteral:
+                memcpy(p, _literals.data() + op.offset, op.length);
+                p += op.length;
+                break;
+            case OpTime:
+                memcpy(p, time + op.offset, op.length);
+                p += op.length;
+                break;
+            case OpLevel:
+                if (record.error()) {
+                    memcpy(p, "ERROR", 5);
+                    p += 5;
+                } else if (record.level() == LoglevelVerbose) {
+                    memcpy(p, "VERBOSE", 7);
+                    p += 7;
+                } else {
+                    memcpy(p, "INFO", 4);
+                    p += 4;
+                }
+                break;
+            case OpLevelLetter:
+                *p++ = record.error() ? 'E' :
+                    record.level() == LoglevelVerbose ? 'V' : 'I';
+                break;
+            case OpThread: {
+                char digits[10];
+                char *end = digits + sizeof(digits);
+                char *first = end;
+                uint32_t value = record.thread();
+                do {
+                    *--first = (char)('0' + value % 10);
+                    value /= 10;
+                } while (value != 0);
+                memcpy(p, first, end - first);
+                p += end - first;
+                break;
+            }
+            case OpCategory:
+                memcpy(p, record.category(), categoryLength);
+                p += categoryLength;
+                break;
+            case OpText:
+                memcpy(p, record.text(), record.length());
+                p += record.length();
+                memcpy(p, fields.data(), fields.size());
+                p += fields.size();
+                break;
+            case OpColorStart:
+                if (colored) {
+                    LogSgrSequence fg = logSgrForeground(record.fgcolor());
+                    LogSgrSequence bg = logSgrBackground(record.bgcolor());
+                    memcpy(p, fg.text, fg.length);
+                    p += fg.length;
+                    memcpy(p, bg.text, bg.length);
+                    p += bg.length;
+                }
+                break;
+            case OpColorEnd:
+                if (colored) {
+                    memcpy(p, kLogSgrReset.text, kLogSgrReset.length);
+                    p += kLogSgrReset.length;
+                }
+                break;
+        }
+    }
+
+    out.resize(start + (p - begin));
+}
@@ -0,0 +1,128 @@
+/*
+ RGPUtils
+ LogQueue.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include "LogQueue.h"
+
+using namespace rgp;
+
+// initial capacity of the text buffer of every slot
+static const size_t kReservedTextSize = 256;
+
+LogQueue::LogQueue (const size_t capacity)
+{
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    _mask = size - 1;
+    _cells.reset(size);
+
+    for (size_t i = 0; i < size; i++) {
+        _cells[i].sequence.store(i, std::memory_order_relaxed);
+        _cells[i].record.text.reserve(kReservedTextSize);
+    }
+}
+
+LogRecord *LogQueue::tryClaim (uint64_t &position)
+{
+    uint64_t pos = _enqueuePosition.load(std::memory_order_relaxed);
+
+    for (;;) {
+        Cell &cell = _cells[pos & _mask];
+        uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+        int64_t diff = (int64_t)sequence - (int64_t)pos;
+
+        if (diff == 0) {
+            // slot is free -> try to claim it
+            if (_enqueuePosition.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                position = pos;
+                return &cell.record;
+            }
+        } else if (diff < 0) {
+            // the consumer didn't release this slot yet -> queue is full
+            return nullptr;
+        } else {
+            // another producer was faster
+            pos = _enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void LogQueue::publish (const uint64_t position)
+{
+    _cells[position & _mask].sequence.store(position + 1,
+                                            std::memory_order_release);
+}
+
+LogRecord *LogQueue::tryConsume (uint64_t &position)
+{
+    uint64_t pos = _dequeuePosition.load(std::memory_order_relaxed);
+
+    for (;;) {
+        Cell &cell = _cells[pos & _mask];
+        uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+        int64_t diff = (int64_t)sequence - (int64_t)(pos + 1);
+
+        if (diff == 0) {
+            // record is published -> try to claim it
+            if (_dequeuePosition.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                position = pos;
+                return &cell.record;
+            }
+        } else if (diff < 0) {
+            // nothing published at this position (yet)
+            return nullptr;
+        } else {
+            // another consumer was faster
+            pos = _dequeuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void LogQueue::release (const uint64_t position)
+{
+    _cells[position & _mask].sequence.store(position + _mask + 1,
+                                            std::memory_order_release);
+    _released.fetch_add(1, std::memory_order_release);
+}
+
+uint64_t LogQueue::enqueuePosition () const
+{
+    return _enqueuePosition.load(std::memory_order_acquire);
+}
+
+uint64_t LogQueue::dequeuePosition () const
+{
+    return _dequeuePosition.load(std::memory_order_acquire);
+}
+
+uint64_t LogQueue::releasedCount () const
+{
+    return _released.load(std::memory_order_acquire);
+}
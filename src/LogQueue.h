@@ -0,0 +1,118 @@
+/*
+ RGPUtils
+ LogQueue.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ A bounded lock-free multi-producer ring of log records.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogQueue_H__
+#define __RGPUtils__LogQueue_H__
+
+#include "LogRecord.h"
+#include "LogAligned.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace rgp {
+
+    /**
+     @brief Bounded lock-free MPSC queue of LogRecords.
+     @details Every slot carries a sequence number that tells producers and
+     the consumer whose turn it is (Dmitry Vyukov's bounded queue). Producers
+     claim a slot with a CAS on the enqueue position, fill the record in place
+     and publish it. The consumer claims the oldest record with a CAS on the
+     dequeue position, reads it in place and hands the slot back, so no
+     record is ever copied twice. Claiming on the consumer side allows
+     producers to discard the oldest record when the queue is full
+     (LogOverflowDropOldest), apart from that there is a single consumer.
+     */
+    class LogQueue : public LogCacheAligned {
+
+    public:
+        /**
+         @brief Creates a queue.
+         @param capacity Number of slots. Will be rounded up to the next power
+         of two (minimum 2).
+         */
+        explicit LogQueue (const size_t capacity);
+
+        /**
+         @brief Claims a slot for writing.
+         @param position Receives the position of the claimed slot. Has to be
+         passed to publish().
+         @return The record to fill or nullptr if the queue is full.
+         */
+        LogRecord *tryClaim (uint64_t &position);
+
+        /**
+         @brief Makes a claimed slot visible to the consumer.
+         @param position The position returned by tryClaim().
+         */
+        void publish (const uint64_t position);
+
+        /**
+         @brief Claims the oldest published record.
+         @param position Receives the position of the record. Has to be
+         passed to release().
+         @return The record or nullptr if there is nothing to read.
+         */
+        LogRecord *tryConsume (uint64_t &position);
+
+        /** Hands a consumed slot back to the producers. */
+        void release (const uint64_t position);
+
+        /** Number of slots claimed by producers so far. */
+        uint64_t enqueuePosition () const;
+
+        /** Number of slots claimed by consumers so far. */
+        uint64_t dequeuePosition () const;
+
+        /** Number of slots handed back to the producers so far. */
+        uint64_t releasedCount () const;
+
+        /** The number of slots. */
+        size_t capacity () const { return _mask + 1; };
+
+    private:
+        struct alignas(64) Cell {
+            std::atomic<uint64_t> sequence;
+            LogRecord record;
+        };
+
+        LogQueue (const LogQueue &) = delete;
+        LogQueue &operator = (const LogQueue &) = delete;
+
+        LogAlignedArray<Cell> _cells;
+        size_t _mask;
+
+        // producers and consumer work on separate cache lines
+        alignas(64) std::atomic<uint64_t> _enqueuePosition { 0 };
+        alignas(64) std::atomic<uint64_t> _dequeuePosition { 0 };
+        std::atomic<uint64_t> _released { 0 };
+    };
+}
+
+#endif // defined(__RGPUtils__LogQueue_H__) header guard
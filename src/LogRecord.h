@@ -0,0 +1,77 @@
+/*
+ RGPUtils
+ LogRecord.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ A single pre-formatted log record as it is passed from the logging threads
+ to the writer of the Log class.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogRecord_H__
+#define __RGPUtils__LogRecord_H__
+
+#include <rgp/Log.h>
+
+#include <cstdint>
+#include <string>
+
+namespace rgp {
+
+    /** The stream a record was logged to. */
+    typedef enum : uint8_t {
+        /** print() and printv() -> std::cout or the logfile */
+        LogStreamOutput = 0,
+        /** error() and errorWithErrno() -> std::cerr or the errorfile */
+        LogStreamError
+    } LogStream;
+
+    /**
+     @brief A log record.
+     @details The text is stored in a std::string that keeps its capacity
+     between uses, so records that live inside a queue slot don't allocate
+     once the slot has seen a message of similar size.
+     */
+    struct LogRecord {
+        /** wall clock time of the log call (see LogClock::now()) */
+        int64_t timestamp { 0 };
+        /** destination stream */
+        LogStream stream { LogStreamOutput };
+        /** loglevel the record was logged with */
+        Loglevel level { LoglevelNormal };
+        /** foreground color (only used on terminals) */
+        AnsiSgrFgColor fgcolor { AnsiSgrFgColorDefault };
+        /** background color (only used on terminals) */
+        AnsiSgrBgColor bgcolor { AnsiSgrBgColorDefault };
+        /** index of the LogCategory (0: global) */
+        uint16_t category { 0 };
+        /** number of the logging thread (see Log::threadNumber()) */
+        uint32_t thread { 0 };
+        /** length of the encoded fields at the end of the text (see
+         LogField) */
+        uint32_t fields { 0 };
+        /** the text that was logged */
+        std::string text;
+    };
+}
+
+#endif // defined(__RGPUtils__LogRecord_H__) header guard
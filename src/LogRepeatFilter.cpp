@@ -0,0 +1,108 @@
+/*
+ RGPUtils
+ LogRepeatFilter.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include "LogRepeatFilter.h"
+
+#include <cstring>
+
+using namespace rgp;
+
+// FNV-1a over the text
+static uint64_t hashText (const std::string &text)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < text.size(); i++) {
+        hash ^= (unsigned char)text[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool LogRepeatFilter::repeats (const LogRecord &record, const int64_t window)
+{
+    _candidateHash = hashText(record.text);
+
+    if (!_hasLast || _candidateHash != _hash ||
+        record.timestamp - _runStart > window ||
+        record.level != _last.level || record.category != _last.category ||
+        record.fgcolor != _last.fgcolor || record.bgcolor != _last.bgcolor ||
+        record.text.size() != _last.text.size() ||
+        memcmp(record.text.data(), _last.text.data(), record.text.size()) != 0) {
+        return false;
+    }
+
+    _repeats++;
+    _lastRepeat = record.timestamp;
+    return true;
+}
+
+void LogRepeatFilter::remember (const LogRecord &record)
+{
+    _last.timestamp = record.timestamp;
+    _last.stream = record.stream;
+    _last.level = record.level;
+    _last.fgcolor = record.fgcolor;
+    _last.bgcolor = record.bgcolor;
+    _last.category = record.category;
+    _last.thread = record.thread;
+    _last.fields = record.fields;
+    _last.text.assign(record.text);
+
+    _hash = _candidateHash;
+    _hasLast = true;
+    _runStart = record.timestamp;
+    _repeats = 0;
+}
+
+const LogRecord *LogRepeatFilter::takeSummary ()
+{
+    if (_repeats == 0) {
+        return nullptr;
+    }
+
+    _summary.timestamp = _lastRepeat;
+    _summary.stream = _last.stream;
+    _summary.level = _last.level;
+    _summary.fgcolor = _last.fgcolor;
+    _summary.bgcolor = _last.bgcolor;
+    _summary.category = _last.category;
+    _summary.thread = _last.thread;
+    _summary.fields = 0;
+    _summary.text.clear();
+    logFormat(_summary.text, "last message repeated {} times", _repeats);
+
+    _repeats = 0;
+
+    // a repeat after the summary starts a new run
+    _hasLast = false;
+    return &_summary;
+}
+
+void LogRepeatFilter::reset ()
+{
+    _hasLast = false;
+    _repeats = 0;
+}
@@ -0,0 +1,101 @@
+/*
+ RGPUtils
+ LogRepeatFilter.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ Collapses runs of identical records into one line and a repeat count.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogRepeatFilter_H__
+#define __RGPUtils__LogRepeatFilter_H__
+
+#include "LogRecord.h"
+
+#include <cstdint>
+
+namespace rgp {
+
+    /**
+     @brief Detects repeats of the last record of a stream.
+     @details Only the last written record is kept with the hash of its
+     text, so checking a record costs one hash over its text and one
+     compare (the texts are only compared if the hashes match). The first
+     record of a run is written as usual, the following repeats are counted
+     and written as one "last message repeated N times" line when the run
+     ends (another record, the window has passed or flush). The class is not
+     thread-safe (the Log locks the mutex of the stream).
+     */
+    class LogRepeatFilter {
+
+    public:
+        /**
+         @brief Checks a record against the last one.
+         @param record The record.
+         @param window Repeats are collapsed for this long after the first
+         record of the run (microseconds).
+         @return True if the record is a repeat (it got counted and must not
+         be written).
+         */
+        bool repeats (const LogRecord &record, const int64_t window);
+
+        /** Remembers the record that is written now (after repeats()
+         returned false). */
+        void remember (const LogRecord &record);
+
+        /** Determines if repeats were counted. */
+        bool pending () const { return _repeats > 0; };
+
+        /** Determines if the run has ended by time (no repeat can follow). */
+        bool due (const int64_t now, const int64_t window) const {
+            return _repeats > 0 && now - _runStart > window;
+        };
+
+        /**
+         @brief The summary of the counted repeats, resets the count.
+         @return The record to write ("last message repeated N times"),
+         nullptr if there were no repeats. Valid till the next call.
+         */
+        const LogRecord *takeSummary ();
+
+        /** Forgets the last record (the next one starts a new run). */
+        void reset ();
+
+    private:
+        // the last written record and the hash of its text
+        LogRecord _last;
+        uint64_t _hash { 0 };
+        bool _hasLast { false };
+
+        // hash of the record given to repeats()
+        uint64_t _candidateHash { 0 };
+
+        // time of the first record of the run, repeats since then
+        int64_t _runStart { 0 };
+        int64_t _lastRepeat { 0 };
+        uint64_t _repeats { 0 };
+
+        LogRecord _summary;
+    };
+}
+
+#endif // defined(__RGPUtils__LogRepeatFilter_H__) header guard
@@ -0,0 +1,349 @@
+/*
+ RGPUtils
+ LogRotator.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include "LogRotator.h"
+#include "LogFile.h"
+#include "LogClock.h"
+
+#include <rgp/LogCompressor.h>
+#include <rgp/LogIndex.h>
+#include <rgp/Folder.h>
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+#include <cstdio>  // rename / remove
+#include <cstring>
+#include <cstdlib> // atoi
+
+using namespace rgp;
+
+static const char kCompressedSuffix[] = ".rlz";
+
+static bool fileExists (const std::string &path)
+{
+    std::ifstream file(path.c_str());
+    return file.good();
+}
+
+static bool endsWith (const std::string &text, const std::string &suffix)
+{
+    return text.size() >= suffix.size() &&
+        text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// days since 1970-01-01 of a date of the gregorian calendar
+static int64_t daysFromCivil (int64_t year, const unsigned int month,
+                              const unsigned int day)
+{
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned int yearOfEra = (unsigned int)(year - era * 400);
+    const unsigned int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + (int64_t)dayOfEra - 719468;
+}
+
+// parses the time of a rotated file ("YYYYmmdd-HHMMSS" at the start of
+// suffix) and the number behind it, -1 if suffix is something else
+static int64_t rotationTime (const std::string &suffix, int &sequence)
+{
+    if (suffix.size() < 15 || suffix[8] != '-') {
+        return -1;
+    }
+    for (size_t i = 0; i < 15; i++) {
+        if (i != 8 && (suffix[i] < '0' || suffix[i] > '9')) {
+            return -1;
+        }
+    }
+
+    // nothing but "-<n>" and ".rlz" may follow
+    std::string rest = suffix.substr(15);
+    if (endsWith(rest, kCompressedSuffix)) {
+        rest.resize(rest.size() - strlen(kCompressedSuffix));
+    }
+    if (!rest.empty() &&
+        (rest[0] != '-' || rest.size() == 1 ||
+         rest.find_first_not_of("0123456789", 1) != std::string::npos)) {
+        return -1;
+    }
+    sequence = rest.empty() ? 0 : atoi(rest.c_str() + 1);
+
+    int value[6];
+    const size_t positions[6] = { 0, 4, 6, 9, 11, 13 };
+    const size_t lengths[6] = { 4, 2, 2, 2, 2, 2 };
+    for (size_t i = 0; i < 6; i++) {
+        value[i] = atoi(suffix.substr(positions[i], lengths[i]).c_str());
+    }
+
+    return daysFromCivil(value[0], (unsigned int)value[1], (unsigned int)value[2]) * 86400 +
+        value[3] * 3600 + value[4] * 60 + value[5];
+}
+
+LogRotator::LogRotator (const std::string &path, const LogRotation &rotation)
+    : _path(path), _rotation(rotation)
+{
+    _thread = std::thread(&LogRotator::run, this);
+}
+
+LogRotator::~LogRotator ()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+        _cancel.store(true);
+    }
+    _condition.notify_all();
+    _thread.join();
+
+    // offered but never taken
+    int fd = _descriptor.exchange(-1);
+    if (fd >= 0) {
+        LogFile::closeDescriptor(fd);
+    }
+}
+
+void LogRotator::requestRotation ()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _requested = true;
+    }
+    _condition.notify_one();
+}
+
+void LogRotator::released ()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _waitingForRelease = false;
+        _released = true;
+    }
+    _condition.notify_one();
+}
+
+std::chrono::system_clock::time_point LogRotator::nextBoundary () const
+{
+    int64_t seconds = LogClock::now() / 1000000;
+    int64_t interval = _rotation.interval;
+    return std::chrono::system_clock::time_point(
+        std::chrono::seconds((seconds / interval + 1) * interval));
+}
+
+void LogRotator::run ()
+{
+    // an existing file counts as written
+    {
+        std::ifstream file(_path.c_str(), std::ios::binary | std::ios::ate);
+        if (file.is_open() && file.tellg() > 0) {
+            _written.store(true);
+        }
+    }
+
+    // leftovers of an earlier run
+    compressAndPrune();
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    std::chrono::system_clock::time_point boundary;
+    if (_rotation.interval > 0) {
+        boundary = nextBoundary();
+    }
+
+    while (!_stop) {
+
+        if (_released) {
+            _released = false;
+            lock.unlock();
+            compressAndPrune();
+            lock.lock();
+            continue;
+        }
+
+        bool timeDue = _rotation.interval > 0 &&
+            std::chrono::system_clock::now() >= boundary;
+
+        if (!_waitingForRelease && (_requested || timeDue)) {
+            bool sizeDue = _requested;
+            _requested = false;
+            if (timeDue) {
+                boundary = nextBoundary();
+            }
+
+            lock.unlock();
+            // an empty file isn't worth a rotation on the time boundary
+            bool rotated = rotate(!sizeDue);
+            lock.lock();
+
+            if (rotated) {
+                _waitingForRelease = true;
+            }
+            continue;
+        }
+
+        if (_rotation.interval > 0 && !_waitingForRelease) {
+            _condition.wait_until(lock, boundary);
+        } else {
+            _condition.wait(lock);
+        }
+    }
+}
+
+bool LogRotator::rotate (const bool skipEmpty)
+{
+    if (!_written.exchange(false) && skipEmpty) {
+        return false;
+    }
+
+    // "<path>.YYYYmmdd-HHMMSS" (UTC), "-<n>" if that is taken already
+    char time[LogClock::kFormattedLength];
+    LogClock::formatUtc(LogClock::now(), time);
+    std::string stamp;
+    for (size_t i = 0; i < 19; i++) {
+        if (time[i] >= '0' && time[i] <= '9') {
+            stamp += time[i];
+        } else if (time[i] == 'T') {
+            stamp += '-';
+        }
+    }
+
+    int sequence = stamp == _lastStamp ? _lastSequence + 1 : 0;
+    std::string rotated;
+    for (;; sequence++) {
+        rotated = _path + "." + stamp;
+        if (sequence > 0) {
+            logFormat(rotated, "-{}", sequence);
+        }
+        if (!fileExists(rotated) && !fileExists(rotated + kCompressedSuffix)) {
+            break;
+        }
+    }
+
+    // the writer keeps writing to the renamed file till it takes the new
+    // descriptor (renaming an open file fails on Windows -> no rotation)
+    if (std::rename(_path.c_str(), rotated.c_str()) != 0) {
+        _written.store(true);
+        return false;
+    }
+
+    int fd = LogFile::openForAppending(_path);
+    if (fd < 0) {
+        std::rename(rotated.c_str(), _path.c_str());
+        _written.store(true);
+        return false;
+    }
+
+    // the side index belongs to the rotated file (the writer still appends
+    // to the open one and starts a new index with the new file)
+    std::rename(LogIndex::pathFor(_path).c_str(),
+                LogIndex::pathFor(rotated).c_str());
+
+    _lastStamp = stamp;
+    _lastSequence = sequence;
+    _descriptor.store(fd, std::memory_order_release);
+    return true;
+}
+
+void LogRotator::compressAndPrune ()
+{
+    size_t separator = _path.find_last_of("/\\");
+    std::string directory = separator != std::string::npos ?
+        _path.substr(0, separator) : std::string(".");
+    std::string prefix = separator != std::string::npos ?
+        _path.substr(separator + 1) : _path;
+    prefix += '.';
+
+    std::shared_ptr<std::vector<FolderEntry>> entries =
+        Folder(directory.empty() ? Folder::pathSeparator() : directory).listEntries();
+    if (!entries) {
+        return;
+    }
+
+    struct Rotated {
+        std::string path;
+        int64_t time;
+        int sequence;
+    };
+    std::vector<Rotated> rotated;
+
+    for (size_t i = 0; i < entries->size(); i++) {
+        const FolderEntry &entry = (*entries)[i];
+        std::string name = entry.name();
+        if (entry.type() != EntryTypeRegularFile ||
+            name.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+
+        std::string path = directory + Folder::pathSeparator() + name;
+        std::string suffix = name.substr(prefix.size());
+
+        // an interrupted compression
+        if (endsWith(suffix, ".rlz.tmp")) {
+            std::remove(path.c_str());
+            continue;
+        }
+
+        int sequence = 0;
+        int64_t time = rotationTime(suffix, sequence);
+        if (time < 0) {
+            continue;
+        }
+
+        if (_rotation.compress && !endsWith(suffix, kCompressedSuffix)) {
+            if (_cancel.load()) {
+                return;
+            }
+            std::string compressed = path + kCompressedSuffix;
+            if (LogCompressor::compressFile(path, compressed, &_cancel)) {
+                // the offsets of the index don't fit the compressed file
+                std::remove(path.c_str());
+                std::remove(LogIndex::pathFor(path).c_str());
+                path = compressed;
+            }
+        }
+
+        Rotated file = { path, time, sequence };
+        rotated.push_back(file);
+    }
+
+    // newest first
+    std::sort(rotated.begin(), rotated.end(),
+              [] (const Rotated &a, const Rotated &b) {
+        return a.time != b.time ? a.time > b.time : a.sequence > b.sequence;
+    });
+
+    int64_t now = LogClock::now() / 1000000;
+    for (size_t i = 0; i < rotated.size(); i++) {
+        bool tooMany = _rotation.maxFiles > 0 && i >= _rotation.maxFiles;
+        bool tooOld = _rotation.maxAge > 0 &&
+            now - rotated[i].time > (int64_t)_rotation.maxAge;
+        if (tooMany || tooOld) {
+            std::remove(rotated[i].path.c_str());
+            if (!endsWith(rotated[i].path, kCompressedSuffix)) {
+                std::remove(LogIndex::pathFor(rotated[i].path).c_str());
+            }
+        }
+    }
+}
@@ -0,0 +1,124 @@
+/*
+ RGPUtils
+ LogRotator.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ Rotates, compresses and prunes a logfile on a background thread.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogRotator_H__
+#define __RGPUtils__LogRotator_H__
+
+#include <rgp/Log.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace rgp {
+
+    /**
+     @brief The background part of the rotation of a LogFile.
+     @details Rotating renames the file (the writer keeps writing into the
+     renamed file through its descriptor), opens a new file under the old
+     name and offers its descriptor. The LogFile takes it with
+     takeDescriptor() on its next write, closes the old one and calls
+     released(). Only then the rotated file gets compressed, and the next
+     rotation may happen.
+     */
+    class LogRotator {
+
+    public:
+        /** Starts the background thread. */
+        LogRotator (const std::string &path, const LogRotation &rotation);
+
+        /** Stops the background thread (a running compression is
+         cancelled and continued on the next start). */
+        ~LogRotator ();
+
+        /** The path of the logfile. */
+        const std::string &path () const { return _path; };
+
+        /** Asks for a rotation (the size limit was reached). */
+        void requestRotation ();
+
+        /** The descriptor of the new file, -1 if there is none. */
+        int takeDescriptor () {
+            if (_descriptor.load(std::memory_order_relaxed) < 0) {
+                return -1;
+            }
+            return _descriptor.exchange(-1, std::memory_order_acquire);
+        };
+
+        /** The descriptor of the rotated file is closed. */
+        void released ();
+
+        /** Something was written (an empty file isn't rotated on the time
+         boundary, the data may still be in the buffer of the LogFile). */
+        void written () {
+            if (!_written.load(std::memory_order_relaxed)) {
+                _written.store(true, std::memory_order_relaxed);
+            }
+        };
+
+    private:
+        LogRotator (const LogRotator &) = delete;
+        LogRotator &operator = (const LogRotator &) = delete;
+
+        void run ();
+
+        // renames the file and opens a new one, false if nothing happened
+        bool rotate (const bool skipEmpty);
+
+        // compresses rotated files and applies the retention
+        void compressAndPrune ();
+
+        // the next multiple of the interval
+        std::chrono::system_clock::time_point nextBoundary () const;
+
+        const std::string _path;
+        const LogRotation _rotation;
+
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        bool _stop { false };
+        bool _requested { false };
+        bool _waitingForRelease { false };
+        bool _released { false };
+
+        // name of the last rotation (numbers of pruned files aren't reused)
+        std::string _lastStamp;
+        int _lastSequence { 0 };
+
+        std::atomic<int> _descriptor { -1 };
+        std::atomic<bool> _cancel { false };
+        std::atomic<bool> _written { false };
+
+        std::thread _thread;
+    };
+}
+
+#endif // defined(__RGPUtils__LogRotator_H__) header guard
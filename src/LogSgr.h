@@ -0,0 +1,107 @@
+/*
+ RGPUtils
+ LogSgr.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ The ANSI SGR escape sequences of all colors as a constexpr table.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogSgr_H__
+#define __RGPUtils__LogSgr_H__
+
+#include <rgp/Log.h>
+
+#include <string>
+#include <cstddef>
+
+namespace rgp {
+
+    /** An escape sequence and its length. */
+    struct LogSgrSequence {
+        const char *text;
+        size_t length;
+    };
+
+    /** Foreground colors 30-37 followed by 90-97. */
+    constexpr LogSgrSequence kLogSgrForeground[] = {
+        { "\033[30m", 5 }, { "\033[31m", 5 }, { "\033[32m", 5 }, { "\033[33m", 5 },
+        { "\033[34m", 5 }, { "\033[35m", 5 }, { "\033[36m", 5 }, { "\033[37m", 5 },
+        { "\033[90m", 5 }, { "\033[91m", 5 }, { "\033[92m", 5 }, { "\033[93m", 5 },
+        { "\033[94m", 5 }, { "\033[95m", 5 }, { "\033[96m", 5 }, { "\033[97m", 5 }
+    };
+
+    /** Background colors 40-47 followed by 100-107. */
+    constexpr LogSgrSequence kLogSgrBackground[] = {
+        { "\033[40m", 5 }, { "\033[41m", 5 }, { "\033[42m", 5 }, { "\033[43m", 5 },
+        { "\033[44m", 5 }, { "\033[45m", 5 }, { "\033[46m", 5 }, { "\033[47m", 5 },
+        { "\033[100m", 6 }, { "\033[101m", 6 }, { "\033[102m", 6 }, { "\033[103m", 6 },
+        { "\033[104m", 6 }, { "\033[105m", 6 }, { "\033[106m", 6 }, { "\033[107m", 6 }
+    };
+
+    /** Nothing to write (default colors). */
+    constexpr LogSgrSequence kLogSgrNone = { "", 0 };
+
+    /** Resets all attributes. */
+    constexpr LogSgrSequence kLogSgrReset = { "\033[0m", 4 };
+
+    /** The sequence of a foreground color (kLogSgrNone for the default). */
+    constexpr LogSgrSequence logSgrForeground (const AnsiSgrFgColor color)
+    {
+        return color >= 30 && color <= 37 ? kLogSgrForeground[color - 30] :
+            color >= 90 && color <= 97 ? kLogSgrForeground[color - 90 + 8] :
+            kLogSgrNone;
+    }
+
+    /** The sequence of a background color (kLogSgrNone for the default). */
+    constexpr LogSgrSequence logSgrBackground (const AnsiSgrBgColor color)
+    {
+        return color >= 40 && color <= 47 ? kLogSgrBackground[color - 40] :
+            color >= 100 && color <= 107 ? kLogSgrBackground[color - 100 + 8] :
+            kLogSgrNone;
+    }
+
+    static_assert(logSgrForeground(AnsiSgrFgColorRed).text[3] == '1',
+                  "foreground table out of order");
+    static_assert(logSgrBackground(AnsiSgrBgColorWhite).length == 6,
+                  "background table out of order");
+
+    /** Determines if the colors need escape sequences at all. */
+    inline bool logSgrColored (const AnsiSgrFgColor fgcolor,
+                               const AnsiSgrBgColor bgcolor)
+    {
+        return fgcolor != AnsiSgrFgColorDefault ||
+            bgcolor != AnsiSgrBgColorDefault;
+    }
+
+    /** Appends the sequences that select the colors. */
+    inline void logSgrAppend (std::string &out, const AnsiSgrFgColor fgcolor,
+                              const AnsiSgrBgColor bgcolor)
+    {
+        LogSgrSequence fg = logSgrForeground(fgcolor);
+        LogSgrSequence bg = logSgrBackground(bgcolor);
+        out.append(fg.text, fg.length);
+        out.append(bg.text, bg.length);
+    }
+}
+
+#endif // defined(__RGPUtils__LogSgr_H__) header guard
@@ -0,0 +1,465 @@
+/*
+ RGPUtils
+ LogSharedRing.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include "LogSharedRing.h"
+
+#include <atomic>
+#include <thread>
+#include <cstring>
+#include <cerrno>
+
+#if defined(__APPLE__) || defined(__unix__)
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif // defined(__APPLE__) || defined(__unix__)
+
+using namespace rgp;
+
+// the atomics are shared between processes, they must not need a lock
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+              "shared memory ring needs lock-free atomics");
+
+// "RGPRING1"
+static const uint64_t kMagic = 0x31474e4952504752ULL;
+
+const std::chrono::milliseconds LogSharedRing::kStallTimeout { 2000 };
+
+struct LogSharedRing::Header {
+    // set last by the creator (the ring is ready)
+    std::atomic<uint64_t> magic;
+    uint64_t slotCount;
+    uint64_t slotSize;
+
+    // producers (own cache line)
+    alignas(64) std::atomic<uint64_t> enqueuePosition;
+
+    // collector
+    alignas(64) std::atomic<uint64_t> dequeuePosition;
+    std::atomic<int32_t> collector;
+    std::atomic<uint64_t> lost;
+};
+
+struct LogSharedRing::Slot {
+    // position: free for it, position + 1: published,
+    // position + slotCount: free for the next round
+    std::atomic<uint64_t> sequence;
+    // the position the producer claimed and its process
+    std::atomic<uint64_t> claim;
+    std::atomic<int32_t> pid;
+
+    uint32_t thread;
+    int64_t timestamp;
+    uint32_t length;
+    // length of the encoded fields at the end of the text
+    uint32_t fields;
+    // over the members below and the text
+    uint32_t checksum;
+    uint8_t stream;
+    uint8_t level;
+    uint8_t fgcolor;
+    uint8_t bgcolor;
+    char category[LogSharedRing::kCategoryLength + 1];
+    char text[1];
+};
+
+// FNV-1a
+static uint32_t checksum (const uint8_t *data, const size_t length,
+                          uint32_t hash = 2166136261u)
+{
+    for (size_t i = 0; i < length; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t slotChecksum (const int64_t timestamp, const uint32_t thread,
+                              const uint8_t stream, const uint8_t level,
+                              const uint8_t fgcolor, const uint8_t bgcolor,
+                              const char *category, const char *text,
+                              const uint32_t length, const uint32_t fields)
+{
+    uint8_t bytes[4] = { stream, level, fgcolor, bgcolor };
+    uint32_t hash = checksum((const uint8_t *)&timestamp, sizeof(timestamp));
+    hash = checksum((const uint8_t *)&thread, sizeof(thread), hash);
+    hash = checksum((const uint8_t *)&length, sizeof(length), hash);
+    hash = checksum((const uint8_t *)&fields, sizeof(fields), hash);
+    hash = checksum(bytes, sizeof(bytes), hash);
+    hash = checksum((const uint8_t *)category, LogSharedRing::kCategoryLength + 1, hash);
+    return checksum((const uint8_t *)text, length, hash);
+}
+
+static std::string objectName (const std::string &name)
+{
+    return !name.empty() && name[0] == '/' ? name : "/" + name;
+}
+
+#if defined(__APPLE__) || defined(__unix__)
+
+static int32_t currentProcess ()
+{
+    return (int32_t)getpid();
+}
+
+static bool processAlive (const int32_t pid)
+{
+    return pid > 0 && (kill(pid, 0) == 0 || errno != ESRCH);
+}
+
+LogSharedRing *LogSharedRing::open (const std::string &name,
+                                    size_t slotCount, size_t slotSize)
+{
+    std::string path = objectName(name);
+
+    slotSize = (slotSize + 63) & ~(size_t)63;
+    if (slotSize < offsetof(Slot, text) + 64) {
+        slotSize = (offsetof(Slot, text) + 64 + 63) & ~(size_t)63;
+    }
+    if (slotCount < 2) {
+        slotCount = 2;
+    }
+
+    bool created = true;
+    int fd = shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0 && errno == EEXIST) {
+        created = false;
+        fd = shm_open(path.c_str(), O_RDWR, 0600);
+    }
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    size_t size = 0;
+
+    if (created) {
+        size = sizeof(Header) + slotCount * slotSize;
+        if (ftruncate(fd, (off_t)size) != 0) {
+            ::close(fd);
+            shm_unlink(path.c_str());
+            return nullptr;
+        }
+    } else {
+        // wait till the creator has sized and initialized the ring
+        for (int i = 0; i < 1000; i++) {
+            struct stat status;
+            if (fstat(fd, &status) == 0 && (size_t)status.st_size > sizeof(Header)) {
+                size = (size_t)status.st_size;
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (size == 0) {
+            ::close(fd);
+            return nullptr;
+        }
+    }
+
+    void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        return nullptr;
+    }
+
+    Header *header = (Header *)memory;
+
+    if (created) {
+        header->slotCount = slotCount;
+        header->slotSize = slotSize;
+        header->enqueuePosition.store(0, std::memory_order_relaxed);
+        header->dequeuePosition.store(0, std::memory_order_relaxed);
+        header->collector.store(0, std::memory_order_relaxed);
+        header->lost.store(0, std::memory_order_relaxed);
+        for (size_t i = 0; i < slotCount; i++) {
+            Slot *slot = (Slot *)((char *)memory + sizeof(Header) + i * slotSize);
+            slot->sequence.store(i, std::memory_order_relaxed);
+            slot->claim.store(UINT64_MAX, std::memory_order_relaxed);
+            slot->pid.store(0, std::memory_order_relaxed);
+        }
+        header->magic.store(kMagic, std::memory_order_release);
+    } else {
+        int i = 0;
+        while (header->magic.load(std::memory_order_acquire) != kMagic && i++ < 1000) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (header->magic.load(std::memory_order_acquire) != kMagic ||
+            sizeof(Header) + header->slotCount * header->slotSize != size) {
+            munmap(memory, size);
+            return nullptr;
+        }
+    }
+
+    return new LogSharedRing(memory, size);
+}
+
+bool LogSharedRing::remove (const std::string &name)
+{
+    return shm_unlink(objectName(name).c_str()) == 0;
+}
+
+LogSharedRing::~LogSharedRing ()
+{
+    munmap(_memory, _size);
+}
+
+#else
+
+LogSharedRing *LogSharedRing::open (const std::string &, const size_t,
+                                    const size_t)
+{
+    return nullptr;
+}
+
+bool LogSharedRing::remove (const std::string &)
+{
+    return false;
+}
+
+LogSharedRing::~LogSharedRing ()
+{
+}
+
+static int32_t currentProcess ()
+{
+    return 1;
+}
+
+static bool processAlive (const int32_t)
+{
+    return true;
+}
+
+#endif // defined(__APPLE__) || defined(__unix__)
+
+LogSharedRing::LogSharedRing (void *memory, const size_t size)
+    : _memory(memory), _size(size), _header((Header *)memory),
+      _slots((char *)memory + sizeof(Header))
+{
+}
+
+LogSharedRing::Slot *LogSharedRing::slot (const uint64_t position) const
+{
+    return (Slot *)(_slots + (position % _header->slotCount) * _header->slotSize);
+}
+
+bool LogSharedRing::publish (const int64_t timestamp, const uint8_t stream,
+                             const Loglevel level, const AnsiSgrFgColor fgcolor,
+                             const AnsiSgrBgColor bgcolor, const char *category,
+                             const uint32_t thread, const char *text,
+                             size_t length, uint32_t fields)
+{
+    // claim a position
+    uint64_t position = _header->enqueuePosition.load(std::memory_order_relaxed);
+    Slot *slot;
+    for (;;) {
+        slot = this->slot(position);
+        uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        int64_t difference = (int64_t)(sequence - position);
+        if (difference == 0) {
+            if (_header->enqueuePosition.compare_exchange_weak(
+                    position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // full (the collector didn't keep up or there is none)
+            _header->lost.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            position = _header->enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    // tells the collector whom to check if the slot stays unpublished
+    slot->pid.store(currentProcess(), std::memory_order_relaxed);
+    slot->claim.store(position, std::memory_order_release);
+
+    size_t capacity = _header->slotSize - offsetof(Slot, text);
+    if (length > capacity) {
+        // the fields can't be cut, only the message
+        length -= fields;
+        fields = 0;
+        if (length > capacity) {
+            length = capacity;
+        }
+    }
+
+    slot->thread = thread;
+    slot->timestamp = timestamp;
+    slot->length = (uint32_t)length;
+    slot->fields = fields;
+    slot->stream = stream;
+    slot->level = level;
+    slot->fgcolor = fgcolor;
+    slot->bgcolor = bgcolor;
+    memset(slot->category, 0, sizeof(slot->category));
+    if (category != nullptr) {
+        strncpy(slot->category, category, kCategoryLength);
+    }
+    memcpy(slot->text, text, length);
+    slot->checksum = slotChecksum(timestamp, thread, stream, level, fgcolor,
+                                  bgcolor, slot->category, slot->text,
+                                  (uint32_t)length, fields);
+
+    // the collector may have taken the slot back meanwhile
+    uint64_t expected = position;
+    if (!slot->sequence.compare_exchange_strong(expected, position + 1,
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed)) {
+        return false;
+    }
+    return true;
+}
+
+bool LogSharedRing::reclaim (Slot *slot, const uint64_t position)
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (_stalledPosition != position) {
+        _stalledPosition = position;
+        _stalledSince = now;
+    }
+
+    // skip at once if the producer is known to be dead
+    bool dead = slot->claim.load(std::memory_order_acquire) == position &&
+        !processAlive(slot->pid.load(std::memory_order_relaxed));
+    if (!dead && now - _stalledSince < kStallTimeout) {
+        return false;
+    }
+
+    uint64_t expected = position;
+    if (!slot->sequence.compare_exchange_strong(expected,
+                                                position + _header->slotCount,
+                                                std::memory_order_acq_rel)) {
+        // published just now
+        return false;
+    }
+
+    _header->dequeuePosition.store(position + 1, std::memory_order_relaxed);
+    _header->lost.fetch_add(1, std::memory_order_relaxed);
+    _stalledPosition = UINT64_MAX;
+    return true;
+}
+
+bool LogSharedRing::consume (LogRecord &record, std::string &category)
+{
+    for (;;) {
+        uint64_t position = _header->dequeuePosition.load(std::memory_order_relaxed);
+        Slot *slot = this->slot(position);
+        uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+
+        if (sequence != position + 1) {
+            if (sequence == position &&
+                _header->enqueuePosition.load(std::memory_order_relaxed) > position &&
+                reclaim(slot, position)) {
+                continue;
+            }
+            // empty (or the oldest record isn't published yet)
+            return false;
+        }
+
+        // copy the slot first and verify the copy, a late (reclaimed)
+        // producer may still write to the slot meanwhile
+        int64_t timestamp = slot->timestamp;
+        uint32_t thread = slot->thread;
+        uint32_t length = slot->length;
+        uint32_t fields = slot->fields;
+        uint32_t expectedChecksum = slot->checksum;
+        uint8_t stream = slot->stream;
+        uint8_t level = slot->level;
+        uint8_t fgcolor = slot->fgcolor;
+        uint8_t bgcolor = slot->bgcolor;
+        char categoryCopy[kCategoryLength + 1];
+        memcpy(categoryCopy, slot->category, sizeof(categoryCopy));
+
+        size_t capacity = _header->slotSize - offsetof(Slot, text);
+        bool valid = length <= capacity && fields <= length &&
+            stream <= LogStreamError && level <= LoglevelVerbose &&
+            categoryCopy[kCategoryLength] == '\0';
+
+        if (valid) {
+            record.text.assign(slot->text, length);
+            valid = expectedChecksum == slotChecksum(timestamp, thread, stream,
+                                                     level, fgcolor, bgcolor,
+                                                     categoryCopy,
+                                                     record.text.data(),
+                                                     length, fields);
+        }
+
+        if (valid) {
+            record.timestamp = timestamp;
+            record.stream = (LogStream)stream;
+            record.level = (Loglevel)level;
+            record.fgcolor = (AnsiSgrFgColor)fgcolor;
+            record.bgcolor = (AnsiSgrBgColor)bgcolor;
+            record.category = 0;
+            record.thread = thread;
+            record.fields = fields;
+            category.assign(categoryCopy);
+        }
+
+        slot->sequence.store(position + _header->slotCount, std::memory_order_release);
+        _header->dequeuePosition.store(position + 1, std::memory_order_relaxed);
+        _stalledPosition = UINT64_MAX;
+
+        if (valid) {
+            return true;
+        }
+        _header->lost.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool LogSharedRing::claimCollector ()
+{
+    int32_t self = currentProcess();
+
+    int32_t current = _header->collector.load(std::memory_order_acquire);
+    if (current == self) {
+        return true;
+    }
+    if (current != 0 && processAlive(current)) {
+        return false;
+    }
+    return _header->collector.compare_exchange_strong(current, self,
+                                                      std::memory_order_acq_rel);
+}
+
+void LogSharedRing::releaseCollector ()
+{
+    int32_t self = currentProcess();
+
+    _header->collector.compare_exchange_strong(self, 0, std::memory_order_acq_rel);
+}
+
+size_t LogSharedRing::capacity () const
+{
+    return (size_t)_header->slotCount;
+}
+
+uint64_t LogSharedRing::takeLost ()
+{
+    return _header->lost.exchange(0, std::memory_order_relaxed);
+}
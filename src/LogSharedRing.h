@@ -0,0 +1,144 @@
+/*
+ RGPUtils
+ LogSharedRing.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ A ring of log records in named shared memory, written by many processes
+ and drained by one collector.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogSharedRing_H__
+#define __RGPUtils__LogSharedRing_H__
+
+#include "LogRecord.h"
+
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace rgp {
+
+    /**
+     @brief A bounded multi-producer / single-consumer ring in shared memory.
+     @details The memory is a header followed by fixed-size slots. Every
+     slot starts with a sequence number (the same protocol as LogQueue):
+     a producer claims a position with a CAS on the shared enqueue position,
+     fills the slot and publishes it with a CAS on the sequence. Nothing in
+     the ring is ever locked, so a producer that dies can't block the other
+     producers. It can only leave its slot claimed but unpublished: the
+     collector takes such a slot back once the owning process is gone (or
+     the slot stayed unpublished for kStallTimeout) and skips it. A producer
+     that was merely slow notices on publishing and drops its record. Every
+     record carries a checksum, records that got overwritten by a late
+     producer are dropped by the collector instead of being written torn.
+     Only available on Unix systems.
+     */
+    class LogSharedRing {
+
+    public:
+        /** How long a claimed slot may stay unpublished. */
+        static const std::chrono::milliseconds kStallTimeout;
+
+        /** Maximum length of a category name in a slot. */
+        static const size_t kCategoryLength = 31;
+
+        /**
+         @brief Creates the ring or attaches to an existing one.
+         @details An existing ring keeps its geometry.
+         @param name The name of the shared memory object ("/" is added in
+         front if it is missing).
+         @param slotCount Number of slots of a new ring.
+         @param slotSize Size of the slots of a new ring (header included).
+         @return The ring, nullptr on failure.
+         */
+        static LogSharedRing *open (const std::string &name,
+                                    const size_t slotCount,
+                                    const size_t slotSize);
+
+        /** Removes the shared memory object (attached processes keep it). */
+        static bool remove (const std::string &name);
+
+        ~LogSharedRing ();
+
+        /**
+         @brief Writes a record into the ring (never blocks).
+         @details Texts that don't fit into a slot are cut (without the
+         fields, the last fields bytes of the text).
+         @return False if the ring was full or the slot was taken back.
+         */
+        bool publish (const int64_t timestamp, const uint8_t stream,
+                      const Loglevel level, const AnsiSgrFgColor fgcolor,
+                      const AnsiSgrBgColor bgcolor, const char *category,
+                      const uint32_t thread, const char *text,
+                      const size_t length, const uint32_t fields = 0);
+
+        /**
+         @brief Takes the oldest record (collector only).
+         @param record Receives the record.
+         @param category Receives the category name (empty for the global
+         category).
+         @return False if there is no published record.
+         */
+        bool consume (LogRecord &record, std::string &category);
+
+        /**
+         @brief Tries to become the collector of the ring.
+         @details Succeeds if there is no collector or it is dead.
+         @return True if this process is the collector.
+         */
+        bool claimCollector ();
+
+        /** Gives up the collector role. */
+        void releaseCollector ();
+
+        /** Number of slots. */
+        size_t capacity () const;
+        
+        /** Records lost since the last call (full ring, dead producers,
+         corrupt slots). */
+        uint64_t takeLost ();
+
+    private:
+        struct Header;
+        struct Slot;
+
+        LogSharedRing (void *memory, const size_t size);
+
+        Slot *slot (const uint64_t position) const;
+
+        // takes a stalled slot back, true if it was skipped
+        bool reclaim (Slot *slot, const uint64_t position);
+
+        void *_memory;
+        size_t _size;
+        Header *_header;
+        char *_slots;
+
+        // collector state (local): since when the oldest slot is stalled
+        uint64_t _stalledPosition { UINT64_MAX };
+        std::chrono::steady_clock::time_point _stalledSince;
+    };
+}
+
+#endif // defined(__RGPUtils__LogSharedRing_H__) header guard
@@ -0,0 +1,772 @@
+/*
+ RGPUtils
+ LogSink.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/LogSink.h>
+#include <rgp/LogPattern.h>
+#include <rgp/LogFields.h>
+
+#include "LogFile.h"
+#include "LogBatchFile.h"
+#include "LogClock.h"
+#include "LogMetricsRecorder.h"
+#include "LogSgr.h"
+#include "LogHeldOutput.h"
+
+#include <iostream> // cout / cerr
+#include <thread>
+#include <cstring>
+#include <cerrno>
+
+#if defined(__APPLE__) || defined(__unix__)
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif // defined(__APPLE__) || defined(__unix__)
+
+using namespace rgp;
+
+// LogSinkRecord
+
+void LogSinkRecord::reset (const int64_t timestamp, const bool error,
+                           const Loglevel level, const AnsiSgrFgColor fgcolor,
+                           const AnsiSgrBgColor bgcolor, const char *text,
+                           const size_t length, const char *category,
+                           const uint32_t thread, const size_t fields)
+{
+    _timestamp = timestamp;
+    _error = error;
+    _level = level;
+    _fgcolor = fgcolor;
+    _bgcolor = bgcolor;
+    _text = text;
+    _length = length - fields;
+    _category = category;
+    _thread = thread;
+    _fields = text + _length;
+    _fieldsLength = fields;
+    _fieldsFormatted = false;
+    _pattern = nullptr;
+
+    for (size_t i = 0; i < kLogLayoutCount; i++) {
+        _formatted[i] = false;
+    }
+}
+
+const std::string &LogSinkRecord::line (const LogLayout layout) const
+{
+    std::string &line = _lines[layout];
+    if (_formatted[layout]) {
+        return line;
+    }
+
+    line.clear();
+
+    if (layout == LogLayoutLogfmt || layout == LogLayoutJson) {
+        if (layout == LogLayoutLogfmt) {
+            formatLogfmt(line);
+        } else {
+            formatJson(line);
+        }
+        _formatted[layout] = true;
+        return line;
+    }
+
+    if (layout != LogLayoutMessage) {
+        char time[LogClock::kFormattedLength + 1];
+        LogClock::format(_timestamp, time);
+        time[LogClock::kFormattedLength] = ' ';
+        line.append(time, sizeof(time));
+    }
+
+    if (layout == LogLayoutDetailed) {
+        if (_error) {
+            line.append("ERROR ", 6);
+        } else if (_level == LoglevelVerbose) {
+            line.append("VERBOSE ", 8);
+        } else {
+            line.append("INFO ", 5);
+        }
+    }
+
+    if (_category != nullptr) {
+        line += '[';
+        line.append(_category);
+        line.append("] ", 2);
+    }
+
+    line.append(_text, _length);
+    line += fieldsText();
+    line += '\n';
+
+    _formatted[layout] = true;
+    return line;
+}
+
+const std::string &LogSinkRecord::fieldsText () const
+{
+    if (!_fieldsFormatted) {
+        _fieldsText.clear();
+        logFieldsAppendLogfmt(_fieldsText, _fields, _fieldsLength);
+        _fieldsFormatted = true;
+    }
+    return _fieldsText;
+}
+
+// the name of the level in the structured layouts
+static const char *structuredLevel (const bool error, const Loglevel level)
+{
+    return error ? "error" : level == LoglevelVerbose ? "verbose" : "info";
+}
+
+void LogSinkRecord::formatLogfmt (std::string &line) const
+{
+    char time[LogClock::kFormattedLength];
+    LogClock::format(_timestamp, time);
+
+    line.append("ts=", 3);
+    line.append(time, sizeof(time));
+    line.append(" level=", 7);
+    line.append(structuredLevel(_error, _level));
+    if (_category != nullptr) {
+        line.append(" category=", 10);
+        logfmtAppendString(line, _category, strlen(_category));
+    }
+    if (_thread != 0) {
+        line.append(" thread=", 8);
+        logFormatValue(line, (unsigned long long)_thread);
+    }
+    line.append(" msg=", 5);
+    logJsonAppendString(line, _text, _length);
+    line += fieldsText();
+    line += '\n';
+}
+
+void LogSinkRecord::formatJson (std::string &line) const
+{
+    char time[LogClock::kFormattedLength];
+    LogClock::format(_timestamp, time);
+
+    line.append("{\"ts\":\"", 7);
+    line.append(time, sizeof(time));
+    line.append("\",\"level\":\"", 11);
+    line.append(structuredLevel(_error, _level));
+    line += '"';
+    if (_category != nullptr) {
+        line.append(",\"category\":", 12);
+        logJsonAppendString(line, _category, strlen(_category));
+    }
+    if (_thread != 0) {
+        line.append(",\"thread\":", 10);
+        logFormatValue(line, (unsigned long long)_thread);
+    }
+    line.append(",\"msg\":", 7);
+    logJsonAppendString(line, _text, _length);
+    logFieldsAppendJson(line, _fields, _fieldsLength);
+    line.append("}\n", 2);
+}
+
+const std::string &LogSinkRecord::line (const LogPattern &pattern) const
+{
+    if (_pattern != &pattern) {
+        _patternLine.clear();
+        pattern.format(*this, _patternLine);
+        _pattern = &pattern;
+    }
+    return _patternLine;
+}
+
+// LogSink
+
+LogSink::LogSink (const LogLayout layout) : _layout(layout)
+{
+}
+
+LogSink::LogSink (const LogLayout layout, const bool serialized)
+    : _layout(layout), _serialized(serialized)
+{
+}
+
+LogSink::~LogSink ()
+{
+}
+
+void LogSink::setPattern (const std::shared_ptr<const LogPattern> &pattern)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _pattern = pattern;
+}
+
+const std::string &LogSink::line (const LogSinkRecord &record) const
+{
+    if (_pattern) {
+        return record.line(*_pattern);
+    }
+    return record.line(_layout);
+}
+
+void LogSink::setLoglevel (const Loglevel level)
+{
+    _loglevel.store(level);
+}
+
+Loglevel LogSink::loglevel () const
+{
+    return _loglevel.load();
+}
+
+void LogSink::setStreams (const uint8_t streams)
+{
+    _streams.store(streams);
+}
+
+uint8_t LogSink::streams () const
+{
+    return _streams.load();
+}
+
+bool LogSink::accepts (const LogSinkRecord &record) const
+{
+    uint8_t stream = record.error() ? LogSinkStreamError : LogSinkStreamOutput;
+    return (_streams.load(std::memory_order_relaxed) & stream) != 0 &&
+        record.level() <= _loglevel.load(std::memory_order_relaxed);
+}
+
+void LogSink::consume (const LogSinkRecord &record)
+{
+    if (!_serialized) {
+        write(record);
+
+        _messages.fetch_add(1, std::memory_order_relaxed);
+        if (LogMetricsRecorder::enabled()) {
+            _bytes.fetch_add(line(record).size(),
+                             std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    write(record);
+
+    _messages.store(_messages.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+    if (LogMetricsRecorder::enabled()) {
+        _bytes.store(_bytes.load(std::memory_order_relaxed) +
+                     line(record).size(), std::memory_order_relaxed);
+    }
+}
+
+uint64_t LogSink::messages () const
+{
+    return _messages.load(std::memory_order_relaxed);
+}
+
+uint64_t LogSink::bytes () const
+{
+    return _bytes.load(std::memory_order_relaxed);
+}
+
+void LogSink::flush ()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    flushBuffers();
+}
+
+void LogSink::flushIfDue ()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    flushBuffersIfDue();
+}
+
+void LogSink::close ()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    closeOutput();
+}
+
+void LogSink::holdConsoleOutput (const bool hold)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    setConsoleOutputHeld(hold);
+}
+
+// LogFileSink
+
+LogFileSink::LogFileSink (const std::string &filePath, const LogLayout layout)
+    : LogSink(layout), _file(new LogFile())
+{
+    _file->open(filePath);
+}
+
+LogFileSink::~LogFileSink ()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _file->close();
+}
+
+bool LogFileSink::isOpen () const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _file->isOpen();
+}
+
+void LogFileSink::reopen ()
+{
+    _file->requestReopen();
+}
+
+void LogFileSink::write (const LogSinkRecord &record)
+{
+    const std::string &line = this->line(record);
+    _file->write(line.data(), line.size());
+}
+
+void LogFileSink::flushBuffers ()
+{
+    _file->flush();
+}
+
+void LogFileSink::flushBuffersIfDue ()
+{
+    _file->flushIfDue();
+}
+
+// LogBatchFileSink
+
+LogBatchFileSink::LogBatchFileSink (const std::string &filePath,
+                                    const LogLayout layout,
+                                    const size_t chunkSize,
+                                    const size_t chunkCount,
+                                    const LogBatchBackend backend)
+    : LogSink(layout), _file(new LogBatchFile(chunkSize, chunkCount))
+{
+    _file->open(filePath, backend);
+}
+
+LogBatchFileSink::~LogBatchFileSink ()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _file->close();
+}
+
+bool LogBatchFileSink::isOpen () const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _file->isOpen();
+}
+
+LogBatchBackend LogBatchFileSink::backend () const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _file->backend();
+}
+
+void LogBatchFileSink::setFlushInterval (const unsigned int milliseconds)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _file->setFlushInterval(std::chrono::milliseconds(milliseconds));
+}
+
+void LogBatchFileSink::write (const LogSinkRecord &record)
+{
+    const std::string &line = this->line(record);
+    _file->append(line.data(), line.size());
+}
+
+void LogBatchFileSink::flushBuffers ()
+{
+    _file->flush();
+}
+
+void LogBatchFileSink::flushBuffersIfDue ()
+{
+    _file->flushIfDue();
+}
+
+// LogMappedFileSink
+
+struct LogMappedFileSink::Segment {
+    int fd { -1 };
+    char *data { nullptr };
+    size_t size { 0 };
+    // bytes handed out to writers (may grow past size)
+    std::atomic<uint64_t> reserved { 0 };
+    // bytes the writers finished copying
+    std::atomic<uint64_t> committed { 0 };
+    // where the data ends, set by the writer whose record crossed the end
+    std::atomic<uint64_t> end { UINT64_MAX };
+};
+
+LogMappedFileSink::LogMappedFileSink (const std::string &filePath,
+                                      const LogLayout layout,
+                                      const size_t segmentSize)
+    : LogSink(layout, false), _path(filePath),
+      _segmentSize(segmentSize > 0 ? segmentSize : 1)
+{
+    _segment.store(openSegment());
+}
+
+LogMappedFileSink::~LogMappedFileSink ()
+{
+    closeOutput();
+}
+
+bool LogMappedFileSink::isOpen () const
+{
+    return _segment.load() != nullptr;
+}
+
+uint64_t LogMappedFileSink::segments () const
+{
+    return _segmentCount.load();
+}
+
+uint64_t LogMappedFileSink::dropped () const
+{
+    return _dropped.load();
+}
+
+void LogMappedFileSink::write (const LogSinkRecord &record)
+{
+    const std::string &line = this->line(record);
+    const uint64_t length = line.size();
+
+    if (length > _segmentSize) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    for (;;) {
+        Segment *segment = _segment.load(std::memory_order_acquire);
+        if (segment == nullptr) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        uint64_t offset = segment->reserved.fetch_add(length,
+                                                      std::memory_order_relaxed);
+        if (RGPLOG_LIKELY(offset + length <= segment->size)) {
+            memcpy(segment->data + offset, line.data(), (size_t)length);
+            segment->committed.fetch_add(length, std::memory_order_release);
+            return;
+        }
+
+        if (offset <= segment->size) {
+            // our record crossed the end -> we roll, the data ends at offset
+            segment->end.store(offset, std::memory_order_release);
+            roll(segment, offset);
+        } else {
+            // another thread rolls
+            while (_segment.load(std::memory_order_acquire) == segment) {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
+
+void LogMappedFileSink::roll (Segment *full, const uint64_t end)
+{
+    std::lock_guard<std::mutex> lock(_rollMutex);
+
+    // closed meanwhile (closeOutput() cuts the segment)
+    if (_segment.load(std::memory_order_relaxed) != full) {
+        return;
+    }
+
+    _segment.store(openSegment(), std::memory_order_release);
+
+    // writers that reserved space before us may still be copying
+    while (full->committed.load(std::memory_order_acquire) < end) {
+        std::this_thread::yield();
+    }
+
+    closeSegment(full, end);
+}
+
+void LogMappedFileSink::closeOutput ()
+{
+    Segment *segment;
+    {
+        std::lock_guard<std::mutex> lock(_rollMutex);
+        segment = _segment.exchange(nullptr, std::memory_order_acq_rel);
+    }
+    if (segment == nullptr) {
+        return;
+    }
+
+    // writers that still see the segment get an offset past its end
+    uint64_t length = segment->reserved.fetch_add(segment->size + 1,
+                                                  std::memory_order_relaxed);
+    if (length > segment->size) {
+        // a record crossed the end before, the data ends where it starts
+        while ((length = segment->end.load(std::memory_order_acquire)) ==
+               UINT64_MAX) {
+            std::this_thread::yield();
+        }
+    }
+
+    // writers that reserved space before may still be copying
+    while (segment->committed.load(std::memory_order_acquire) < length) {
+        std::this_thread::yield();
+    }
+
+    closeSegment(segment, length);
+}
+
+LogMappedFileSink::Segment *LogMappedFileSink::openSegment ()
+{
+#if defined(__APPLE__) || defined(__unix__)
+    std::unique_ptr<Segment> segment(new Segment());
+    segment->size = _segmentSize;
+
+    // the next number that is not taken yet
+    for (;;) {
+        std::string path = _path;
+        logFormat(path, ".{}", _nextIndex);
+        _nextIndex++;
+
+        segment->fd = ::open(path.c_str(),
+                             O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if (segment->fd >= 0) {
+            break;
+        }
+        if (errno != EEXIST) {
+            return nullptr;
+        }
+    }
+
+    // allocate the blocks now, page faults later don't have to
+    int result = -1;
+#if defined(__linux__)
+    result = ::posix_fallocate(segment->fd, 0, (off_t)segment->size);
+#endif // defined(__linux__)
+    if (result != 0) {
+        // no preallocation -> at least the size (sparse file)
+        result = ::ftruncate(segment->fd, (off_t)segment->size);
+    }
+    if (result != 0) {
+        ::close(segment->fd);
+        return nullptr;
+    }
+
+    void *data = ::mmap(nullptr, segment->size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED, segment->fd, 0);
+    if (data == MAP_FAILED) {
+        ::close(segment->fd);
+        return nullptr;
+    }
+    segment->data = static_cast<char *>(data);
+
+    _segments.push_back(std::move(segment));
+    _segmentCount.fetch_add(1);
+    return _segments.back().get();
+#else
+    return nullptr;
+#endif // defined(__APPLE__) || defined(__unix__)
+}
+
+void LogMappedFileSink::closeSegment (Segment *segment, const uint64_t length)
+{
+#if defined(__APPLE__) || defined(__unix__)
+    ::munmap(segment->data, segment->size);
+    segment->data = nullptr;
+
+    // drop the preallocated rest
+    if (::ftruncate(segment->fd, (off_t)length) != 0) {
+        // the file keeps its size (zeros at the end)
+    }
+    ::close(segment->fd);
+    segment->fd = -1;
+#else
+    (void)segment;
+    (void)length;
+#endif // defined(__APPLE__) || defined(__unix__)
+}
+
+// LogConsoleSink
+
+LogConsoleSink::LogConsoleSink (const bool useAnsiSgrCodes,
+                                const LogLayout layout)
+    : LogSink(layout), _useAnsiSgrCodes(useAnsiSgrCodes),
+      _heldOutput(new LogHeldOutput())
+{
+}
+
+LogConsoleSink::~LogConsoleSink ()
+{
+}
+
+void LogConsoleSink::setConsoleOutputHeld (const bool held)
+{
+    if (!held && _held) {
+        _heldOutput->release();
+    }
+    _held = held;
+}
+
+void LogConsoleSink::write (const LogSinkRecord &record)
+{
+    const std::string &line = this->line(record);
+
+    // a pattern places the colors itself (%^ and %$)
+    bool colored = !record.error() && _useAnsiSgrCodes && !pattern() &&
+        logSgrColored(record.fgcolor(), record.bgcolor());
+
+    // a prompt waits for input -> written when it returns
+    _heldOutput->write(_held, record.error(), line, colored,
+                       record.fgcolor(), record.bgcolor());
+}
+
+// LogMemorySink
+
+LogMemorySink::LogMemorySink (const size_t capacity, const LogLayout layout)
+    : LogSink(layout), _lines(capacity > 0 ? capacity : 1)
+{
+}
+
+std::vector<std::string> LogMemorySink::lines () const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::vector<std::string> lines;
+    lines.reserve(_count);
+
+    size_t first = (_next + _lines.size() - _count) % _lines.size();
+    for (size_t i = 0; i < _count; i++) {
+        lines.push_back(_lines[(first + i) % _lines.size()]);
+    }
+
+    return lines;
+}
+
+void LogMemorySink::clear ()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _next = 0;
+    _count = 0;
+}
+
+void LogMemorySink::write (const LogSinkRecord &record)
+{
+    // without the newline (assign() keeps the capacity of the slot)
+    const std::string &line = this->line(record);
+    _lines[_next].assign(line.data(), line.size() - 1);
+
+    _next = (_next + 1) % _lines.size();
+    if (_count < _lines.size()) {
+        _count++;
+    }
+}
+
+// LogSocketSink
+
+LogSocketSink::LogSocketSink (const std::string &socketPath,
+                              const LogLayout layout)
+    : LogSink(layout), _path(socketPath)
+{
+    connectSocket();
+}
+
+LogSocketSink::~LogSocketSink ()
+{
+#if defined(__APPLE__) || defined(__unix__)
+    if (_socket >= 0) {
+        ::close(_socket);
+    }
+#endif // defined(__APPLE__) || defined(__unix__)
+}
+
+bool LogSocketSink::isOpen () const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _socket >= 0;
+}
+
+uint64_t LogSocketSink::dropped () const
+{
+    return _dropped.load();
+}
+
+bool LogSocketSink::connectSocket ()
+{
+#if defined(__APPLE__) || defined(__unix__)
+    if (_socket >= 0) {
+        ::close(_socket);
+        _socket = -1;
+    }
+
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    if (_path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, _path.c_str(), _path.size() + 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    // never wait for a slow receiver
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    if (::connect(fd, (const sockaddr *)&address, sizeof(address)) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    _socket = fd;
+    return true;
+#else
+    return false;
+#endif // defined(__APPLE__) || defined(__unix__)
+}
+
+void LogSocketSink::write (const LogSinkRecord &record)
+{
+#if defined(__APPLE__) || defined(__unix__)
+    // the receiver may have been restarted -> try to connect again
+    if (_socket < 0 && !connectSocket()) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const std::string &line = this->line(record);
+    if (::send(_socket, line.data(), line.size() - 1, 0) < 0) {
+        if (errno == ECONNREFUSED || errno == ENOTCONN) {
+            ::close(_socket);
+            _socket = -1;
+        }
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+#else
+    (void)record;
+    _dropped.fetch_add(1, std::memory_order_relaxed);
+#endif // defined(__APPLE__) || defined(__unix__)
+}
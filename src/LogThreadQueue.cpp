@@ -0,0 +1,87 @@
+/*
+ RGPUtils
+ LogThreadQueue.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include "LogThreadQueue.h"
+
+using namespace rgp;
+
+// initial capacity of the text buffer of every slot
+static const size_t kReservedTextSize = 256;
+
+LogThreadQueue::LogThreadQueue (const size_t capacity)
+{
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    _mask = size - 1;
+    _records.reset(new LogRecord[size]);
+
+    for (size_t i = 0; i < size; i++) {
+        _records[i].text.reserve(kReservedTextSize);
+    }
+}
+
+LogRecord *LogThreadQueue::tryClaim ()
+{
+    uint64_t head = _head.load(std::memory_order_relaxed);
+
+    if (head - _cachedTail > _mask) {
+        _cachedTail = _tail.load(std::memory_order_acquire);
+        if (head - _cachedTail > _mask) {
+            return nullptr;
+        }
+    }
+
+    return &_records[head & _mask];
+}
+
+void LogThreadQueue::publish ()
+{
+    _head.store(_head.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+}
+
+LogRecord *LogThreadQueue::front ()
+{
+    uint64_t tail = _tail.load(std::memory_order_relaxed);
+
+    if (tail == _cachedHead) {
+        _cachedHead = _head.load(std::memory_order_acquire);
+        if (tail == _cachedHead) {
+            return nullptr;
+        }
+    }
+
+    return &_records[tail & _mask];
+}
+
+void LogThreadQueue::pop ()
+{
+    _tail.store(_tail.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+}
@@ -0,0 +1,116 @@
+/*
+ RGPUtils
+ LogThreadQueue.h
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ A bounded single-producer / single-consumer ring of log records owned by
+ one logging thread.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGPUtils__LogThreadQueue_H__
+#define __RGPUtils__LogThreadQueue_H__
+
+#include "LogRecord.h"
+#include "LogAligned.h"
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+namespace rgp {
+
+    /**
+     @brief Bounded lock-free SPSC queue of LogRecords.
+     @details Used instead of the shared LogQueue when every logging thread
+     gets its own buffer. The producer and the consumer only share the two
+     positions, each on its own cache line, and keep a cached copy of the
+     other side's position so they only touch the foreign cache line when
+     the queue looks full (or empty).
+     */
+    class LogThreadQueue : public LogCacheAligned {
+
+    public:
+        /**
+         @brief Creates a queue.
+         @param capacity Number of slots. Will be rounded up to the next power
+         of two (minimum 2).
+         */
+        explicit LogThreadQueue (const size_t capacity);
+
+        /**
+         @brief Claims the next slot (producer only).
+         @return The record to fill or nullptr if the queue is full.
+         */
+        LogRecord *tryClaim ();
+
+        /** Makes the claimed slot visible to the consumer (producer only). */
+        void publish ();
+
+        /**
+         @brief The oldest published record (consumer only).
+         @return The record or nullptr if there is nothing to read.
+         */
+        LogRecord *front ();
+
+        /** Releases the record returned by front() (consumer only). */
+        void pop ();
+
+        /** Number of records published so far. */
+        uint64_t enqueuePosition () const {
+            return _head.load(std::memory_order_acquire);
+        };
+
+        /** Number of records released by the consumer so far. */
+        uint64_t dequeuePosition () const {
+            return _tail.load(std::memory_order_acquire);
+        };
+
+        /** Marks the queue as abandoned by its thread (thread exit). */
+        void retire () { _retired.store(true, std::memory_order_release); };
+
+        /** Determines if the owning thread has exited. */
+        bool retired () const {
+            return _retired.load(std::memory_order_acquire);
+        };
+
+    private:
+        LogThreadQueue (const LogThreadQueue &) = delete;
+        LogThreadQueue &operator = (const LogThreadQueue &) = delete;
+
+        std::unique_ptr<LogRecord[]> _records;
+        size_t _mask;
+
+        std::atomic<bool> _retired { false };
+
+        // producer side
+        alignas(64) std::atomic<uint64_t> _head { 0 };
+        uint64_t _cachedTail { 0 };
+
+        // consumer side
+        alignas(64) std::atomic<uint64_t> _tail { 0 };
+        uint64_t _cachedHead { 0 };
+    };
+}
+
+#endif // defined(__RGPUtils__LogThreadQueue_H__) header guard
@@ -0,0 +1,287 @@
+/*
+ RGPUtils
+ LogTrace.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/LogTrace.h>
+
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <fstream>
+#include <cstdio>
+
+#if defined(__APPLE__) || defined(__unix__)
+#include <unistd.h> // getpid
+#elif defined(_WIN32)
+#include <process.h> // _getpid
+#endif // defined(__APPLE__) || defined(__unix__) // defined(_WIN32)
+
+using namespace rgp;
+
+std::atomic<bool> LogTrace::_enabled { false };
+
+namespace {
+
+    struct TraceEvent {
+        const char *name;
+        int64_t begin;
+        int64_t end;
+        uint32_t thread;
+    };
+
+    // written by one thread at a time (its owner), read by the export
+    struct TraceRing {
+        std::unique_ptr<TraceEvent[]> events;
+        size_t mask { 0 };
+        // number of events ever written
+        std::atomic<uint64_t> position { 0 };
+        // events before this position got cleared
+        std::atomic<uint64_t> cleared { 0 };
+        // true after the owning thread has exited
+        std::atomic<bool> retired { false };
+    };
+
+    // the rings of all threads
+    struct TraceState {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<TraceRing>> rings;
+        size_t capacity { 16384 };
+    };
+
+    // never destroyed: threads may still trace while the process exits
+    TraceState &state ()
+    {
+        static TraceState *traceState = new TraceState();
+        return *traceState;
+    }
+
+    // owns the ring of a thread and retires it on thread exit
+    struct TraceRingHandle {
+        std::shared_ptr<TraceRing> ring;
+
+        ~TraceRingHandle ();
+    };
+
+    thread_local TraceRingHandle traceRingHandle;
+
+    // fast access to the ring of the thread
+    thread_local TraceRing *traceRingPointer = nullptr;
+
+    // set while the thread exits (spans of other thread_local destructors
+    // are dropped)
+    thread_local bool traceRingRetired = false;
+
+    TraceRingHandle::~TraceRingHandle ()
+    {
+        traceRingRetired = true;
+        traceRingPointer = nullptr;
+        if (ring) {
+            ring->retired.store(true, std::memory_order_release);
+        }
+    }
+
+    // the ring of the calling thread (created or reused on first use),
+    // nullptr while the thread exits
+    TraceRing *threadRing ()
+    {
+        if (RGPLOG_LIKELY(traceRingPointer != nullptr)) {
+            return traceRingPointer;
+        }
+        if (traceRingRetired) {
+            return nullptr;
+        }
+
+        TraceState &traceState = state();
+        std::lock_guard<std::mutex> lock(traceState.mutex);
+
+        // the ring of an exited thread keeps its spans until it is reused
+        std::shared_ptr<TraceRing> ring;
+        for (size_t i = 0; i < traceState.rings.size(); i++) {
+            if (traceState.rings[i]->retired.load(std::memory_order_acquire) &&
+                traceState.rings[i]->mask + 1 == traceState.capacity) {
+                ring = traceState.rings[i];
+                ring->retired.store(false, std::memory_order_relaxed);
+                break;
+            }
+        }
+
+        if (!ring) {
+            ring = std::make_shared<TraceRing>();
+            ring->events.reset(new TraceEvent[traceState.capacity]);
+            ring->mask = traceState.capacity - 1;
+            traceState.rings.push_back(ring);
+        }
+
+        traceRingHandle.ring = ring;
+        traceRingPointer = ring.get();
+        return traceRingPointer;
+    }
+
+    // copies the events that are still in the ring
+    void copyEvents (const TraceRing &ring, std::vector<TraceEvent> &events)
+    {
+        const uint64_t capacity = ring.mask + 1;
+        uint64_t end = ring.position.load(std::memory_order_acquire);
+        uint64_t start = ring.cleared.load(std::memory_order_relaxed);
+        if (end > capacity && end - capacity > start) {
+            start = end - capacity;
+        }
+
+        size_t first = events.size();
+        for (uint64_t i = start; i < end; i++) {
+            events.push_back(ring.events[i & ring.mask]);
+        }
+
+        // the owner may have overwritten the oldest copied events meanwhile
+        // (including the one it is writing right now)
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t now = ring.position.load(std::memory_order_relaxed);
+        if (now + 1 > capacity && now + 1 - capacity > start) {
+            uint64_t overwritten = now + 1 - capacity - start;
+            if (overwritten > end - start) {
+                overwritten = end - start;
+            }
+            events.erase(events.begin() + first,
+                         events.begin() + first + (size_t)overwritten);
+        }
+    }
+
+    void appendEscaped (std::string &out, const char *text)
+    {
+        for (const char *c = text; *c != '\0'; c++) {
+            if (*c == '"' || *c == '\\') {
+                out += '\\';
+                out += *c;
+            } else if ((unsigned char)*c < 0x20) {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char)*c);
+                out += escaped;
+            } else {
+                out += *c;
+            }
+        }
+    }
+
+    // nanoseconds as microseconds with three decimals
+    void appendMicroseconds (std::string &out, const int64_t nanoseconds)
+    {
+        char number[32];
+        snprintf(number, sizeof(number), "%lld.%03d",
+                 (long long)(nanoseconds / 1000), (int)(nanoseconds % 1000));
+        out += number;
+    }
+}
+
+void LogTrace::setEnabled (const bool enabled, const size_t eventsPerThread)
+{
+    TraceState &traceState = state();
+    {
+        std::lock_guard<std::mutex> lock(traceState.mutex);
+        size_t capacity = 2;
+        while (capacity < eventsPerThread) {
+            capacity <<= 1;
+        }
+        traceState.capacity = capacity;
+    }
+    _enabled.store(enabled);
+}
+
+void LogTrace::clear ()
+{
+    TraceState &traceState = state();
+    std::lock_guard<std::mutex> lock(traceState.mutex);
+    for (size_t i = 0; i < traceState.rings.size(); i++) {
+        TraceRing &ring = *traceState.rings[i];
+        ring.cleared.store(ring.position.load(std::memory_order_acquire),
+                           std::memory_order_relaxed);
+    }
+}
+
+void LogTrace::record (const char *name, const int64_t begin,
+                       const int64_t end)
+{
+    TraceRing *ring = threadRing();
+    if (ring == nullptr) {
+        return;
+    }
+
+    uint64_t position = ring->position.load(std::memory_order_relaxed);
+    TraceEvent &event = ring->events[position & ring->mask];
+    event.name = name;
+    event.begin = begin;
+    event.end = end;
+    event.thread = Log::threadNumber();
+    ring->position.store(position + 1, std::memory_order_release);
+}
+
+std::string LogTrace::chromeJson ()
+{
+    std::vector<TraceEvent> events;
+    {
+        TraceState &traceState = state();
+        std::lock_guard<std::mutex> lock(traceState.mutex);
+        for (size_t i = 0; i < traceState.rings.size(); i++) {
+            copyEvents(*traceState.rings[i], events);
+        }
+    }
+
+#if defined(__APPLE__) || defined(__unix__)
+    const long pid = (long)getpid();
+#elif defined(_WIN32)
+    const long pid = (long)_getpid();
+#endif // defined(__APPLE__) || defined(__unix__) // defined(_WIN32)
+
+    std::string json;
+    json.reserve(64 + events.size() * 96);
+    json += "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+    for (size_t i = 0; i < events.size(); i++) {
+        const TraceEvent &event = events[i];
+        if (i > 0) {
+            json += ',';
+        }
+        json += "\n{\"name\":\"";
+        appendEscaped(json, event.name);
+        json += "\",\"cat\":\"rgp\",\"ph\":\"X\",\"ts\":";
+        appendMicroseconds(json, event.begin);
+        json += ",\"dur\":";
+        appendMicroseconds(json, event.end - event.begin);
+        logFormat(json, ",\"pid\":{},\"tid\":{}}}", pid, event.thread);
+    }
+
+    json += "\n]}\n";
+    return json;
+}
+
+bool LogTrace::exportChrome (const std::string &filePath)
+{
+    std::string json = chromeJson();
+
+    std::ofstream file(filePath.c_str(), std::ios::out | std::ios::trunc |
+                       std::ios::binary);
+    file.write(json.data(), (std::streamsize)json.size());
+    file.close();
+    return !file.fail();
+}
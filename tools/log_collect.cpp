@@ -0,0 +1,97 @@
+/*
+ RGPUtils
+ log_collect.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ Writes the records of a shared log ring (Log::useSharedRing()) to a
+ logfile, for setups where every worker process is a LogSharedRingProducer.
+
+ Usage: rgplog_collect [--errorfile <path>] <ring name> <logfile>
+
+ Runs until it receives SIGINT or SIGTERM, then writes the records that are
+ left in the ring.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <cstdlib>
+
+#include <rgp/Log.h>
+
+namespace {
+
+    volatile std::sig_atomic_t stopRequested = 0;
+
+    void requestStop (int)
+    {
+        stopRequested = 1;
+    }
+}
+
+int main (int argc, const char **argv)
+{
+    const char *errorfile = nullptr;
+    const char *ring = nullptr;
+    const char *logfile = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--errorfile") == 0 && i + 1 < argc) {
+            errorfile = argv[++i];
+        } else if (ring == nullptr) {
+            ring = argv[i];
+        } else {
+            logfile = argv[i];
+        }
+    }
+
+    if (ring == nullptr || logfile == nullptr) {
+        std::cerr << "usage: " << argv[0]
+                  << " [--errorfile <path>] <ring name> <logfile>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    rgp::Log *log = rgp::Log::sharedLog();
+    log->useLogfile(logfile);
+    log->useErrorfile(errorfile != nullptr ? errorfile : logfile);
+
+    if (!log->useSharedRing(ring, rgp::LogSharedRingCollector)) {
+        std::cerr << "unable to collect " << ring
+                  << " (no shared memory or another collector is running)"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    signal(SIGINT, requestStop);
+    signal(SIGTERM, requestStop);
+
+    while (!stopRequested) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    log->shutdown();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,312 @@
+/*
+ RGPUtils
+ log_decode.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ Turns a binary logfile (Log::useBinaryLogfile() / RGPLOG_BINARY()) back
+ into text.
+
+ Usage: rgplog_decode [--unsorted] <binary logfile>
+        rgplog_decode --decompress <rotated .rlz logfile>
+
+ By default the records of all threads are sorted by their timestamp before
+ they are printed. With --unsorted the records are printed in file order
+ while the file is read (needs no memory for large files).
+ With --decompress a logfile compressed by the rotation (LogRotation) is
+ written to stdout.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+
+#include <rgp/LogFormat.h>
+#include <rgp/LogCompressor.h>
+
+namespace {
+
+    // more call sites than any program registers (a larger id is corrupt)
+    const uint32_t kMaxCallSites = 1 << 20;
+
+    struct CallSite {
+        uint32_t line { 0 };
+        std::string file;
+        std::string format;
+        std::string types;
+    };
+
+    struct Line {
+        int64_t timestamp;
+        uint32_t thread;
+        std::string text;
+    };
+
+    // reads a value from the payload, returns false if the payload ended
+    template <typename T>
+    bool readValue (const char *&data, const char *end, T &value)
+    {
+        if ((size_t)(end - data) < sizeof(T)) {
+            return false;
+        }
+        memcpy(&value, data, sizeof(T));
+        data += sizeof(T);
+        return true;
+    }
+
+    // reads a terminated string from the payload, returns false if the
+    // terminator is missing
+    bool readString (const char *&data, const char *end, std::string &value)
+    {
+        const char *terminator = (const char *)memchr(data, '\0',
+                                                      (size_t)(end - data));
+        if (terminator == nullptr) {
+            return false;
+        }
+        value.assign(data, (size_t)(terminator - data));
+        data = terminator + 1;
+        return true;
+    }
+
+    // formats a timestamp (microseconds since epoch) as ISO-8601 local time
+    void formatTimestamp (std::string &out, const int64_t microseconds)
+    {
+        time_t seconds = (time_t)(microseconds / 1000000);
+        tm localTime;
+#if defined(_WIN32)
+        localtime_s(&localTime, &seconds);
+#else
+        localtime_r(&seconds, &localTime);
+#endif // defined(_WIN32)
+
+        char text[64];
+        size_t length = strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%S",
+                                 &localTime);
+        snprintf(text + length, sizeof(text) - length, ".%06d ",
+                 (int)(microseconds % 1000000));
+        out += text;
+    }
+
+    // formats the next argument of the given type
+    bool decodeArgument (std::string &out, const char type, const char *&data,
+                         const char *end)
+    {
+        switch (type) {
+            case 'i': { int32_t v; if (!readValue(data, end, v)) return false;
+                rgp::logFormatValue(out, (int)v); return true; }
+            case 'u': { uint32_t v; if (!readValue(data, end, v)) return false;
+                rgp::logFormatValue(out, (unsigned int)v); return true; }
+            case 'l': { int64_t v; if (!readValue(data, end, v)) return false;
+                rgp::logFormatValue(out, (long long)v); return true; }
+            case 'L': { uint64_t v; if (!readValue(data, end, v)) return false;
+                rgp::logFormatValue(out, (unsigned long long)v); return true; }
+            case 'd': { double v; if (!readValue(data, end, v)) return false;
+                rgp::logFormatValue(out, v); return true; }
+            case 'b': { char v; if (!readValue(data, end, v)) return false;
+                rgp::logFormatValue(out, v != 0); return true; }
+            case 'c': { char v; if (!readValue(data, end, v)) return false;
+                rgp::logFormatValue(out, v); return true; }
+            case 'p': { uint64_t v; if (!readValue(data, end, v)) return false;
+                rgp::logFormatValue(out, (const void *)(uintptr_t)v); return true; }
+            case 's': {
+                uint32_t length;
+                if (!readValue(data, end, length)) return false;
+                if ((size_t)(end - data) < length) return false;
+                out.append(data, length);
+                data += length;
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    // formats a record, returns false if the buffer is corrupt
+    bool decodeRecord (const std::vector<CallSite> &callSites, Line &line,
+                       const char *&data, const char *end)
+    {
+        uint32_t id;
+        if (!readValue(data, end, id) || !readValue(data, end, line.timestamp)) {
+            return false;
+        }
+        if (id == 0 || id > callSites.size()) {
+            return false;
+        }
+
+        const CallSite &callSite = callSites[id - 1];
+        line.text.clear();
+        formatTimestamp(line.text, line.timestamp);
+
+        const char *format = callSite.format.c_str();
+        for (size_t i = 0; i < callSite.types.size(); i++) {
+            format = rgp::logFormatLiteral(line.text, format);
+            if (format == nullptr) {
+                // argument without placeholder -> skip its bytes
+                std::string ignored;
+                if (!decodeArgument(ignored, callSite.types[i], data, end)) {
+                    return false;
+                }
+                continue;
+            }
+            if (!decodeArgument(line.text, callSite.types[i], data, end)) {
+                return false;
+            }
+        }
+        if (format != nullptr) {
+            rgp::logFormat(line.text, format);
+        }
+
+        return true;
+    }
+}
+
+int main (int argc, const char **argv)
+{
+    bool sorted = true;
+    bool decompress = false;
+    const char *path = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--unsorted") == 0) {
+            sorted = false;
+        } else if (strcmp(argv[i], "--decompress") == 0) {
+            decompress = true;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    if (path == nullptr) {
+        std::cerr << "usage: " << argv[0] << " [--unsorted] <binary logfile>"
+                  << std::endl << "       " << argv[0]
+                  << " --decompress <rotated .rlz logfile>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (decompress) {
+        if (!rgp::LogCompressor::decompressFile(path, std::cout)) {
+            std::cerr << "unable to decompress " << path << std::endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "unable to open " << path << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<CallSite> callSites;
+    std::vector<Line> lines;
+    std::vector<char> payload;
+    Line line;
+
+    for (;;) {
+        char kind;
+        if (!file.get(kind)) {
+            break;
+        }
+
+        if (kind == 'R') {
+            // "RGPBLOG1" -> new session with its own call site ids
+            char magic[7];
+            if (!file.read(magic, sizeof(magic)) ||
+                memcmp(magic, "GPBLOG1", sizeof(magic)) != 0) {
+                std::cerr << "not a binary logfile" << std::endl;
+                return EXIT_FAILURE;
+            }
+            callSites.clear();
+            continue;
+        }
+
+        uint32_t length;
+        if (!file.read((char *)&length, sizeof(length))) {
+            break;
+        }
+        payload.resize(length);
+        if (!file.read(payload.data(), length)) {
+            std::cerr << "file ends in the middle of a chunk" << std::endl;
+            break;
+        }
+
+        const char *data = payload.data();
+        const char *end = data + length;
+
+        if (kind == 'S') {
+            uint32_t id;
+            CallSite callSite;
+            if (!readValue(data, end, id) || !readValue(data, end, callSite.line) ||
+                id == 0 || id > kMaxCallSites ||
+                !readString(data, end, callSite.file) ||
+                !readString(data, end, callSite.format) ||
+                !readString(data, end, callSite.types)) {
+                std::cerr << "corrupt call site registration" << std::endl;
+                continue;
+            }
+
+            if (callSites.size() < id) {
+                callSites.resize(id);
+            }
+            callSites[id - 1] = callSite;
+
+        } else if (kind == 'B') {
+            if (!readValue(data, end, line.thread)) {
+                continue;
+            }
+            while (data < end) {
+                if (!decodeRecord(callSites, line, data, end)) {
+                    std::cerr << "corrupt record in buffer of thread "
+                              << line.thread << std::endl;
+                    break;
+                }
+                if (sorted) {
+                    lines.push_back(line);
+                } else {
+                    std::cout << line.text << '\n';
+                }
+            }
+        } else {
+            std::cerr << "unknown chunk '" << kind << "'" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (sorted) {
+        std::stable_sort(lines.begin(), lines.end(),
+                         [] (const Line &a, const Line &b) {
+                             return a.timestamp < b.timestamp;
+                         });
+        for (size_t i = 0; i < lines.size(); i++) {
+            std::cout << lines[i].text << '\n';
+        }
+    }
+
+    std::cout << std::flush;
+    return EXIT_SUCCESS;
+}
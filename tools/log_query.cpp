@@ -0,0 +1,457 @@
+/*
+ RGPUtils
+ log_query.cpp
+
+ Created by Ralph-Gordon Paul on 18. October 2026.
+
+ Prints the lines of a text logfile within a time window, uses the side
+ index (Log::setLogfileIndex()) to read only the blocks that can match.
+
+ Usage: rgplog_query [--from <time>] [--to <time>] [--level <level>]
+                     [--grep <text>] [--no-index] [--stats] <logfile>
+
+ Times are local times like the timestamps in the file, from a date to
+ microseconds: "2026-10-18", "2026-10-18T09:15", "2026-10-18 09:15:02.5".
+ --from is inclusive, --to includes everything up to the end of the given
+ precision ("09:15" means up to 09:15:59.999999). The level is info,
+ verbose or error: blocks without such records are skipped, lines with a
+ level name behind the timestamp (LogLayoutDetailed, "%l") are matched
+ exactly. --grep keeps only lines that contain the text.
+ Lines without a timestamp at the start belong to the record before.
+ logfmt and JSON lines (Log::setLogfileEncoding()) are read as well.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+#include <rgp/LogIndex.h>
+
+namespace {
+
+    // length of a timestamp in the logfile ("2026-10-18T09:15:02.123456")
+    const size_t kTimestampLength = 26;
+
+    // size of the reads
+    const size_t kChunkSize = 1024 * 1024;
+
+    // a part of the logfile
+    struct Range {
+        uint64_t offset;
+        uint64_t length;
+        // false: lines without a timestamp are only printed if there is
+        // no time window (the part isn't indexed)
+        bool indexed;
+    };
+
+    struct Query {
+        std::string from;
+        std::string to;
+        bool window { false };
+        uint8_t levels { 0 };
+        std::string grep;
+    };
+
+    struct Statistics {
+        uint64_t blocks { 0 };
+        uint64_t candidates { 0 };
+        uint64_t scanned { 0 };
+        uint64_t matches { 0 };
+    };
+
+    bool isDigit (const char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    /*
+     Completes a time given on the command line with the rest of the
+     template (the earliest or the latest time of the given precision),
+     false if the time doesn't follow the format of the timestamps.
+     */
+    bool completeTime (const char *text, const char *pattern, std::string &time)
+    {
+        time = pattern;
+        size_t length = strlen(text);
+        if (length < 10 || length > kTimestampLength) {
+            return false;
+        }
+        for (size_t i = 0; i < length; i++) {
+            char c = text[i] == ' ' ? 'T' : text[i];
+            if (isDigit(pattern[i]) ? !isDigit(c) : c != pattern[i]) {
+                return false;
+            }
+            time[i] = c;
+        }
+        // no separator without digits behind it
+        return isDigit(time[length - 1]);
+    }
+
+    // microseconds since the epoch of a completed local time
+    int64_t epochOf (const std::string &time)
+    {
+        struct tm local;
+        memset(&local, 0, sizeof(local));
+        local.tm_year = atoi(time.substr(0, 4).c_str()) - 1900;
+        local.tm_mon = atoi(time.substr(5, 2).c_str()) - 1;
+        local.tm_mday = atoi(time.substr(8, 2).c_str());
+        local.tm_hour = atoi(time.substr(11, 2).c_str());
+        local.tm_min = atoi(time.substr(14, 2).c_str());
+        local.tm_sec = atoi(time.substr(17, 2).c_str());
+        local.tm_isdst = -1;
+        return (int64_t)mktime(&local) * 1000000 +
+            atoi(time.substr(20, 6).c_str());
+    }
+
+    bool hasTimestamp (const char *line, const size_t length)
+    {
+        return length >= kTimestampLength && line[4] == '-' &&
+            line[7] == '-' && line[10] == 'T' && line[13] == ':' &&
+            line[16] == ':' && line[19] == '.' && isDigit(line[0]) &&
+            isDigit(line[25]);
+    }
+
+    bool startsWith (const char *data, const size_t length,
+                     const char *prefix, const size_t prefixLength)
+    {
+        return length >= prefixLength &&
+            memcmp(data, prefix, prefixLength) == 0;
+    }
+
+    // the timestamp at the start of a line (behind "ts=" or {"ts":" in
+    // logfmt and JSON lines), nullptr if there is none
+    const char *timestampOf (const char *line, const size_t length)
+    {
+        size_t skip = 0;
+        if (startsWith(line, length, "ts=", 3)) {
+            skip = 3;
+        } else if (startsWith(line, length, "{\"ts\":\"", 7)) {
+            skip = 7;
+        }
+        return hasTimestamp(line + skip, length - skip) ? line + skip : nullptr;
+    }
+
+    // the level name behind the timestamp, 0 if there is none
+    uint8_t levelOf (const char *timestamp, const size_t length)
+    {
+        const char *name = timestamp + kTimestampLength;
+        size_t rest = length - kTimestampLength;
+        char end = ' ';
+
+        if (startsWith(name, rest, " level=", 7)) {
+            name += 7;
+            rest -= 7;
+        } else if (startsWith(name, rest, "\",\"level\":\"", 11)) {
+            name += 11;
+            rest -= 11;
+            end = '"';
+        } else if (startsWith(name, rest, " ", 1)) {
+            // upper case in the text layouts
+            name += 1;
+            rest -= 1;
+            if (startsWith(name, rest, "INFO ", 5)) {
+                return rgp::LogIndexLevelInfo;
+            }
+            if (startsWith(name, rest, "ERROR ", 6)) {
+                return rgp::LogIndexLevelError;
+            }
+            if (startsWith(name, rest, "VERBOSE ", 8)) {
+                return rgp::LogIndexLevelVerbose;
+            }
+            return 0;
+        } else {
+            return 0;
+        }
+
+        if (startsWith(name, rest, "info", 4) && rest > 4 && name[4] == end) {
+            return rgp::LogIndexLevelInfo;
+        }
+        if (startsWith(name, rest, "error", 5) && rest > 5 && name[5] == end) {
+            return rgp::LogIndexLevelError;
+        }
+        if (startsWith(name, rest, "verbose", 7) && rest > 7 && name[7] == end) {
+            return rgp::LogIndexLevelVerbose;
+        }
+        return 0;
+    }
+
+    // memchr for the first character, memcmp for the rest
+    bool contains (const char *data, const size_t length,
+                   const std::string &text)
+    {
+        if (text.empty()) {
+            return true;
+        }
+        const char *end = data + length;
+        const char *c = data;
+        while (end - c >= (ptrdiff_t)text.size()) {
+            c = (const char *)memchr(c, text[0], (size_t)(end - c) - text.size() + 1);
+            if (c == nullptr) {
+                return false;
+            }
+            if (memcmp(c, text.data(), text.size()) == 0) {
+                return true;
+            }
+            c++;
+        }
+        return false;
+    }
+
+    // the parts of the file that have to be read
+    std::vector<Range> candidates (const std::vector<rgp::LogIndexEntry> &entries,
+                                   const uint64_t fileSize, const Query &query,
+                                   const int64_t from, const int64_t to,
+                                   Statistics &statistics)
+    {
+        std::vector<Range> ranges;
+        uint64_t position = 0;
+
+        for (size_t i = 0; i < entries.size(); i++) {
+            const rgp::LogIndexEntry &entry = entries[i];
+            if (entry.offset < position || entry.offset >= fileSize) {
+                continue;
+            }
+            statistics.blocks++;
+
+            // not indexed (f.e. the tail of a file that wasn't closed)
+            if (entry.offset > position) {
+                Range gap = { position, entry.offset - position, false };
+                ranges.push_back(gap);
+            }
+
+            uint64_t length = entry.length;
+            if (entry.offset + length > fileSize) {
+                length = fileSize - entry.offset;
+            }
+            position = entry.offset + length;
+
+            bool match = (!query.window ||
+                          (entry.maxTime >= from && entry.minTime <= to)) &&
+                (query.levels == 0 || (entry.levels & query.levels) != 0);
+            if (!match) {
+                continue;
+            }
+            statistics.candidates++;
+
+            // merge with the block before
+            if (!ranges.empty() && ranges.back().indexed &&
+                ranges.back().offset + ranges.back().length == entry.offset) {
+                ranges.back().length += length;
+            } else {
+                Range range = { entry.offset, length, true };
+                ranges.push_back(range);
+            }
+        }
+
+        if (position < fileSize) {
+            Range tail = { position, fileSize - position, false };
+            ranges.push_back(tail);
+        }
+        return ranges;
+    }
+
+    // prints the matching lines of a part of the file
+    void scan (std::ifstream &file, const Range &range, const Query &query,
+               std::vector<char> &buffer, Statistics &statistics)
+    {
+        file.clear();
+        file.seekg((std::streamoff)range.offset);
+
+        // decision for lines without a timestamp
+        bool printing = range.indexed || !query.window;
+
+        // a line that continues in the next chunk is moved to the front
+        size_t carried = 0;
+        uint64_t remaining = range.length;
+
+        while (remaining > 0 || carried > 0) {
+            size_t want = remaining < kChunkSize ? (size_t)remaining : kChunkSize;
+            if (carried + want > buffer.size()) {
+                buffer.resize(carried + want);
+            }
+            file.read(buffer.data() + carried, (std::streamsize)want);
+            size_t got = (size_t)file.gcount();
+            remaining = got < want ? 0 : remaining - got;
+            statistics.scanned += got;
+
+            const char *data = buffer.data();
+            const char *end = data + carried + got;
+            const char *line = data;
+
+            for (;;) {
+                const char *newline = (const char *)memchr(line, '\n',
+                                                           (size_t)(end - line));
+                if (newline == nullptr) {
+                    if (remaining > 0) {
+                        break;
+                    }
+                    // last line without a newline
+                    newline = end;
+                    if (line == end) {
+                        break;
+                    }
+                }
+
+                size_t length = (size_t)(newline - line);
+
+                const char *timestamp = timestampOf(line, length);
+                if (timestamp != nullptr) {
+                    printing = !query.window ||
+                        (memcmp(timestamp, query.from.data(), kTimestampLength) >= 0 &&
+                         memcmp(timestamp, query.to.data(), kTimestampLength) <= 0);
+                    if (printing && query.levels != 0) {
+                        uint8_t level = levelOf(timestamp, length -
+                                                (size_t)(timestamp - line));
+                        printing = level == 0 || (level & query.levels) != 0;
+                    }
+                }
+
+                if (printing && contains(line, length, query.grep)) {
+                    fwrite(line, 1, newline < end ? length + 1 : length, stdout);
+                    statistics.matches++;
+                }
+
+                if (newline == end) {
+                    line = end;
+                    break;
+                }
+                line = newline + 1;
+            }
+
+            carried = (size_t)(end - line);
+            if (carried > 0 && line != data) {
+                memmove(buffer.data(), line, carried);
+            }
+            if (remaining == 0 && line == end) {
+                carried = 0;
+            }
+        }
+    }
+}
+
+int main (int argc, const char **argv)
+{
+    Query query;
+    const char *path = nullptr;
+    bool useIndex = true;
+    bool printStatistics = false;
+    bool valid = true;
+
+    query.from = "0000-01-01T00:00:00.000000";
+    query.to = "9999-12-31T23:59:59.999999";
+
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (argument == "--from" && hasValue) {
+            valid = valid && completeTime(argv[++i], "0000-01-01T00:00:00.000000",
+                                          query.from);
+            query.window = true;
+        } else if (argument == "--to" && hasValue) {
+            valid = valid && completeTime(argv[++i], "9999-12-31T23:59:59.999999",
+                                          query.to);
+            query.window = true;
+        } else if (argument == "--level" && hasValue) {
+            std::string level = argv[++i];
+            if (level == "info") {
+                query.levels |= rgp::LogIndexLevelInfo;
+            } else if (level == "verbose") {
+                query.levels |= rgp::LogIndexLevelVerbose;
+            } else if (level == "error") {
+                query.levels |= rgp::LogIndexLevelError;
+            } else {
+                valid = false;
+            }
+        } else if (argument == "--grep" && hasValue) {
+            query.grep = argv[++i];
+        } else if (argument == "--no-index") {
+            useIndex = false;
+        } else if (argument == "--stats") {
+            printStatistics = true;
+        } else if (path == nullptr && argument.compare(0, 2, "--") != 0) {
+            path = argv[i];
+        } else {
+            valid = false;
+        }
+    }
+
+    if (!valid || path == nullptr) {
+        std::cerr << "usage: " << argv[0] << " [--from <time>] [--to <time>]"
+                  << " [--level info|verbose|error] [--grep <text>]"
+                  << " [--no-index] [--stats] <logfile>" << std::endl
+                  << "       times like 2026-10-18T09:15:02.123456 (local time,"
+                  << " any precision from the day on)" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        std::cerr << "unable to open " << path << std::endl;
+        return EXIT_FAILURE;
+    }
+    uint64_t fileSize = (uint64_t)file.tellg();
+
+    std::vector<rgp::LogIndexEntry> entries;
+    if (useIndex && !rgp::LogIndex::read(path, entries)) {
+        std::cerr << "no index for " << path << ", scanning the whole file"
+                  << std::endl;
+    }
+
+    Statistics statistics;
+    std::vector<Range> ranges = candidates(entries, fileSize, query,
+                                           epochOf(query.from),
+                                           epochOf(query.to), statistics);
+
+    static char output[1024 * 1024];
+    setvbuf(stdout, output, _IOFBF, sizeof(output));
+
+    std::vector<char> buffer(kChunkSize);
+    for (size_t i = 0; i < ranges.size(); i++) {
+        scan(file, ranges[i], query, buffer, statistics);
+    }
+    fflush(stdout);
+
+    if (printStatistics) {
+        double milliseconds = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        fprintf(stderr, "%llu of %llu indexed blocks, %llu of %llu bytes "
+                "scanned, %llu lines in %.1f ms\n",
+                (unsigned long long)statistics.candidates,
+                (unsigned long long)statistics.blocks,
+                (unsigned long long)statistics.scanned,
+                (unsigned long long)fileSize,
+                (unsigned long long)statistics.matches, milliseconds);
+    }
+
+    return EXIT_SUCCESS;
+}